@@ -10,6 +10,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2009-01-05     Bernard      first implementation
+ * 2026-10-17     kontais      count an early tickless wake from the tick boundaries
  */
 
 #include <board.h>
@@ -46,11 +47,82 @@ void SysTick_Handler(void)
 {
     os_isr_enter();
 
+#ifdef OS_CFG_TICKLESS
+    /* back to the periodic reload after a tickless sleep */
+    SysTick->LOAD = SystemCoreClock / OS_TICKS_PER_SEC - 1;
+#endif
+
     os_tick_increase();
 
     os_isr_leave();
 }
 
+#ifdef OS_CFG_TICKLESS
+/**
+ * This function will stop the periodic SysTick and program a one-shot
+ * reload covering the requested ticks, then sleep until any interrupt.
+ *
+ * @param tick the ticks to sleep at most
+ *
+ * @return the whole ticks passed, not counting a pending SysTick
+ */
+os_tick_t os_arch_tickless_sleep(os_tick_t tick)
+{
+    uint32_t period;
+    uint32_t remain;
+    uint32_t ctrl;
+    os_tick_t elapsed;
+
+    period = SystemCoreClock / OS_TICKS_PER_SEC;
+
+    /* the 24bit reload limits the sleep length */
+    if (tick > SysTick_LOAD_RELOAD_Msk / period)
+        tick = SysTick_LOAD_RELOAD_Msk / period;
+
+    /* keep the part of the current tick which is not passed yet */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = SysTick->VAL + (tick - 1) * period;
+    SysTick->VAL  = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    /* reading CTRL clears COUNTFLAG */
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+    remain = SysTick->VAL;
+    if ((ctrl & SysTick_CTRL_COUNTFLAG_Msk) || remain == 0) {
+        /* slept to the end, the pending SysTick accounts for the last tick */
+        elapsed = tick - 1;
+        SysTick->LOAD = period - 1;
+    } else {
+        /*
+         * woken by another interrupt, count from the tick boundaries. The
+         * sleep started with VAL0 counts left of the current tick, so the
+         * boundaries are VAL0 + (k - 1) * period counts after the start, at
+         * VAL = (tick - k) * period, k = 1 .. tick. With remain counts left,
+         * remain = q * period + r and 0 < r <= period, the boundaries at
+         * VAL = (tick - 1) * period down to (q + 1) * period are passed:
+         *
+         *   elapsed = tick - 1 - q = tick - 1 - (remain - 1) / period
+         *
+         * and the next one comes after r counts, a reload of r - 1. Counting
+         * from the start of sleep instead drops up to a tick on each wake.
+         */
+        elapsed = tick - 1 - (remain - 1) / period;
+        SysTick->LOAD = (remain - 1) % period;
+    }
+
+    SysTick->VAL  = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    return elapsed;
+}
+#endif
+
 /**
  * This function will initial STM32 board.
  */
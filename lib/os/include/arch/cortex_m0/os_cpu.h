@@ -23,6 +23,7 @@
  * 2006-04-25     Bernard      add os_arch_context_switch_interrupt declaration
  * 2006-09-24     Bernard      add os_arch_context_switch_to declaration
  * 2012-12-29     Bernard      add os_arch_exception_install declaration
+ * 2026-10-17     kontais      add cycle counter interfaces
  */
 
 #ifndef __OS_CPU_H__
@@ -58,6 +59,12 @@ void os_arch_context_switch_interrupt(uint32_t from, uint32_t to);
  */
 void os_arch_exception_install(os_err_t (*exception_handle)(void *context));
 
+/*
+ * Cycle counter interfaces (Optional), the counter runs freely and wraps
+ */
+void os_arch_cycle_init(void);
+uint32_t os_arch_cycle_get(void);
+
 #ifdef __cplusplus
 }
 #endif
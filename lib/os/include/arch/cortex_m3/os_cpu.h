@@ -23,6 +23,9 @@
  * 2006-04-25     Bernard      add os_arch_context_switch_interrupt declaration
  * 2006-09-24     Bernard      add os_arch_context_switch_to declaration
  * 2012-12-29     Bernard      add os_arch_exception_install declaration
+ * 2026-10-17     kontais      add exclusive access interfaces
+ * 2026-10-17     kontais      add cycle counter interfaces
+ * 2026-10-17     kontais      add stack guard interfaces
  */
 
 #ifndef __OS_CPU_H__
@@ -58,6 +61,59 @@ void os_arch_context_switch_interrupt(uint32_t from, uint32_t to);
  */
 void os_arch_exception_install(os_err_t (*exception_handle)(void *context));
 
+/*
+ * Cycle counter interfaces (Optional), the counter runs freely and wraps
+ */
+void os_arch_cycle_init(void);
+uint32_t os_arch_cycle_get(void);
+
+/*
+ * Stack guard interfaces (Optional), the lowest aligned block of the running
+ * task stack is not accessible
+ */
+#define OS_ARCH_STACK_GUARD_SIZE        32
+
+void os_arch_stack_guard_init(void *stack_addr);
+
+/*
+ * Exclusive access interfaces, strex returns 0 on success
+ */
+#define OS_ARCH_EXCLUSIVE
+
+#if defined (__CC_ARM)
+#define os_arch_ldrex(addr)             __ldrex(addr)
+#define os_arch_strex(value, addr)      __strex(value, addr)
+#define os_arch_clrex()                 __clrex()
+#elif defined (__ICCARM__)
+#include <intrinsics.h>
+#define os_arch_ldrex(addr)             __LDREX((unsigned long *)(addr))
+#define os_arch_strex(value, addr)      __STREX(value, (unsigned long *)(addr))
+#define os_arch_clrex()                 __CLREX()
+#elif defined (__GNUC__)
+STATIC_INLINE uint32_t os_arch_ldrex(volatile uint32_t *addr)
+{
+    uint32_t value;
+
+    __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (addr) : "memory");
+
+    return value;
+}
+
+STATIC_INLINE uint32_t os_arch_strex(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t result;
+
+    __asm volatile ("strex %0, %2, [%1]" : "=&r" (result) : "r" (addr), "r" (value) : "memory");
+
+    return result;
+}
+
+STATIC_INLINE void os_arch_clrex(void)
+{
+    __asm volatile ("clrex" ::: "memory");
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
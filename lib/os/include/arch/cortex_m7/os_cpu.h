@@ -0,0 +1,150 @@
+/*
+ * File      : os_cpu.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2006-03-18     Bernard      the first version
+ * 2006-04-25     Bernard      add os_arch_context_switch_interrupt declaration
+ * 2006-09-24     Bernard      add os_arch_context_switch_to declaration
+ * 2012-12-29     Bernard      add os_arch_exception_install declaration
+ * 2026-10-17     kontais      add exclusive access interfaces
+ * 2026-10-17     kontais      add cycle counter interfaces
+ * 2026-10-17     kontais      add stack guard interfaces
+ * 2026-10-17     kontais      add fpu ownership interfaces
+ * 2026-10-17     kontais      add memory barrier interface
+ * 2026-10-17     kontais      port to cortex-m7 with exclusive access
+ */
+
+#ifndef __OS_CPU_H__
+#define __OS_CPU_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef uint32_t    os_sr_t;    /* CPU status register */
+
+/*
+ * Context switch interfaces
+ */
+os_sr_t os_enter_critical(void);
+void os_exit_critical(os_sr_t sr);
+
+uint8_t *os_arch_task_stack_init(void       *entry,
+                             void       *parameter,
+                             uint8_t *stack_addr,
+                             void       *exit);
+
+/*
+ * Context switch interfaces
+ */
+void os_arch_context_switch(uint32_t from, uint32_t to);
+void os_arch_context_switch_to(uint32_t to);
+void os_arch_context_switch_interrupt(uint32_t from, uint32_t to);
+
+/*
+ * Exception interfaces (Optional)
+ */
+void os_arch_exception_install(os_err_t (*exception_handle)(void *context));
+
+/*
+ * Cycle counter interfaces (Optional), the counter runs freely and wraps
+ */
+void os_arch_cycle_init(void);
+uint32_t os_arch_cycle_get(void);
+
+/*
+ * Stack guard interfaces (Optional), the lowest aligned block of the running
+ * task stack is not accessible
+ */
+#define OS_ARCH_STACK_GUARD_SIZE        32
+
+void os_arch_stack_guard_init(void *stack_addr);
+
+/*
+ * FPU ownership interfaces (Optional), s0 ~ s31 and fpscr of a FPU task
+ */
+#define OS_ARCH_FPU_CONTEXT_WORDS       33
+
+struct os_task;
+void os_arch_fpu_init(void);
+void os_arch_fpu_switch(struct os_task *task);
+void os_arch_fpu_release(struct os_task *task);
+
+/*
+ * Memory barrier interface, the write buffer and cache let another bus
+ * master see stores out of order
+ */
+#define OS_ARCH_MB
+
+#if defined (__CC_ARM)
+#define os_arch_mb()                    __dmb(0xF)
+#elif defined (__ICCARM__)
+#include <intrinsics.h>
+#define os_arch_mb()                    __DMB()
+#elif defined (__GNUC__)
+#define os_arch_mb()                    __asm volatile ("dmb" ::: "memory")
+#endif
+
+/*
+ * Exclusive access interfaces, strex returns 0 on success. The local monitor
+ * is cleared on exception entry and return, so a preempted sequence retries.
+ */
+#define OS_ARCH_EXCLUSIVE
+
+#if defined (__CC_ARM)
+#define os_arch_ldrex(addr)             __ldrex(addr)
+#define os_arch_strex(value, addr)      __strex(value, addr)
+#define os_arch_clrex()                 __clrex()
+#elif defined (__ICCARM__)
+#include <intrinsics.h>
+#define os_arch_ldrex(addr)             __LDREX((unsigned long *)(addr))
+#define os_arch_strex(value, addr)      __STREX(value, (unsigned long *)(addr))
+#define os_arch_clrex()                 __CLREX()
+#elif defined (__GNUC__)
+STATIC_INLINE uint32_t os_arch_ldrex(volatile uint32_t *addr)
+{
+    uint32_t value;
+
+    __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (addr) : "memory");
+
+    return value;
+}
+
+STATIC_INLINE uint32_t os_arch_strex(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t result;
+
+    __asm volatile ("strex %0, %2, [%1]" : "=&r" (result) : "r" (addr), "r" (value) : "memory");
+
+    return result;
+}
+
+STATIC_INLINE void os_arch_clrex(void)
+{
+    __asm volatile ("clrex" ::: "memory");
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __OS_CPU_H__ */
@@ -0,0 +1,136 @@
+/*
+ * File      : os_cpu.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      add virtual time and scripted interrupts
+ * 2026-10-17     kontais      add exclusive access
+ * 2026-10-17     kontais      add busy ticks of virtual time
+ * 2026-10-17     kontais      add stack guard check
+ * 2026-10-17     kontais      add fpu ownership in software
+ */
+
+#ifndef __OS_CPU_H__
+#define __OS_CPU_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The POSIX simulator. Kernel passes addresses as uint32_t, so the host
+ * build shall keep kernel objects below 4G, -m32 or -no-pie.
+ */
+
+typedef uint32_t    os_sr_t;    /* interrupt disabled flag */
+
+/*
+ * Context switch interfaces
+ */
+os_sr_t os_enter_critical(void);
+void os_exit_critical(os_sr_t sr);
+
+uint8_t *os_arch_task_stack_init(void       *entry,
+                             void       *parameter,
+                             uint8_t *stack_addr,
+                             void       *exit);
+
+/*
+ * Context switch interfaces
+ */
+void os_arch_context_switch(uint32_t from, uint32_t to);
+void os_arch_context_switch_to(uint32_t to);
+void os_arch_context_switch_interrupt(uint32_t from, uint32_t to);
+
+/*
+ * Cycle counter interfaces (Optional), nanoseconds of host clock
+ */
+void os_arch_cycle_init(void);
+uint32_t os_arch_cycle_get(void);
+
+/*
+ * Exclusive access interfaces, strex returns 0 on success. As on a processor
+ * an interrupt or a switch clears the monitor.
+ */
+#define OS_ARCH_EXCLUSIVE
+
+uint32_t os_arch_ldrex(volatile uint32_t *addr);
+uint32_t os_arch_strex(uint32_t value, volatile uint32_t *addr);
+void os_arch_clrex(void);
+
+/*
+ * Stack guard interfaces (Optional). There is no MPU on host and a task does
+ * not run on its own stack, the guard of the running task is the lowest
+ * aligned block of its stack as on cortex-m, a switch checks the block still
+ * holds the fill of os_task_init before it moves the guard. A run with a
+ * guard hit exits with OS_ARCH_SIM_EXIT_GUARD.
+ */
+#define OS_ARCH_STACK_GUARD_SIZE        32
+#define OS_ARCH_SIM_EXIT_GUARD          4
+
+extern uint32_t os_arch_stack_guard;   /* guard of the running task, or 0 */
+
+void os_arch_stack_guard_init(void *stack_addr);
+
+/*
+ * FPU ownership interfaces (Optional). The host FPU is not handed over, a
+ * register file of as many words as s0 ~ s31 and fpscr is saved and loaded
+ * in its place as on cortex-m4, so that the cost of ownership shows.
+ */
+#define OS_ARCH_FPU_CONTEXT_WORDS       33
+
+struct os_task;
+void os_arch_fpu_init(void);
+void os_arch_fpu_switch(struct os_task *task);
+void os_arch_fpu_release(struct os_task *task);
+
+/*
+ * Simulated interrupt interfaces, OS_CFG_SIM_UCONTEXT. An interrupt raised
+ * is pending until interrupt is enabled, then its handler runs between
+ * os_isr_enter and os_isr_leave. Raise is safe in a signal handler, a host
+ * signal bound to an interrupt raises it.
+ */
+#define OS_ARCH_SIM_IRQ_MAX             32
+#define OS_ARCH_SIM_IRQ_TICK            0       /* system tick */
+
+void os_arch_sim_irq_install(uint32_t irq, void (*handler)(void));
+void os_arch_sim_irq_raise(uint32_t irq);
+void os_arch_sim_irq_signal(int sig, uint32_t irq);
+
+/*
+ * Deterministic run, OS_CFG_SIM_VIRTUAL_TIME. Interrupts are scripted in
+ * ticks of virtual time, their jitter comes from the seeded random numbers.
+ * A run with all tasks blocked forever exits with OS_ARCH_SIM_EXIT_BLOCKED.
+ */
+#define OS_ARCH_SIM_EXIT_BLOCKED        3
+
+void os_arch_sim_seed(uint32_t seed);
+uint32_t os_arch_sim_random(void);
+os_err_t os_arch_sim_irq_schedule(uint32_t  irq,
+                                  os_tick_t tick,
+                                  os_tick_t period,
+                                  os_tick_t jitter);
+void os_arch_sim_busy(os_tick_t tick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __OS_CPU_H__ */
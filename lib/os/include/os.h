@@ -25,6 +25,8 @@
  * 2007-01-28     Bernard      rename OS_OBJECT_Class_Static to RT_Object_Class_Static
  * 2007-03-03     Bernard      clean up the definitions to os_def.h
  * 2010-04-11     yi.qiu       add module feature
+ * 2026-10-17     kontais      add trace recorder
+ * 2026-10-17     kontais      add symmetric multi processing
  */
 
 #ifndef _OS_H_
@@ -45,6 +47,8 @@
 #include <os_version.h>
 
 #include <os_cpu.h>
+#include <os_smp.h>
+#include <os_trace.h>
 
 #include <os_irq.h>
 #include <os_tick.h>
@@ -53,19 +57,29 @@
 #include <os_idle.h>
 #include <os_sched.h>
 
+#ifdef OS_CFG_SCHED_EDF
+#include <os_edf.h>
+#endif
+
+#ifdef OS_CFG_TIMER_SOFT
+#include <os_timer_task.h>
+#endif
+
 /* os components */
 #ifdef OS_CFG_HEAP
 #include <os_heap.h>
 #endif
 
+#include <os_ipc.h>
+
 #include <os_mpool.h>
 #include <os_sem.h>
 #include <os_mutex.h>
+#include <os_pcmutex.h>
 #include <os_event.h>
 #include <os_mbox.h>
 #include <os_mqueue.h>
-
-#include <os_ipc.h>
+#include <os_ringbuf.h>
 
 void os_init(void);
 void os_start(void);
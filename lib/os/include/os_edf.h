@@ -0,0 +1,50 @@
+/*
+ * File      : os_edf.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+#ifndef _OS_EDF_H_
+#define _OS_EDF_H_
+
+/*
+ * the priority level reserved for earliest deadline first tasks, they are
+ * ordered by absolute deadline inside this level
+ */
+#ifndef OS_SCHED_EDF_PRIO
+#define OS_SCHED_EDF_PRIO             8
+#endif
+
+/*
+ * earliest deadline first kernel service
+ * note: invoked by clock ISR to charge the budget of current task.
+ */
+void os_edf_tick(void);
+
+/*
+ * earliest deadline first user service
+ */
+os_err_t os_task_edf_set(os_task_t *task,
+                         os_tick_t  period,
+                         os_tick_t  deadline,
+                         os_tick_t  budget);
+os_err_t os_task_edf_wait(void);
+
+#endif /* _OS_EDF_H_ */
@@ -37,7 +37,7 @@
 struct os_event
 {
     uint8_t flag;                                    /* flag of kernel object */
-    os_list_t        pending_list;                    /* tasks pended on this resource */
+    os_waitq_t       pending_list;                    /* tasks pended on this resource */
 
     uint32_t          set;                           /* event set */
 };
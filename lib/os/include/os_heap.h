@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add os_heap_add_region for TLSF heap
  */
 #ifndef _OS_MEM_H_
 #define _OS_MEM_H_
@@ -28,6 +29,9 @@
  * heap memory system service
  */
 void os_heap_init(void *begin_addr, void *end_addr);
+#ifdef OS_CFG_HEAP_TLSF
+void os_heap_add_region(void *begin_addr, void *end_addr);
+#endif
 
 /*
  * heap memory user service
@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add cpu load, OS_CFG_TASK_STATS
  */
 #ifndef _OS_IDLE_H_
 #define _OS_IDLE_H_
@@ -29,4 +30,21 @@
  */
 void os_init_idle_task(void);
 
+#ifdef OS_CFG_TASK_STATS
+/*
+ * idle task user service
+ */
+uint32_t os_cpu_load_get(void);
+#endif
+
+#ifdef OS_CFG_TICKLESS
+/*
+ * tickless idle board service
+ * note: stop the periodic tick, sleep at most tick ticks or until any
+ *       interrupt, then restart the tick and return the whole ticks passed.
+ *       Invoked by the idle task with interrupt disabled.
+ */
+os_tick_t os_arch_tickless_sleep(os_tick_t tick);
+#endif
+
 #endif /* _OS_IDLE_H_ */
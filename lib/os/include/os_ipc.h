@@ -20,6 +20,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      priority bucketed wait queue, os_waitq
+ * 2026-10-17     kontais      a bucket for every priority, two level bitmap
+ * 2026-10-17     kontais      the default bucketed wait queue is not O(1)
  */
 #ifndef _OS_IPC_H_
 #define _OS_IPC_H_
@@ -27,48 +30,73 @@
 #define OS_IPC_FIFO                 0x00            /* FIFOed IPC. @ref IPC. */
 #define OS_IPC_PRIO                 0x01            /* PRIOed IPC. @ref IPC. */
 
-/**
- * @addtogroup IPC
+/*
+ * the number of priority buckets in a wait queue, power of two, no more than
+ * OS_TASK_PRIORITY_MAX. With a bucket for every priority a waiter is queued
+ * in O(1), with fewer it is put in priority order among the waiters of its
+ * bucket, a walk back over the waiters of lower priority in it. Each
+ * bucket takes a list head in every IPC object, so the default keeps 8 and
+ * is not O(1), a program that needs it sets OS_TASK_PRIORITY_MAX.
  */
+#ifndef OS_IPC_WAITQ_LEVELS
+#define OS_IPC_WAITQ_LEVELS         8
+#endif
 
-/*@{*/
-
-/*@{*/
+#define OS_IPC_WAITQ_WORDS          ((OS_IPC_WAITQ_LEVELS + 31) / 32)
 
 /**
- * This function will suspend a task to a specified list. IPC object or some
- * double-queue object (mailbox etc.) contains this kind of list.
+ * wait queue structure
  *
- * @param list the IPC suspended task list
- * @param task the task object to be suspended
- * @param flag the IPC object flag,
- *        which shall be OS_IPC_FIFO/OS_IPC_PRIO.
- *
- * @return the operation status, OS_OK on successful
+ * Like the ready queue of scheduler, a bitmap marks the buckets with waiters,
+ * so the first task is found without a walk, and a group marks the words of
+ * bitmap in use beyond 32 buckets. A FIFOed IPC object only uses the first
+ * bucket. The bit of a bucket emptied by timeout is cleared lazily.
  */
-os_err_t os_list_suspend(os_list_t        *list,
-                                       os_task_t *task,
-                                       uint8_t        flag);
+struct os_waitq
+{
+#if OS_IPC_WAITQ_WORDS > 1
+    uint32_t            group;                      /* words of bitmap in use */
+#endif
+    uint32_t            bitmap[OS_IPC_WAITQ_WORDS]; /* buckets may have waiters */
+    os_list_t           level[OS_IPC_WAITQ_LEVELS]; /* tasks of each bucket */
+};
+typedef struct os_waitq os_waitq_t;
+
+/* a task may wait, the bitmap is cleared lazily */
+#if OS_IPC_WAITQ_WORDS > 1
+#define os_waitq_pending(wq)        ((wq)->group != 0)
+#else
+#define os_waitq_pending(wq)        ((wq)->bitmap[0] != 0)
+#endif
 
 /**
- * This function will resume the first task in the list of a IPC object:
- * - remove the task from suspend queue of IPC object
- * - put the task into system ready queue
- *
- * @param list the task list
- *
- * @return the operation status, OS_OK on successful
+ * @addtogroup IPC
  */
-os_err_t os_list_resume(os_list_t *list);
 
-/**
- * This function will resume all suspended tasks in a list, including
- * suspend list of IPC object and private list of mailbox etc.
- *
- * @param list of the tasks to resume
- *
- * @return the operation status, OS_OK on successful
+/*@{*/
+
+void os_waitq_init(os_waitq_t *wq);
+
+/*
+ * wait queue lookup, irq must be disabled
  */
-os_err_t os_list_resume_all(os_list_t *list);
+os_task_t *os_waitq_first(os_waitq_t *wq);
+os_task_t *os_waitq_next(os_waitq_t *wq, os_task_t *task);
+
+#define os_waitq_isempty(wq)        (os_waitq_first(wq) == NULL)
+
+/*
+ * wait queue interface
+ */
+os_err_t os_waitq_suspend(os_waitq_t       *wq,
+                          os_task_t        *task,
+                          uint8_t           flag);
+os_err_t os_waitq_requeue(os_waitq_t       *wq,
+                          os_task_t        *task,
+                          uint8_t           flag);
+os_err_t os_waitq_resume(os_waitq_t *wq);
+os_err_t os_waitq_resume_all(os_waitq_t *wq);
+
+/*@}*/
 
 #endif /* _OS_IPC_H_ */
@@ -25,9 +25,11 @@
 #define _OS_IRQ_H_
 
 /*
- * interrupt system variable
+ * interrupt system variable, per processor in SMP mode
  */
+#ifndef OS_CFG_SMP
 extern volatile uint8_t os_isr_nest;
+#endif
 
 /*
  * interrupt user service
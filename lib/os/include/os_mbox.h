@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      declare os_mbox_delete
  */
 #ifndef _OS_MAIL_BOX_H_
 #define _OS_MAIL_BOX_H_
@@ -30,7 +31,7 @@
 struct os_mbox
 {
     uint8_t flag;                                    /* flag of kernel object */
-    os_list_t        pending_list;                    /* tasks pended on this resource */
+    os_waitq_t       pending_list;                    /* tasks pended on this resource */
 
     uint32_t         *msg_pool;                      /* start address of message buffer */
 
@@ -40,7 +41,7 @@ struct os_mbox
     uint16_t          in_offset;                     /* input offset of the message buffer */
     uint16_t          out_offset;                    /* output offset of the message buffer */
 
-    os_list_t         sender_pending_list;         /* sender task suspended on this mailbox */
+    os_waitq_t        sender_pending_list;         /* sender task suspended on this mailbox */
 };
 typedef struct os_mbox os_mbox_t;
 
@@ -51,6 +52,7 @@ os_err_t os_mbox_init(os_mbox_t *mb,
                     void        *msgpool,
                     size_t    size,
                     uint8_t   flag);
+os_err_t os_mbox_delete(os_mbox_t *mb);
 
 os_err_t os_mbox_put(os_mbox_t *mb, uint32_t value);
 os_err_t os_mbox_put_wait(os_mbox_t *mb,
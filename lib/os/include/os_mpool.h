@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add interrupt allocation interface
  */
 #ifndef _OS_MPOOL_H_
 #define _OS_MPOOL_H_
@@ -33,12 +34,12 @@ struct os_mpool
     size_t        size;                              /* size of memory pool */
 
     size_t        block_size;                        /* size of memory blocks */
-    uint8_t      *block_list;                        /* memory blocks list */
+    uint8_t * volatile block_list;                   /* memory blocks list */
 
     size_t        block_total_count;                 /* numbers of memory block */
     size_t        block_free_count;                  /* numbers of free memory block */
 
-    os_list_t        pending_list;                    /* tasks pended on this resource */
+    os_waitq_t       pending_list;                    /* tasks pended on this resource */
     size_t        suspend_task_count;              /* numbers of task pended on this resource */
 };
 typedef struct os_mpool os_mpool_t;
@@ -55,4 +56,7 @@ os_err_t os_mpool_delete(os_mpool_t *mp);
 void *os_mpool_alloc(os_mpool_t *mp, os_tick_t timeout);
 void os_mpool_free(void *block);
 
+void *os_mpool_alloc_isr(os_mpool_t *mp);
+void os_mpool_free_isr(void *block);
+
 #endif /* _OS_MPOOL_H_ */
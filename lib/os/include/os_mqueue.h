@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add zero-copy interface
  */
 #ifndef _OS_MESSAGE_QUEUE_H_
 #define _OS_MESSAGE_QUEUE_H_
@@ -30,7 +31,7 @@
 struct os_mqueue
 {
     uint8_t flag;                                    /* flag of kernel object */
-    os_list_t        pending_list;                    /* tasks pended on this resource */
+    os_waitq_t       pending_list;                    /* tasks pended on this resource */
 
     void                *msg_pool;                      /* start address of message queue */
 
@@ -63,4 +64,12 @@ os_err_t os_mqueue_get(os_mqueue_t *mq,
                     os_tick_t timeout);
 os_err_t os_mqueue_reset(os_mqueue_t *mq, void *arg);
 
+/*
+ * zero-copy message queue interface
+ */
+os_err_t os_mqueue_reserve(os_mqueue_t *mq, void **buffer);
+os_err_t os_mqueue_commit(os_mqueue_t *mq, void *buffer);
+os_err_t os_mqueue_recv_borrow(os_mqueue_t *mq, void **buffer, os_tick_t timeout);
+os_err_t os_mqueue_release(os_mqueue_t *mq, void *buffer);
+
 #endif /* _OS_MESSAGE_QUEUE_H_ */
@@ -20,6 +20,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add transitive priority inheritance
+ * 2026-10-17     kontais      the owner is the state of mutex, no value
  */
 #ifndef _OS_MUTEX_H_
 #define _OS_MUTEX_H_
@@ -30,14 +32,13 @@
 struct os_mutex
 {
     uint8_t flag;                                    /* flag of kernel object */
-    os_list_t        pending_list;                    /* tasks pended on this resource */
+    os_waitq_t       pending_list;                    /* tasks pended on this resource */
 
-    uint16_t          value;                         /* value of mutex */
-
-    uint8_t           original_priority;             /* priority of last task hold the mutex */
+    uint8_t           priority;                      /* highest priority of pending tasks */
     uint8_t           hold;                          /* numbers of task hold the mutex */
 
     os_task_t    *owner;                         /* current owner of mutex */
+    os_list_t         list;                          /* node of mutex list of owner */
 };
 typedef struct os_mutex os_mutex_t;
 
@@ -50,4 +51,16 @@ os_err_t os_mutex_delete(os_mutex_t *mutex);
 os_err_t os_mutex_take(os_mutex_t *mutex, os_tick_t timeout);
 os_err_t os_mutex_release(os_mutex_t *mutex);
 
+/*
+ * mutex kernel service
+ * note: the pending task timed out, give back the priority it lent.
+ */
+void os_mutex_pend_abort(os_task_t *task);
+
+/*
+ * mutex kernel service
+ * note: the own priority of task changed, recompute the inherited one.
+ */
+void os_mutex_priority_update(os_task_t *task);
+
 #endif /* _OS_MUTEX_H_ */
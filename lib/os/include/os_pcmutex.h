@@ -0,0 +1,53 @@
+/*
+ * File      : os_pcmutex.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      save the ceiling of owner, not its own priority
+ */
+#ifndef _OS_PCMUTEX_H_
+#define _OS_PCMUTEX_H_
+
+/**
+ * Priority ceiling mutex structure
+ *
+ * The owner runs at ceiling priority while it holds the mutex, so no other
+ * task which locks the mutex can run, it never blocks on a single core.
+ */
+struct os_pcmutex
+{
+    uint8_t           ceiling;                       /* ceiling priority of mutex */
+    uint8_t           saved_priority;                /* ceiling of owner before lock */
+    uint8_t           hold;                          /* numbers of owner hold the mutex */
+
+    os_task_t        *owner;                         /* current owner of mutex */
+};
+typedef struct os_pcmutex os_pcmutex_t;
+
+/*
+ * priority ceiling mutex interface
+ */
+os_err_t os_pcmutex_init(os_pcmutex_t *mutex, uint8_t ceiling);
+os_err_t os_pcmutex_delete(os_pcmutex_t *mutex);
+
+os_err_t os_pcmutex_lock(os_pcmutex_t *mutex);
+os_err_t os_pcmutex_unlock(os_pcmutex_t *mutex);
+
+#endif /* _OS_PCMUTEX_H_ */
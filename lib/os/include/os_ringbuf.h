@@ -0,0 +1,69 @@
+/*
+ * File      : os_ringbuf.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+#ifndef _OS_RINGBUF_H_
+#define _OS_RINGBUF_H_
+
+/**
+ * ring buffer structure
+ *
+ * Single producer, single consumer. The producer only writes head and the
+ * consumer only writes tail, so neither side needs a critical section to
+ * move data. Both indexes run freely and are masked on access.
+ */
+struct os_ringbuf
+{
+    uint8_t            *buffer;                     /* start address of ring buffer */
+    uint32_t            mask;                       /* size - 1, size is power of two */
+
+    volatile uint32_t   head;                       /* write index, owned by producer */
+    volatile uint32_t   tail;                       /* read index, owned by consumer */
+
+    os_task_t * volatile reader;                    /* consumer task waiting for data */
+};
+typedef struct os_ringbuf os_ringbuf_t;
+
+/*
+ * ring buffer interface
+ */
+os_err_t os_ringbuf_init(os_ringbuf_t *rb, void *pool, uint32_t size);
+os_err_t os_ringbuf_delete(os_ringbuf_t *rb);
+
+uint32_t os_ringbuf_len(os_ringbuf_t *rb);
+uint32_t os_ringbuf_space(os_ringbuf_t *rb);
+
+/* producer side, can be invoked in interrupt service routine */
+os_err_t os_ringbuf_putc(os_ringbuf_t *rb, uint8_t ch);
+uint32_t os_ringbuf_write(os_ringbuf_t *rb, const void *buffer, uint32_t size);
+uint32_t os_ringbuf_reserve(os_ringbuf_t *rb, uint8_t **ptr);
+void     os_ringbuf_commit(os_ringbuf_t *rb, uint32_t size);
+
+/* consumer side */
+uint32_t os_ringbuf_read(os_ringbuf_t *rb,
+                         void      *buffer,
+                         uint32_t   size,
+                         os_tick_t  timeout);
+uint32_t os_ringbuf_peek(os_ringbuf_t *rb, uint8_t **ptr);
+void     os_ringbuf_release(os_ringbuf_t *rb, uint32_t size);
+
+#endif /* _OS_RINGBUF_H_ */
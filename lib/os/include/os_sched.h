@@ -20,6 +20,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add cpu usage accounting
+ * 2026-10-17     kontais      add symmetric multi processing
  */
 #ifndef _OS_SCHEDULER_H_
 #define _OS_SCHEDULER_H_
@@ -31,6 +33,13 @@ void os_sched_init(void);
 void os_sched_start(void);
 void os_sched_insert(os_task_t *task);
 void os_sched_remove(os_task_t *task);
+#ifdef OS_CFG_SMP
+os_task_t *os_sched_pick(uint32_t cpu);
+#endif
+#ifdef OS_CFG_TASK_STATS
+void os_sched_account(void);
+uint64_t os_sched_cycles_get(void);
+#endif
 
 /*
  * schedule user service
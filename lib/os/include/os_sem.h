@@ -30,7 +30,7 @@
 struct os_sem
 {
     uint8_t   flag;           /* flag of kernel object */
-    os_list_t pending_list;   /* tasks pended on this resource */
+    os_waitq_t pending_list;   /* tasks pended on this resource */
 
     uint32_t  value;          /* value of semaphore. */
 };
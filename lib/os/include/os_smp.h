@@ -0,0 +1,102 @@
+/*
+ * File      : os_smp.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      add os_arch_mb
+ */
+#ifndef _OS_SMP_H_
+#define _OS_SMP_H_
+
+#ifdef OS_CFG_SMP
+
+#ifndef OS_CPUS_NR
+#define OS_CPUS_NR                    2
+#endif
+
+#if defined(OS_CFG_TASK_STATS) || defined(OS_CFG_TICKLESS)
+#error "OS_CFG_TASK_STATS and OS_CFG_TICKLESS support one processor only"
+#endif
+
+#define OS_CPU_NONE                   0xFF                /* task runs on no processor */
+#define OS_CPU_MASK_ALL               ((1UL << OS_CPUS_NR) - 1)
+
+typedef volatile uint32_t os_spinlock_t;
+
+struct os_task;
+
+/*
+ * processor structure, the per processor state of kernel
+ */
+struct os_cpu
+{
+    struct os_task  *current_task;              /* task running on the processor */
+    volatile uint8_t isr_nest;                  /* interrupt nest */
+    volatile uint8_t need_sched;                /* schedule at interrupt exit */
+    int16_t          sched_lock_nest;           /* scheduler lock nest */
+};
+typedef struct os_cpu os_cpu_t;
+
+extern os_cpu_t os_cpus[OS_CPUS_NR];
+
+/*
+ * the processor running the caller, it only stays the same with interrupt
+ * disabled, so do the per processor variables below
+ */
+#define os_cpu_self()                 (&os_cpus[os_arch_cpu_id()])
+#define os_current_task               (os_cpu_self()->current_task)
+#define os_isr_nest                   (os_cpu_self()->isr_nest)
+
+/*
+ * processor interfaces, provided by arch in SMP mode. The critical section
+ * of kernel is built on them, it takes the kernel lock besides disabling
+ * interrupt.
+ */
+uint32_t os_arch_cpu_id(void);
+os_sr_t os_arch_irq_save(void);
+void os_arch_irq_restore(os_sr_t sr);
+void os_arch_spin_lock(os_spinlock_t *lock);
+void os_arch_spin_unlock(os_spinlock_t *lock);
+void os_arch_ipi_send(uint32_t cpu_mask);
+void os_arch_secondary_cpu_up(void);
+
+/*
+ * memory barrier, the other processor sees the accesses before it first
+ */
+#define OS_ARCH_MB
+
+void os_arch_mb(void);
+
+/*
+ * SMP kernel service
+ */
+uint32_t os_smp_lock_nest_get(void);
+void os_smp_lock_nest_set(uint32_t nest);
+void os_smp_task_entry(void *parameter);
+
+/*
+ * SMP arch service
+ * note: invoked by a secondary processor once it has a stack.
+ */
+void os_smp_secondary_entry(void);
+
+#endif
+
+#endif /* _OS_SMP_H_ */
@@ -20,6 +20,19 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add task notification, OS_CFG_TASK_NOTIFY
+ * 2026-10-17     kontais      add cpu usage accounting, OS_CFG_TASK_STATS
+ * 2026-10-17     kontais      add task registry and snapshot
+ * 2026-10-17     kontais      add earliest deadline first, OS_CFG_SCHED_EDF
+ * 2026-10-17     kontais      add transitive priority inheritance
+ * 2026-10-17     kontais      add stack high water mark, OS_CFG_TASK_STACK_HWM
+ * 2026-10-17     kontais      add fpu ownership, OS_CFG_TASK_FPU
+ * 2026-10-17     kontais      add processor affinity, OS_CFG_SMP
+ * 2026-10-17     kontais      add os_task_sleep_until
+ * 2026-10-17     kontais      add os_task_priority_inherit
+ * 2026-10-17     kontais      remember the wait queue a task is in
+ * 2026-10-17     kontais      add os_task_registry_lock
+ * 2026-10-17     kontais      keep the ceiling of priority ceiling mutexes apart
  */
 #ifndef _OS_TASK_H_
 #define _OS_TASK_H_
@@ -52,6 +65,44 @@
 #define OS_TASK_CTRL_CHANGE_PRIORITY  0x02                /* Change task priority. */
 #define OS_TASK_CTRL_INFO             0x03                /* Get task information. */
 
+#ifdef OS_CFG_TASK_NOTIFY
+/**
+ * task notification action definitions
+ */
+#define OS_TASK_NOTIFY_NONE           0x00                /* Only wake up the task. */
+#define OS_TASK_NOTIFY_SET_BITS       0x01                /* Or value into notification. */
+#define OS_TASK_NOTIFY_INCREMENT      0x02                /* Increase notification. */
+#define OS_TASK_NOTIFY_OVERWRITE      0x03                /* Overwrite notification. */
+#define OS_TASK_NOTIFY_NO_OVERWRITE   0x04                /* Write if none is pending. */
+
+/**
+ * task notification state definitions
+ */
+#define OS_TASK_NOTIFY_IDLE           0x00                /* No notification. */
+#define OS_TASK_NOTIFY_PENDING        0x01                /* Notification not taken yet. */
+#define OS_TASK_NOTIFY_WAITING        0x02                /* Task waits for notification. */
+#endif
+
+/**
+ * task flag definitions
+ */
+#define OS_TASK_FLAG_YIELD            0x01                /* Task gives up processor itself. */
+#define OS_TASK_FLAG_FPU              0x02                /* Task owns a FPU context. */
+
+#ifdef OS_CFG_TASK_STATS
+/**
+ * task runtime statistics structure
+ */
+struct os_task_stats
+{
+    uint64_t run_cycles;                        /* cycles consumed by the task */
+    uint32_t run_switches;                      /* times switched in */
+    uint32_t run_preempts;                      /* times switched out while ready */
+    uint32_t run_yields;                        /* times gave up processor itself */
+};
+typedef struct os_task_stats os_task_stats_t;
+#endif
+
 /**
  * Thread structure
  */
@@ -63,13 +114,18 @@ struct os_task
     uint8_t  flags;                             /* task's flags */
 
     os_list_t   tlist;                          /* the task list */
+    os_list_t   rlist;                          /* the task registry list */
 
-    /* stack point and entry */
+    /* stack point and entry, cortex-m stack guard finds stack_addr at sp + 12 */
     void       *sp;                             /* stack point */
     void       *entry;                          /* entry */
     void       *parameter;                      /* parameter */
     void       *stack_addr;                     /* stack address */
     uint32_t   stack_size;                      /* stack size */
+#ifdef OS_CFG_TASK_STACK_HWM
+    uint32_t   stack_free;                      /* bytes never touched at stack bottom */
+    uint32_t   stack_scan;                      /* word the next scan starts at */
+#endif
 
     /* error code */
     os_err_t error;                             /* error code */
@@ -78,15 +134,58 @@ struct os_task
 
     /* priority */
     uint8_t  current_priority;                  /* current priority */
+    uint8_t  init_priority;                     /* priority without inheritance */
+    uint8_t  ceiling_priority;                  /* ceiling of pcmutexes held, 0xFF none */
 #if OS_TASK_PRIORITY_MAX > 32
     uint8_t  priority_group;
 #endif
     uint32_t priority_mask;
 
+    /* priority inheritance */
+    os_list_t        mutex_list;                /* mutexes held by task */
+    struct os_mutex *pending_mutex;             /* mutex the task waits for */
+
+    /* wait queue of IPC object, valid while suspended */
+    struct os_waitq *pending_waitq;             /* wait queue the task is in */
+    uint8_t          pending_flag;              /* flag of the IPC object */
+
     /* task event */
     uint32_t event_set;
     uint8_t  event_info;
 
+#ifdef OS_CFG_TASK_NOTIFY
+    /* task notification */
+    uint32_t notify_value;
+    uint8_t  notify_state;
+#endif
+
+#ifdef OS_CFG_TASK_STATS
+    /* task runtime statistics */
+    os_task_stats_t stats;
+#endif
+
+#ifdef OS_CFG_SCHED_EDF
+    /* earliest deadline first */
+    os_tick_t  edf_period;                      /* release period, 0 for fixed priority */
+    os_tick_t  edf_deadline;                    /* relative deadline */
+    os_tick_t  edf_budget;                      /* execution budget of each job */
+    os_tick_t  edf_release;                     /* release tick of current job */
+    os_tick_t  edf_abs_deadline;                /* absolute deadline of current job */
+    os_tick_t  edf_remaining;                   /* remaining budget of current job */
+    uint32_t   edf_misses;                      /* jobs completed after deadline */
+    uint32_t   edf_overruns;                    /* jobs ran out of budget */
+#endif
+
+#ifdef OS_CFG_TASK_FPU
+    /* fpu registers, saved only when another fpu task takes the fpu */
+    uint32_t   fpu_context[OS_ARCH_FPU_CONTEXT_WORDS];
+#endif
+
+#ifdef OS_CFG_SMP
+    uint32_t   cpu_affinity;                    /* processors allowed to run on */
+    uint8_t    oncpu;                           /* processor running on, OS_CPU_NONE if not running */
+#endif
+
     os_tick_t  slice_tick;                      /* task's initialized tick */
     os_tick_t  remaining_tick;                  /* remaining tick */
 
@@ -98,6 +197,28 @@ struct os_task
 };
 typedef struct os_task os_task_t;
 
+/**
+ * task snapshot structure, a packed copy of one registered task
+ */
+struct os_task_info
+{
+    os_task_t *task;                            /* the task object */
+    char     name[OS_NAME_MAX];                 /* the name of task */
+    uint8_t  stat;                              /* task stat */
+    uint8_t  current_priority;                  /* current priority */
+
+    uint32_t stack_size;                        /* stack size */
+    uint32_t stack_used;                        /* stack used when last switched out */
+#ifdef OS_CFG_TASK_STACK_HWM
+    uint32_t stack_hwm;                         /* the most stack ever used */
+#endif
+
+#ifdef OS_CFG_TASK_STATS
+    os_task_stats_t stats;                      /* runtime statistics */
+#endif
+};
+typedef struct os_task_info os_task_info_t;
+
 /*
  * task interface
  */
@@ -115,8 +236,53 @@ os_err_t os_task_startup(os_task_t *task);
 
 os_err_t os_task_yield(void);
 os_err_t os_task_sleep(os_tick_t tick);
+os_err_t os_task_sleep_until(os_tick_t *last_wake, os_tick_t period);
 os_err_t os_task_priority_set(os_task_t *task, uint8_t priority);
 os_err_t os_task_suspend(os_task_t *task);
 os_err_t os_task_resume(os_task_t *task);
 
+os_task_t *os_task_find(const char *name);
+uint32_t os_task_count(void);
+uint32_t os_task_snapshot(os_task_info_t *info, uint32_t max);
+
+#ifdef OS_CFG_TASK_FPU
+os_err_t os_task_fpu_enable(os_task_t *task);
+#endif
+
+#ifdef OS_CFG_SMP
+os_err_t os_task_affinity_set(os_task_t *task, uint32_t cpu_mask);
+#endif
+
+#ifdef OS_CFG_TASK_STACK_HWM
+uint32_t os_task_stack_hwm(os_task_t *task);
+void os_task_stack_watch(void);
+void os_task_stack_report(void);
+#endif
+
+/*
+ * task kernel service
+ * note: a priority lent by a mutex, a fixed priority task may enter the band
+ * of earliest deadline first.
+ */
+os_err_t os_task_priority_inherit(os_task_t *task, uint8_t priority);
+
+void os_task_registry_lock(void);
+void os_task_registry_unlock(void);
+
+#ifdef OS_CFG_TASK_NOTIFY
+os_err_t os_task_notify(os_task_t *task, uint32_t value, uint8_t action);
+os_err_t os_task_notify_give(os_task_t *task);
+os_err_t os_task_notify_take(bool_t clear, uint32_t *value, os_tick_t timeout);
+os_err_t os_task_notify_wait(uint32_t clear_on_entry,
+                             uint32_t clear_on_exit,
+                             uint32_t *value,
+                             os_tick_t timeout);
+#endif
+
+#ifdef OS_CFG_TASK_STATS
+os_err_t os_task_stats_get(os_task_t *task, os_task_stats_t *stats);
+void os_task_stats_foreach(void (*callback)(os_task_t *task, void *arg),
+                           void *arg);
+#endif
+
 #endif /* _OS_TASK_H_ */
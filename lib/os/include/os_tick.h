@@ -29,6 +29,7 @@
  */
 os_tick_t os_tick_get(void);
 void os_tick_increase(void);
+void os_tick_advance(os_tick_t tick);
 os_tick_t os_tick_from_millisecond(uint32_t ms);
 
 #endif /* _OS_TICK_H_ */
@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      periodic timer keeps its deadlines, add overrun policy
  */
 #ifndef _OS_TIMER_H_
 #define _OS_TIMER_H_
@@ -35,6 +36,15 @@
  */
 #define OS_TIMER_ACTIVATED         0x1             /* timer is active */
 #define OS_TIMER_PERIODIC          0x2             /* periodic timer */
+#define OS_TIMER_SOFT              0x4             /* run timeout in timer task */
+
+/*
+ * overrun policy of periodic timer, when the next deadline passed as well
+ */
+#define OS_TIMER_OVERRUN_CATCHUP   0x00            /* fire once for every missed period */
+#define OS_TIMER_OVERRUN_SKIP      0x08            /* drop the missed periods */
+#define OS_TIMER_OVERRUN_REPORT    0x10            /* drop and count them in overrun */
+#define OS_TIMER_OVERRUN_MASK      0x18
 
 #define OS_TIMER_SET_TIME          0x0             /* set timer control command */
 #define OS_TIMER_GET_TIME          0x1             /* get timer control command */
@@ -55,6 +65,8 @@ struct os_timer
     os_tick_t        interval_tick;                     /* timer tick count */
     os_tick_t        startup_tick;                      /* start tick */
     os_tick_t        timeout_tick;                      /* end tick */
+
+    uint32_t         overrun;                           /* periods dropped, OS_TIMER_OVERRUN_REPORT */
 };
 typedef struct os_timer os_timer_t;
 
@@ -70,7 +82,15 @@ os_err_t os_timer_delete(os_timer_t *timer);
 os_err_t os_timer_start(os_timer_t *timer);
 os_err_t os_timer_stop(os_timer_t *timer);
 os_err_t os_timer_tick_set(os_timer_t *timer, os_tick_t tick);
+uint32_t os_timer_overrun_get(os_timer_t *timer);
 
 void os_timer_check(void);
+os_tick_t os_timer_next_timeout_tick(void);
+
+/*
+ * timer kernel service
+ * note: re-arm an expired periodic timer at its next deadline, irq disabled.
+ */
+void os_timer_periodic_restart(os_timer_t *timer);
 
 #endif /* _OS_TIMER_H_ */
@@ -20,11 +20,21 @@
  * Change Logs:
  * Date           Author       Notes
  * 2016-02-16     kontais      the first version
+ * 2026-10-17     kontais      add soft timer task wakeup
  */
 #ifndef _OS_SOFT_TIMER_H_
 #define _OS_SOFT_TIMER_H_
 
+/*
+ * soft timer system service
+ */
 extern os_list_t os_soft_timer_list;
 void os_init_timer_task(void);
 
+/*
+ * soft timer kernel service
+ * note: the head of soft timer list changed, let the timer task re-arm.
+ */
+void os_timer_task_wakeup(void);
+
 #endif /* _OS_SOFT_TIMER_H_ */
@@ -0,0 +1,109 @@
+/*
+ * File      : os_trace.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+#ifndef _OS_TRACE_H_
+#define _OS_TRACE_H_
+
+/* the number of events kept in trace ring buffer, a power of two */
+#ifndef OS_TRACE_EVENTS
+#define OS_TRACE_EVENTS               256
+#endif
+
+/* the frequency of cycle counter, 0 if unknown to the kernel */
+#ifndef OS_TRACE_CYCLE_HZ
+#define OS_TRACE_CYCLE_HZ             0
+#endif
+
+#define OS_TRACE_MAGIC                0x5254534F      /* "OSTR" */
+#define OS_TRACE_VERSION              1
+
+/*
+ * trace event type
+ */
+#define OS_TRACE_TASK_NAME            0x01    /* object: task, arg: offset, data: 4 chars of name */
+#define OS_TRACE_SWITCH               0x02    /* object: to task, arg: priority, data: from task */
+#define OS_TRACE_ISR_ENTER            0x03    /* arg: interrupt nest after enter */
+#define OS_TRACE_ISR_LEAVE            0x04    /* arg: interrupt nest before leave */
+#define OS_TRACE_IPC_BLOCK            0x05    /* object: task, data: wait queue */
+#define OS_TRACE_IPC_WAKE             0x06    /* object: task, data: wait queue */
+#define OS_TRACE_TIMER                0x07    /* object: timer, data: timeout function */
+#define OS_TRACE_MALLOC               0x08    /* object: memory, data: size */
+#define OS_TRACE_FREE                 0x09    /* object: memory, data: size */
+
+/*
+ * trace event, a fixed size binary record
+ */
+struct os_trace_event
+{
+    uint32_t stamp;                             /* cycle counter */
+    uint8_t  type;                              /* event type */
+    uint8_t  nest;                              /* interrupt nest */
+    uint16_t arg;                               /* argument of event */
+    uint32_t object;                            /* object of event */
+    uint32_t data;                              /* data of event */
+};
+typedef struct os_trace_event os_trace_event_t;
+
+/*
+ * trace buffer, the header makes a memory image of it self described
+ */
+struct os_trace_buffer
+{
+    uint32_t magic;                             /* OS_TRACE_MAGIC */
+    uint16_t version;                           /* OS_TRACE_VERSION */
+    uint16_t event_size;                        /* size of event record */
+    uint32_t events;                            /* capacity of ring buffer */
+    uint32_t index;                             /* events ever recorded */
+    uint32_t cycle_hz;                          /* frequency of stamp */
+    uint32_t enable;                            /* recording or not */
+
+    os_trace_event_t event[OS_TRACE_EVENTS];    /* ring buffer */
+};
+
+#ifdef OS_CFG_TRACE
+extern struct os_trace_buffer os_trace_buffer;
+
+#define OS_TRACE(type, arg, object, data)                                     \
+do                                                                            \
+{                                                                             \
+    if (os_trace_buffer.enable)                                               \
+        os_trace_record(type, arg, (uint32_t)(object), (uint32_t)(data));     \
+}                                                                             \
+while (0)
+#else
+#define OS_TRACE(type, arg, object, data)
+#endif
+
+/*
+ * trace kernel service
+ */
+void os_trace_record(uint8_t type, uint16_t arg, uint32_t object, uint32_t data);
+
+/*
+ * trace user service
+ */
+void os_trace_start(void);
+void os_trace_stop(void);
+void os_trace_dump(void (*output)(const void *data, uint32_t size));
+
+#endif /* _OS_TRACE_H_ */
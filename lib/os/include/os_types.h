@@ -20,11 +20,13 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017-10-19     kontais      the first version
+ * 2026-10-17     kontais      take size_t from stddef.h
  */
 #ifndef _OS_TYPES_H_
 #define _OS_TYPES_H_
 
 #include <stdint.h>
+#include <stddef.h>                                 /* size_t of the tool chain */
 
 typedef unsigned char bool_t;
 
@@ -33,7 +35,6 @@ typedef unsigned char bool_t;
 
 //typedef uint32_t                    time_t;         /* Type for time stamp */
 typedef uint32_t                    os_tick_t;      /* Type for tick count */
-typedef uint32_t                    size_t;         /* Type for size number */
 typedef int32_t                     offset_t;       /* Type for offset */
 
 #endif /* _OS_TYPES_H_ */
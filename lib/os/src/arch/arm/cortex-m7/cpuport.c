@@ -17,6 +17,12 @@
  * 2012-12-23     aozima       stack addr align to 8byte.
  * 2012-12-29     Bernard      Add exception hook.
  * 2013-06-23     aozima       support lazy stack optimized.
+ * 2026-10-17     kontais      add DWT cycle counter.
+ * 2026-10-17     kontais      add MPU stack guard.
+ * 2026-10-17     kontais      add per task FPU ownership.
+ * 2026-10-17     kontais      move IAR FPU save and load to context_iar.S.
+ * 2026-10-17     kontais      unlock DWT before starting the cycle counter.
+ * 2026-10-17     kontais      rename to os_arch_task_stack_init of os_cpu.h.
  */
 
 #include <os.h>
@@ -134,7 +140,7 @@ struct stack_frame_fpu
     struct exception_stack_frame_fpu exception_stack_frame;
 };
 
-uint8_t *os_arch_stack_init(void       *tentry,
+uint8_t *os_arch_task_stack_init(void       *tentry,
                              void       *parameter,
                              uint8_t *stack_addr,
                              void       *texit)
@@ -220,6 +226,241 @@ void os_arch_shutdown(void)
     OS_ASSERT(0);
 }
 
+#if defined(OS_CFG_TASK_STATS) || defined(OS_CFG_TRACE)
+#define DEM_CR          (*(volatile unsigned *)0xE000EDFC) /* Debug Exception and Monitor Control Register */
+#define DWT_CTRL        (*(volatile unsigned *)0xE0001000) /* DWT Control Register */
+#define DWT_CYCCNT      (*(volatile unsigned *)0xE0001004) /* DWT Cycle Count Register */
+#define DWT_LAR         (*(volatile unsigned *)0xE0001FB0) /* DWT Lock Access Register */
+
+#define DEM_CR_TRCENA           (1UL << 24)
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)
+#define DWT_LAR_KEY             0xC5ACCE55
+
+/**
+ * This function starts the DWT cycle counter for task statistics.
+ */
+void os_arch_cycle_init(void)
+{
+    DEM_CR    |= DEM_CR_TRCENA;
+    /* many M7 parts keep DWT locked for software, CYCCNT never counts */
+    DWT_LAR    = DWT_LAR_KEY;
+    DWT_CYCCNT = 0;
+    DWT_CTRL  |= DWT_CTRL_CYCCNTENA;
+}
+
+/**
+ * This function returns the DWT cycle counter, it wraps at 2^32.
+ */
+uint32_t os_arch_cycle_get(void)
+{
+    return DWT_CYCCNT;
+}
+#endif
+
+/* address of MPU_RBAR once the stack guard is enabled, read by PendSV_Handler */
+uint32_t os_arch_stack_guard;
+
+#ifdef OS_CFG_STACK_GUARD
+#define SCB_SHCSR       (*(volatile unsigned *)0xE000ED24) /* System Handler Control and State Register */
+#define SCB_MFSR        (*(volatile unsigned char *)0xE000ED28) /* MemManage Fault Status Register */
+#define SCB_MMFAR       (*(volatile unsigned *)0xE000ED34) /* MemManage Fault Address Register */
+#define MPU_CTRL        (*(volatile unsigned *)0xE000ED94) /* MPU Control Register */
+#define MPU_RNR         (*(volatile unsigned *)0xE000ED98) /* MPU Region Number Register */
+#define MPU_RBAR        (*(volatile unsigned *)0xE000ED9C) /* MPU Region Base Address Register */
+#define MPU_RASR        (*(volatile unsigned *)0xE000EDA0) /* MPU Region Attribute and Size Register */
+
+#define SCB_SHCSR_MEMFAULTENA   (1UL << 16)
+#define SCB_MFSR_MSTKERR        (1UL << 4)
+#define SCB_MFSR_MMARVALID      (1UL << 7)
+#define MPU_CTRL_ENABLE         (1UL << 0)
+#define MPU_CTRL_PRIVDEFENA     (1UL << 2)
+
+/* the highest region wins, 32 bytes, no access and never execute */
+#define MPU_GUARD_REGION        7
+#define MPU_GUARD_RASR          ((1UL << 28) | (4UL << 1) | (1UL << 0))
+
+/* the same rounding as PendSV_Handler */
+#define MPU_GUARD_BASE(addr)    OS_ALIGN((uint32_t)(addr), OS_ARCH_STACK_GUARD_SIZE)
+
+/**
+ * This function enables the MPU stack guard. A no access region covers the
+ * lowest aligned 32 bytes of the running task stack and PendSV_Handler moves
+ * it on every switch, so an overflow traps in MemManage_Handler before any
+ * memory below the stack is corrupted.
+ *
+ * @param stack_addr the stack address of the first task
+ */
+void os_arch_stack_guard_init(void *stack_addr)
+{
+    MPU_RNR    = MPU_GUARD_REGION;
+    MPU_RBAR   = MPU_GUARD_BASE(stack_addr);
+    MPU_RASR   = MPU_GUARD_RASR;
+
+    /* the default memory map stays for everything else */
+    MPU_CTRL   = MPU_CTRL_PRIVDEFENA | MPU_CTRL_ENABLE;
+    SCB_SHCSR |= SCB_SHCSR_MEMFAULTENA;
+
+    os_arch_stack_guard = (uint32_t)&MPU_RBAR;
+}
+
+/*
+ * MemManage fault handler, names the task whose stack guard is hit
+ */
+void MemManage_Handler(void)
+{
+    extern os_list_t os_task_registry;
+    os_list_t *node;
+    os_task_t *task;
+    uint32_t guard;
+    uint8_t mfsr;
+
+    mfsr  = SCB_MFSR;
+    guard = MPU_RBAR & ~(OS_ARCH_STACK_GUARD_SIZE - 1);
+
+    /* stacking into the guard, or a fault address inside it */
+    if ((mfsr & SCB_MFSR_MSTKERR) ||
+        ((mfsr & SCB_MFSR_MMARVALID) &&
+         SCB_MMFAR - guard < OS_ARCH_STACK_GUARD_SIZE)) {
+        for (node = os_task_registry.next;
+             node != &os_task_registry;
+             node = node->next) {
+            task = OS_LIST_ENTRY(node, os_task_t, rlist);
+            if (MPU_GUARD_BASE(task->stack_addr) == guard) {
+                printk("stack overflow on task: %s\n", task->name);
+
+                while (1);
+            }
+        }
+    }
+
+    printk("mfsr: 0x%02x\n", mfsr);
+    printk("mmfar: 0x%08x\n", SCB_MMFAR);
+    printk("memory fault on task: %s\n", os_task_self()->name);
+
+    while (1);
+}
+#endif
+
+#ifdef OS_CFG_TASK_FPU
+#if !USE_FPU
+#error "OS_CFG_TASK_FPU needs a hard float build"
+#endif
+
+#define SCB_CPACR       (*(volatile unsigned *)0xE000ED88) /* Coprocessor Access Control Register */
+#define FPU_FPCCR       (*(volatile unsigned *)0xE000EF34) /* Floating-point Context Control Register */
+
+#define SCB_CPACR_CP10_CP11     (0xFUL << 20)
+#define FPU_FPCCR_ASPEN         (1UL << 31)
+#define FPU_FPCCR_LSPEN         (1UL << 30)
+
+/* the task whose context is in the fpu registers */
+static os_task_t *os_arch_fpu_owner = NULL;
+
+#if defined(__CC_ARM)
+#define FPU_SYNC()      do { __dsb(0xF); __isb(0xF); } while (0)
+
+static __asm void _os_arch_fpu_save(uint32_t *context)
+{
+    VSTMIA  r0!, {s0 - s31}
+    VMRS    r1, FPSCR
+    STR     r1, [r0]
+    BX      lr
+}
+
+static __asm void _os_arch_fpu_load(uint32_t *context)
+{
+    VLDMIA  r0!, {s0 - s31}
+    LDR     r1, [r0]
+    VMSR    FPSCR, r1
+    BX      lr
+}
+#elif defined(__IAR_SYSTEMS_ICC__)
+#define FPU_SYNC()      do { __DSB(); __ISB(); } while (0)
+
+/*
+ * in context_iar.S, separate __ASM statements may not keep r0 and r1 from
+ * one to the next
+ */
+void _os_arch_fpu_save(uint32_t *context);
+void _os_arch_fpu_load(uint32_t *context);
+#elif defined(__GNUC__)
+#define FPU_SYNC()      __asm volatile ("dsb\n isb" ::: "memory")
+
+static void _os_arch_fpu_save(uint32_t *context)
+{
+    uint32_t fpscr;
+
+    __asm volatile ("vstmia %1, {s0-s31}\n"
+                    "vmrs   %0, fpscr\n"
+                    "str    %0, [%1, #128]"
+                    : "=&r" (fpscr) : "r" (context) : "memory");
+}
+
+static void _os_arch_fpu_load(uint32_t *context)
+{
+    uint32_t fpscr;
+
+    __asm volatile ("vldmia %1, {s0-s31}\n"
+                    "ldr    %0, [%1, #128]\n"
+                    "vmsr   fpscr, %0"
+                    : "=&r" (fpscr) : "r" (context) : "memory");
+}
+#endif
+
+/**
+ * This function hands the FPU to the kernel. The hardware stacks no FPU
+ * state any more, the registers belong to one FPU task at a time and are
+ * switched by os_arch_fpu_switch. Interrupt handlers shall not use the FPU.
+ */
+void os_arch_fpu_init(void)
+{
+    FPU_FPCCR &= ~(FPU_FPCCR_ASPEN | FPU_FPCCR_LSPEN);
+
+    os_arch_fpu_owner = NULL;
+}
+
+/**
+ * This function prepares the FPU for the task to be switched to. A non FPU
+ * task runs with the FPU disabled and the registers left to their owner, a
+ * FPU task saves the context of the last owner only if it is not the owner.
+ *
+ * @param task the task to be switched to
+ *
+ * @note this function is invoked by scheduler with interrupt disabled.
+ */
+void os_arch_fpu_switch(os_task_t *task)
+{
+    if (!(task->flags & OS_TASK_FLAG_FPU)) {
+        SCB_CPACR &= ~SCB_CPACR_CP10_CP11;
+
+        return;
+    }
+
+    SCB_CPACR |= SCB_CPACR_CP10_CP11;
+    FPU_SYNC();
+
+    if (os_arch_fpu_owner == task)
+        return;
+
+    if (os_arch_fpu_owner != NULL)
+        _os_arch_fpu_save(os_arch_fpu_owner->fpu_context);
+    _os_arch_fpu_load(task->fpu_context);
+
+    os_arch_fpu_owner = task;
+}
+
+/**
+ * This function forgets a task leaving the system as the FPU owner.
+ *
+ * @param task the task to be released
+ */
+void os_arch_fpu_release(os_task_t *task)
+{
+    if (os_arch_fpu_owner == task)
+        os_arch_fpu_owner = NULL;
+}
+#endif
+
 #ifdef OS_CFG_CPU_FFS
 /**
  * This function finds the first bit set (beginning with the least significant bit)
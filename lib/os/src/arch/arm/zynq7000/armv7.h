@@ -61,5 +61,8 @@ struct os_arch_exp_stack
 #define J_Bit       (1<<24)
 
 void os_arch_mmu_init(void);
+#ifdef OS_CFG_SMP
+void os_arch_mmu_secondary_init(void);
+#endif
 
 #endif
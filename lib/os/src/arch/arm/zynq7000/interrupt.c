@@ -16,6 +16,10 @@
  *  You should have received a copy of the GNU General Public License along
  *  with this program; if not, write to the Free Software Foundation, Inc.,
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      add inter processor interrupt for SMP
  */
 
 #include <rtcpu.h>
@@ -23,10 +27,19 @@
 #include "zynq7000.h"
 #include "cp15.h"
 #include "gic.h"
+#include "armv7.h"
 
 #define MAX_HANDLERS                IRQ_Zynq7000_MAXNR
 
+#ifdef OS_CFG_SMP
+/* software generated interrupt to ask a processor for schedule */
+#define OS_ARCH_IPI_SCHED           0
+
+/* the BootROM of zynq jumps secondary processor to the address here */
+#define Zynq7000_CPU1_START_ADDR    0xFFFFFFF0
+#else
 extern volatile uint8_t os_isr_nest;
+#endif
 
 /* exception and interrupt handler table */
 struct rt_irq_desc isr_table[MAX_HANDLERS];
@@ -59,6 +72,14 @@ static void os_arch_vector_init(void)
                   :"r" (src));
 }
 
+#ifdef OS_CFG_SMP
+static void os_arch_ipi_sched_handle(int vector, void *param)
+{
+    /* put off till interrupt exit, see os_arch_irq_need_sched */
+    os_sched();
+}
+#endif
+
 /**
  * This function will initialize hardware interrupt
  */
@@ -84,7 +105,62 @@ void os_arch_interrupt_init(void)
     interrupt_switch_task_from = 0;
     interrupt_switch_task_to = 0;
     interrupt_switch_flag = 0;
+
+#ifdef OS_CFG_SMP
+    isr_table[OS_ARCH_IPI_SCHED].handler = os_arch_ipi_sched_handle;
+    arm_gic_umask(0, OS_ARCH_IPI_SCHED);
+#endif
+}
+
+#ifdef OS_CFG_SMP
+/**
+ * This function will initialize a secondary processor, the distributor and
+ * page table are set up by the primary one already.
+ */
+void os_arch_secondary_init(void)
+{
+    os_arch_mmu_secondary_init();
+
+    os_arch_vector_init();
+
+    /* the processor interface and SGI are banked per processor */
+    arm_gic_os_arch_init(0, Zynq7000_GIC_CPU_BASE);
+    arm_gic_umask(0, OS_ARCH_IPI_SCHED);
+
+    os_isr_nest = 0;
+}
+
+/**
+ * This function will release the secondary processor from BootROM.
+ */
+void os_arch_secondary_cpu_up(void)
+{
+    extern void _secondary_reset(void);
+
+    *(volatile uint32_t *)Zynq7000_CPU1_START_ADDR = (uint32_t)_secondary_reset;
+
+    asm volatile ("dsb\n"
+                  "sev\n" ::: "memory");
+}
+
+/**
+ * This function will ask processors to schedule.
+ * @param cpu_mask the mask of processors
+ */
+void os_arch_ipi_send(uint32_t cpu_mask)
+{
+    arm_gic_trigger(0, cpu_mask, OS_ARCH_IPI_SCHED);
+}
+
+/**
+ * This function will return whether a schedule is put off in interrupt, it
+ * is invoked at interrupt exit with interrupt disabled.
+ */
+int os_arch_irq_need_sched(void)
+{
+    return os_isr_nest == 0 && os_cpu_self()->need_sched != 0;
 }
+#endif
 
 /**
  * This function will mask a interrupt.
@@ -168,3 +168,26 @@ void os_arch_mmu_init(void)
     os_arch_dcache_enable();
 }
 
+#ifdef OS_CFG_SMP
+/*
+ * This function will turn on MMU of a secondary processor, which shares the
+ * page table set up by os_arch_mmu_init.
+ */
+void os_arch_mmu_secondary_init(void)
+{
+    os_arch_dcache_disable();
+    os_arch_icache_disable();
+    rt_os_arch_mmu_disable();
+
+    /* become clients for all domains */
+    os_arch_set_domain_register(0x55555555);
+
+    rt_os_arch_tlb_set(MMUTable);
+
+    rt_os_arch_mmu_enable();
+
+    os_arch_icache_enable();
+    os_arch_dcache_enable();
+}
+#endif
+
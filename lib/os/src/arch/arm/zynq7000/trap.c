@@ -24,7 +24,9 @@
 #include "zynq7000.h"
 #include "gic.h"
 
+#ifndef OS_CFG_SMP
 extern os_task_t *os_current_task;
+#endif
 #ifdef RT_USING_FINSH
 extern long list_task(void);
 #endif
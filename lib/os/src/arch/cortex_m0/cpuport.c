@@ -13,6 +13,8 @@
  * 2012-05-31     aozima       Merge all of the C source code into cpuport.c
  * 2012-08-17     aozima       fixed bug: store r8 - r11.
  * 2012-12-23     aozima       stack addr align to 8byte.
+ * 2026-10-17     kontais      add SysTick based cycle counter
+ * 2026-10-17     kontais      count cycles in the fixed tick period
  */
 
 #include <os.h>
@@ -117,3 +119,52 @@ void os_arch_hard_fault_exception(struct exception_stack_frame *contex)
 
     while (1);
 }
+
+#if defined(OS_CFG_TASK_STATS) || defined(OS_CFG_TRACE)
+#define SYSTICK_VAL     (*(volatile unsigned *)0xE000E018) /* SysTick Current Value Register */
+#define SCB_ICSR        (*(volatile unsigned *)0xE000ED04) /* Interrupt Control and State Register */
+
+#define SCB_ICSR_PENDSTSET      (1UL << 26)
+
+/* the core clock of CMSIS */
+extern uint32_t SystemCoreClock;
+
+/**
+ * Cortex-M0 has no DWT cycle counter, SysTick is used as it always runs.
+ */
+void os_arch_cycle_init(void)
+{
+}
+
+/**
+ * This function returns the cycles derived from os tick and SysTick, it
+ * wraps at 2^32. Invoked with interrupt disabled.
+ *
+ * A tick is the fixed period, not the reload of SysTick. A tickless sleep
+ * reloads it with several ticks or with the rest of a tick, both end on a
+ * tick boundary, so the count into the current tick is the value modulo the
+ * period. The ticks slept are counted once the idle task adds them.
+ */
+uint32_t os_arch_cycle_get(void)
+{
+    uint32_t period;
+    uint32_t value;
+    os_tick_t tick;
+
+    period = SystemCoreClock / OS_TICKS_PER_SEC;
+    tick   = os_tick_get();
+    value  = SYSTICK_VAL;
+
+    /* SysTick reloaded, but the tick interrupt is not handled yet */
+    if (SCB_ICSR & SCB_ICSR_PENDSTSET) {
+        value = SYSTICK_VAL;
+        tick++;
+    }
+
+    /* no division on M0 in the periodic reload */
+    if (value >= period)
+        value %= period;
+
+    return tick * period + (period - 1 - value);
+}
+#endif
@@ -10,6 +10,8 @@
  * Change Logs:
  * Date         Author      Notes
  * 2009-01-05   Bernard     first version
+ * 2026-10-17   kontais     add DWT cycle counter
+ * 2026-10-17   kontais     add MPU stack guard
  */
 
 #include <os.h>
@@ -160,6 +162,117 @@ void os_arch_hard_fault_exception(struct exception_info * exception_info)
     while (1);
 }
 
+#if defined(OS_CFG_TASK_STATS) || defined(OS_CFG_TRACE)
+#define DEM_CR          (*(volatile unsigned *)0xE000EDFC) /* Debug Exception and Monitor Control Register */
+#define DWT_CTRL        (*(volatile unsigned *)0xE0001000) /* DWT Control Register */
+#define DWT_CYCCNT      (*(volatile unsigned *)0xE0001004) /* DWT Cycle Count Register */
+
+#define DEM_CR_TRCENA           (1UL << 24)
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)
+
+/**
+ * This function starts the DWT cycle counter for task statistics.
+ */
+void os_arch_cycle_init(void)
+{
+    DEM_CR    |= DEM_CR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL  |= DWT_CTRL_CYCCNTENA;
+}
+
+/**
+ * This function returns the DWT cycle counter, it wraps at 2^32.
+ */
+uint32_t os_arch_cycle_get(void)
+{
+    return DWT_CYCCNT;
+}
+#endif
+
+/* address of MPU_RBAR once the stack guard is enabled, read by PendSV_Handler */
+uint32_t os_arch_stack_guard;
+
+#ifdef OS_CFG_STACK_GUARD
+#define SCB_SHCSR       (*(volatile unsigned *)0xE000ED24) /* System Handler Control and State Register */
+#define SCB_MFSR        (*(volatile unsigned char *)0xE000ED28) /* MemManage Fault Status Register */
+#define SCB_MMFAR       (*(volatile unsigned *)0xE000ED34) /* MemManage Fault Address Register */
+#define MPU_CTRL        (*(volatile unsigned *)0xE000ED94) /* MPU Control Register */
+#define MPU_RNR         (*(volatile unsigned *)0xE000ED98) /* MPU Region Number Register */
+#define MPU_RBAR        (*(volatile unsigned *)0xE000ED9C) /* MPU Region Base Address Register */
+#define MPU_RASR        (*(volatile unsigned *)0xE000EDA0) /* MPU Region Attribute and Size Register */
+
+#define SCB_SHCSR_MEMFAULTENA   (1UL << 16)
+#define SCB_MFSR_MSTKERR        (1UL << 4)
+#define SCB_MFSR_MMARVALID      (1UL << 7)
+#define MPU_CTRL_ENABLE         (1UL << 0)
+#define MPU_CTRL_PRIVDEFENA     (1UL << 2)
+
+/* the highest region wins, 32 bytes, no access and never execute */
+#define MPU_GUARD_REGION        7
+#define MPU_GUARD_RASR          ((1UL << 28) | (4UL << 1) | (1UL << 0))
+
+/* the same rounding as PendSV_Handler */
+#define MPU_GUARD_BASE(addr)    OS_ALIGN((uint32_t)(addr), OS_ARCH_STACK_GUARD_SIZE)
+
+/**
+ * This function enables the MPU stack guard. A no access region covers the
+ * lowest aligned 32 bytes of the running task stack and PendSV_Handler moves
+ * it on every switch, so an overflow traps in MemManage_Handler before any
+ * memory below the stack is corrupted.
+ *
+ * @param stack_addr the stack address of the first task
+ */
+void os_arch_stack_guard_init(void *stack_addr)
+{
+    MPU_RNR    = MPU_GUARD_REGION;
+    MPU_RBAR   = MPU_GUARD_BASE(stack_addr);
+    MPU_RASR   = MPU_GUARD_RASR;
+
+    /* the default memory map stays for everything else */
+    MPU_CTRL   = MPU_CTRL_PRIVDEFENA | MPU_CTRL_ENABLE;
+    SCB_SHCSR |= SCB_SHCSR_MEMFAULTENA;
+
+    os_arch_stack_guard = (uint32_t)&MPU_RBAR;
+}
+
+/*
+ * MemManage fault handler, names the task whose stack guard is hit
+ */
+void MemManage_Handler(void)
+{
+    extern os_list_t os_task_registry;
+    os_list_t *node;
+    os_task_t *task;
+    uint32_t guard;
+    uint8_t mfsr;
+
+    mfsr  = SCB_MFSR;
+    guard = MPU_RBAR & ~(OS_ARCH_STACK_GUARD_SIZE - 1);
+
+    /* stacking into the guard, or a fault address inside it */
+    if ((mfsr & SCB_MFSR_MSTKERR) ||
+        ((mfsr & SCB_MFSR_MMARVALID) &&
+         SCB_MMFAR - guard < OS_ARCH_STACK_GUARD_SIZE)) {
+        for (node = os_task_registry.next;
+             node != &os_task_registry;
+             node = node->next) {
+            task = OS_LIST_ENTRY(node, os_task_t, rlist);
+            if (MPU_GUARD_BASE(task->stack_addr) == guard) {
+                printf("stack overflow on task: %s\n", task->name);
+
+                while (1);
+            }
+        }
+    }
+
+    printf("mfsr: 0x%02x\n", mfsr);
+    printf("mmfar: 0x%08x\n", SCB_MMFAR);
+    printf("memory fault on task: %s\n", os_task_self()->name);
+
+    while (1);
+}
+#endif
+
 #ifdef OS_CFG_CPU_FFS
 /**
  * This function finds the first bit set (beginning with the least significant bit)
@@ -4,6 +4,10 @@
  * version: v 0.2.0
  */
 #include <os.h>
+
+/* the one thread simulator is in cpu_port_ucontext.c */
+#ifndef OS_CFG_SIM_UCONTEXT
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <pthread.h>
@@ -399,6 +403,22 @@ void os_arch_context_switch_to(uint32_t to)
     return;
 }
 
+#if defined(OS_CFG_TASK_STATS) || defined(OS_CFG_TRACE)
+void os_arch_cycle_init(void)
+{
+}
+
+/* the simulator counts in nanoseconds of monotonic clock, wraps at 2^32 */
+uint32_t os_arch_cycle_get(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)ts.tv_sec * 1000000000UL + (uint32_t)ts.tv_nsec;
+}
+#endif
+
 static int mainthread_scheduler(void)
 {
     int i, res, sig;
@@ -531,3 +551,4 @@ static int tick_interrupt_isr(void)
     return 0;
 }
 
+#endif
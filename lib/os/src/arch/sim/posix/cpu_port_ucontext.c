@@ -0,0 +1,863 @@
+/*
+ * File      : cpu_port_ucontext.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      add virtual time and scripted interrupts
+ * 2026-10-17     kontais      add exclusive access
+ * 2026-10-17     kontais      add heap arena
+ * 2026-10-17     kontais      add busy ticks of virtual time
+ * 2026-10-17     kontais      chain interrupts raised in a dispatch, bind
+ *                             host signals to interrupts
+ * 2026-10-17     kontais      add stack guard check
+ * 2026-10-17     kontais      add fpu ownership in software
+ */
+
+/*
+ * POSIX simulator in one host thread. Every task runs on a host stack of its
+ * own, a switch only swaps the callee saved registers and stack pointer on
+ * x86, or goes through swapcontext on other hosts. Interrupts are a pending
+ * bitmap, which is dispatched when interrupt is enabled again.
+ *
+ * With OS_CFG_SIM_VIRTUAL_TIME there is no host timer. Time stands still while
+ * any task is ready, when all of them block the tickless idle jumps straight
+ * to the next timer or scripted interrupt. A task computing for some time
+ * passes it by os_arch_sim_busy, one tick interrupt a tick. A run only
+ * depends on the program, the script and the seed, so it is repeated bit for
+ * bit.
+ */
+
+#include <os.h>
+
+#ifdef OS_CFG_SIM_UCONTEXT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/time.h>
+
+#ifdef OS_CFG_SIM_VIRTUAL_TIME
+#ifndef OS_CFG_TICKLESS
+#error "OS_CFG_SIM_VIRTUAL_TIME needs OS_CFG_TICKLESS"
+#endif
+#if OS_TICKLESS_MIN_TICK > 1
+#error "OS_CFG_SIM_VIRTUAL_TIME needs OS_TICKLESS_MIN_TICK 1, no tick advances a shorter idle"
+#endif
+#endif
+
+#if !defined(__i386__) && !defined(__x86_64__)
+#include <ucontext.h>
+#define SIM_UCONTEXT
+#endif
+
+#ifndef OS_SIM_STACK_SIZE
+#define OS_SIM_STACK_SIZE       (64 * 1024)     /* host stack of a task */
+#endif
+
+#ifndef OS_SIM_EVENTS_MAX
+#define OS_SIM_EVENTS_MAX       32              /* scripted interrupts */
+#endif
+
+/*
+ * host stack, kept for the task stack it belongs to, a task initialized on
+ * the same stack again takes it over
+ */
+struct sim_stack
+{
+    struct sim_stack *next;
+    void             *stack_top;                /* task stack top, the key */
+
+#ifdef SIM_UCONTEXT
+    ucontext_t        context;
+#else
+    void             *sp;                       /* saved host stack pointer */
+#endif
+
+    void (*entry)(void *parameter);
+    void             *parameter;
+    void (*exit)(void);
+
+    volatile sig_atomic_t in_irq;               /* dispatching interrupts */
+    volatile sig_atomic_t in_signal;            /* bound signals blocked */
+
+    uint8_t           stack[OS_SIM_STACK_SIZE];
+};
+
+static struct sim_stack *sim_stack_list;
+static struct sim_stack *sim_current;
+
+/* the context of main, left by os_arch_context_switch_to */
+#ifdef SIM_UCONTEXT
+static ucontext_t sim_main_context;
+#else
+static void *sim_main_sp;
+#endif
+
+/* interrupt state, the running context owns it across a switch */
+static volatile sig_atomic_t sim_irq_disabled = 1;
+static volatile uint32_t sim_irq_pending;
+static void (*sim_irq_handler[OS_ARCH_SIM_IRQ_MAX])(void);
+
+/* switch requested in interrupt, done when the last handler returns */
+static uint32_t sim_switch_flag;
+static struct sim_stack *sim_switch_from;
+static struct sim_stack *sim_switch_to;
+#ifdef OS_CFG_STACK_GUARD
+static uint32_t sim_switch_to_sp;               /* &task->sp of sim_switch_to */
+#endif
+
+/* the address of exclusive monitor, NULL when it is open, a signal clears it */
+static volatile uint32_t *volatile sim_exclusive;
+
+/* host signals bound to interrupts, each one blocks all of them */
+static sigset_t sim_signal_set;
+static uint32_t sim_signal_irq[NSIG];
+
+#ifdef OS_CFG_SIM_VIRTUAL_TIME
+/* scripted interrupt, sorted by tick on the active list */
+struct sim_event
+{
+    struct sim_event *next;
+    os_tick_t         tick;                     /* absolute, when it is raised */
+    os_tick_t         period;                   /* 0 for once */
+    os_tick_t         jitter;                   /* random ticks added to period */
+    uint32_t          irq;
+};
+
+static struct sim_event  sim_event_pool[OS_SIM_EVENTS_MAX];
+static struct sim_event *sim_event_free;
+static struct sim_event *sim_event_list;
+
+static void _sim_event_raise(os_tick_t tick);
+#endif
+
+static uint32_t sim_random_state = 1;
+
+#ifdef OS_CFG_HEAP
+/*
+ * the heap of kernel, HEAP_START of gcc is the end of bss on a board, here it
+ * is an arena of OS_HEAP_SIZE kilobytes
+ */
+#define SIM_STR(x)              _SIM_STR(x)
+#define _SIM_STR(x)             #x
+
+__asm__ (".comm __bss_end, " SIM_STR(OS_HEAP_SIZE) " * 1024, 8\n");
+#endif
+
+#ifndef SIM_UCONTEXT
+/*
+ * void _sim_switch(void **from_sp, void *to_sp);
+ * push callee saved registers, swap stack pointer, pop them on the new one
+ */
+void _sim_switch(void **from_sp, void *to_sp);
+
+#if defined(__x86_64__)
+__asm__ (
+    ".text\n"
+    ".globl _sim_switch\n"
+    ".type _sim_switch, @function\n"
+    "_sim_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    movq  %rsp, (%rdi)\n"
+    "    movq  %rsi, %rsp\n"
+    "    popq  %r15\n"
+    "    popq  %r14\n"
+    "    popq  %r13\n"
+    "    popq  %r12\n"
+    "    popq  %rbx\n"
+    "    popq  %rbp\n"
+    "    ret\n"
+);
+
+#define SIM_SWITCH_REGS         6
+#else
+__asm__ (
+    ".text\n"
+    ".globl _sim_switch\n"
+    ".type _sim_switch, @function\n"
+    "_sim_switch:\n"
+    "    movl  4(%esp), %eax\n"
+    "    movl  8(%esp), %edx\n"
+    "    pushl %ebp\n"
+    "    pushl %ebx\n"
+    "    pushl %esi\n"
+    "    pushl %edi\n"
+    "    movl  %esp, (%eax)\n"
+    "    movl  %edx, %esp\n"
+    "    popl  %edi\n"
+    "    popl  %esi\n"
+    "    popl  %ebx\n"
+    "    popl  %ebp\n"
+    "    ret\n"
+);
+
+#define SIM_SWITCH_REGS         4
+#endif
+#endif
+
+static void _sim_context_switch(struct sim_stack *from, struct sim_stack *to)
+{
+    sim_current   = to;
+    sim_exclusive = NULL;
+
+#ifdef SIM_UCONTEXT
+    swapcontext(&from->context, &to->context);
+#else
+    _sim_switch(&from->sp, to->sp);
+#endif
+}
+
+#ifdef OS_CFG_STACK_GUARD
+#define SIM_STACK_FILL          0x23232323UL    /* the '#' of os_task_init */
+
+/* the guard of the running task, as MPU_RBAR of cortex-m */
+uint32_t os_arch_stack_guard;
+
+/**
+ * This function enables the stack guard, on the first task.
+ *
+ * @param stack_addr the stack address of the first task
+ */
+void os_arch_stack_guard_init(void *stack_addr)
+{
+    os_arch_stack_guard = OS_ALIGN((uint32_t)stack_addr, OS_ARCH_STACK_GUARD_SIZE);
+}
+
+/*
+ * Check the guard of the task switched out, then move it to the task switched
+ * in, found by &task->sp as PendSV_Handler of cortex-m does. A hit names the
+ * task which owns the guard as MemManage_Handler does.
+ */
+static void _sim_stack_guard_move(uint32_t to)
+{
+    extern os_list_t os_task_registry;
+    os_list_t *node;
+    os_task_t *task;
+    uint32_t *guard;
+    uint32_t i;
+
+    guard = (uint32_t *)(uintptr_t)os_arch_stack_guard;
+    if (guard == NULL)
+        return;
+
+    for (i = 0; i < OS_ARCH_STACK_GUARD_SIZE / 4; i++) {
+        if (guard[i] != SIM_STACK_FILL)
+            break;
+    }
+
+    if (i < OS_ARCH_STACK_GUARD_SIZE / 4) {
+        for (node = os_task_registry.next;
+             node != &os_task_registry;
+             node = node->next) {
+            task = OS_LIST_ENTRY(node, os_task_t, rlist);
+            if (OS_ALIGN((uint32_t)task->stack_addr,
+                         OS_ARCH_STACK_GUARD_SIZE) == (uint32_t)guard) {
+                printf("stack overflow on task: %s\n", task->name);
+                break;
+            }
+        }
+
+        printf("guard: 0x%08x, word %u: 0x%08x\n", (uint32_t)guard, i, guard[i]);
+        fflush(stdout);
+        exit(OS_ARCH_SIM_EXIT_GUARD);
+    }
+
+    task = OS_LIST_ENTRY((uintptr_t)to, os_task_t, sp);
+    os_arch_stack_guard = OS_ALIGN((uint32_t)task->stack_addr,
+                                   OS_ARCH_STACK_GUARD_SIZE);
+}
+#endif
+
+/* the host stack of a task, task->sp points to the slot at task stack top */
+STATIC_INLINE struct sim_stack *_sim_stack_of(uint32_t sp)
+{
+    return **(struct sim_stack ***)(uintptr_t)sp;
+}
+
+/*
+ * An interrupt raised while its context dispatches is chained to the running
+ * dispatch as on a processor, a signal nested on each tail would pile up on
+ * host stack when the signals come faster than a dispatch returns.
+ */
+static void _sim_irq_dispatch(void)
+{
+    struct sim_stack *self = sim_current;
+    struct sim_stack *from;
+    uint32_t pending;
+    uint32_t irq;
+
+    self->in_irq = 1;
+
+again:
+    do {
+        sim_irq_disabled = 1;
+        sim_exclusive    = NULL;
+
+        while ((pending = sim_irq_pending) != 0) {
+            irq = __builtin_ctz(pending);
+            __sync_fetch_and_and(&sim_irq_pending, ~(1UL << irq));
+
+            os_isr_enter();
+            if (sim_irq_handler[irq] != NULL)
+                sim_irq_handler[irq]();
+            os_isr_leave();
+        }
+
+        if (sim_switch_flag) {
+            sim_switch_flag = 0;
+
+            from = sim_switch_from;
+            if (from != sim_switch_to) {
+                /* in a signal handler, the task switched to gets them */
+                if (self->in_signal) {
+                    self->in_signal = 0;
+                    sigprocmask(SIG_UNBLOCK, &sim_signal_set, NULL);
+                }
+
+#ifdef OS_CFG_STACK_GUARD
+                _sim_stack_guard_move(sim_switch_to_sp);
+#endif
+                _sim_context_switch(from, sim_switch_to);
+            }
+
+            /* back in this task, its interrupt was enabled */
+        }
+
+        sim_irq_disabled = 0;
+    } while (sim_irq_pending != 0);
+
+    self->in_irq = 0;
+
+    /* raised after the last check, nobody dispatches it but us */
+    if (sim_irq_pending != 0 && sim_irq_disabled == 0) {
+        self->in_irq = 1;
+        goto again;
+    }
+}
+
+/*
+ * The first code of a task on its host stack. A task starts with interrupt
+ * enabled, as it would on a processor.
+ */
+static void _sim_task_start(void)
+{
+    struct sim_stack *self = sim_current;
+
+    sim_irq_disabled = 0;
+    if (sim_irq_pending != 0)
+        _sim_irq_dispatch();
+
+    self->entry(self->parameter);
+    self->exit();
+
+    /* never come back */
+    abort();
+}
+
+os_sr_t os_enter_critical(void)
+{
+    os_sr_t sr;
+
+    sr = sim_irq_disabled;
+    sim_irq_disabled = 1;
+
+    return sr;
+}
+
+void os_exit_critical(os_sr_t sr)
+{
+    sim_irq_disabled = sr;
+
+    if (sr == 0 && sim_irq_pending != 0)
+        _sim_irq_dispatch();
+}
+
+uint8_t *os_arch_task_stack_init(void       *entry,
+                             void       *parameter,
+                             uint8_t *stack_addr,
+                             void       *texit)
+{
+    struct sim_stack **slot;
+    struct sim_stack *host;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    for (host = sim_stack_list; host != NULL; host = host->next) {
+        if (host->stack_top == stack_addr)
+            break;
+    }
+
+    if (host == NULL) {
+        host = (struct sim_stack *)malloc(sizeof(struct sim_stack));
+        if (host == NULL) {
+            printf("sim: no memory for task stack\n");
+            exit(EXIT_FAILURE);
+        }
+
+        host->stack_top = stack_addr;
+        host->next      = sim_stack_list;
+        sim_stack_list  = host;
+    }
+
+    os_exit_critical(sr);
+
+    host->entry     = (void (*)(void *))entry;
+    host->parameter = parameter;
+    host->exit      = (void (*)(void))texit;
+    host->in_irq    = 0;
+    host->in_signal = 0;
+
+#ifdef SIM_UCONTEXT
+    getcontext(&host->context);
+    host->context.uc_stack.ss_sp   = host->stack;
+    host->context.uc_stack.ss_size = sizeof(host->stack);
+    host->context.uc_link          = NULL;
+    makecontext(&host->context, _sim_task_start, 0);
+#else
+    {
+        uintptr_t *sp;
+        int i;
+
+        /* as if _sim_task_start was called, then _sim_switch pushed */
+        sp = (uintptr_t *)(((uintptr_t)(host->stack + sizeof(host->stack))) & ~(uintptr_t)15);
+        *(--sp) = 0;
+        *(--sp) = (uintptr_t)_sim_task_start;
+        for (i = 0; i < SIM_SWITCH_REGS; i++)
+            *(--sp) = 0;
+
+        host->sp = sp;
+    }
+#endif
+
+    /* the task sees a stack pointer inside its own stack */
+    slot  = (struct sim_stack **)OS_ALIGN_DOWN((uintptr_t)stack_addr, sizeof(void *));
+    *slot = host;
+
+    return (uint8_t *)slot;
+}
+
+void os_arch_context_switch(uint32_t from, uint32_t to)
+{
+#ifdef OS_CFG_STACK_GUARD
+    _sim_stack_guard_move(to);
+#endif
+    _sim_context_switch(_sim_stack_of(from), _sim_stack_of(to));
+}
+
+void os_arch_context_switch_interrupt(uint32_t from, uint32_t to)
+{
+    if (sim_switch_flag == 0) {
+        sim_switch_flag = 1;
+        sim_switch_from = _sim_stack_of(from);
+    }
+    sim_switch_to = _sim_stack_of(to);
+#ifdef OS_CFG_STACK_GUARD
+    sim_switch_to_sp = to;
+#endif
+}
+
+static void _sim_tick_isr(void)
+{
+    os_tick_increase();
+}
+
+#ifndef OS_CFG_SIM_VIRTUAL_TIME
+/*
+ * The tick of host interval timer. It preempts the running task like a
+ * processor interrupt when interrupt is enabled.
+ */
+static void _sim_tick_start(void)
+{
+    struct itimerval itimer;
+
+    os_arch_sim_irq_signal(SIGALRM, OS_ARCH_SIM_IRQ_TICK);
+
+    itimer.it_interval.tv_sec  = 0;
+    itimer.it_interval.tv_usec = 1000000 / OS_TICKS_PER_SEC;
+    itimer.it_value            = itimer.it_interval;
+    setitimer(ITIMER_REAL, &itimer, NULL);
+}
+#endif
+
+void os_arch_context_switch_to(uint32_t to)
+{
+    struct sim_stack *host = _sim_stack_of(to);
+
+    os_arch_sim_irq_install(OS_ARCH_SIM_IRQ_TICK, _sim_tick_isr);
+#ifndef OS_CFG_SIM_VIRTUAL_TIME
+    _sim_tick_start();
+#endif
+
+    sim_current = host;
+
+#ifdef SIM_UCONTEXT
+    swapcontext(&sim_main_context, &host->context);
+#else
+    _sim_switch(&sim_main_sp, host->sp);
+#endif
+
+    /* never come back */
+}
+
+/**
+ * This function will install the handler of a simulated interrupt.
+ *
+ * @param irq the interrupt number, less than OS_ARCH_SIM_IRQ_MAX
+ * @param handler the handler, invoked in interrupt context
+ */
+void os_arch_sim_irq_install(uint32_t irq, void (*handler)(void))
+{
+    OS_ASSERT(irq < OS_ARCH_SIM_IRQ_MAX);
+
+    sim_irq_handler[irq] = handler;
+}
+
+/**
+ * This function will raise a simulated interrupt, it runs at once if
+ * interrupt is enabled, or when it is enabled again.
+ *
+ * @param irq the interrupt number
+ */
+void os_arch_sim_irq_raise(uint32_t irq)
+{
+    OS_ASSERT(irq < OS_ARCH_SIM_IRQ_MAX);
+
+    __sync_fetch_and_or(&sim_irq_pending, 1UL << irq);
+
+    if (sim_irq_disabled == 0 && sim_current != NULL &&
+        sim_current->in_irq == 0)
+        _sim_irq_dispatch();
+}
+
+/*
+ * A bound signal preempts the running task like a processor interrupt. The
+ * bound signals are blocked in the handler, one delivered on each other
+ * faster than a handler starts would pile up on host stack, and unblocked
+ * when the dispatch switches to another task.
+ */
+static void _sim_signal(int sig)
+{
+    struct sim_stack *self = sim_current;
+    sig_atomic_t in_signal;
+
+    if (self == NULL) {
+        __sync_fetch_and_or(&sim_irq_pending, 1UL << sim_signal_irq[sig]);
+
+        return;
+    }
+
+    /* nested on a handler which unblocked them, or which did not yet */
+    in_signal = self->in_signal;
+    self->in_signal = 1;
+    os_arch_sim_irq_raise(sim_signal_irq[sig]);
+    self->in_signal = in_signal;
+}
+
+/**
+ * This function will bind a host signal to a simulated interrupt, the
+ * signal raises it.
+ *
+ * @param sig the host signal
+ * @param irq the interrupt number
+ */
+void os_arch_sim_irq_signal(int sig, uint32_t irq)
+{
+    struct sigaction act;
+    int i;
+
+    OS_ASSERT(sig > 0 && sig < NSIG);
+    OS_ASSERT(irq < OS_ARCH_SIM_IRQ_MAX);
+
+    sim_signal_irq[sig] = irq;
+    sigaddset(&sim_signal_set, sig);
+
+    /* those bound before block the new one too */
+    act.sa_handler = _sim_signal;
+    act.sa_mask    = sim_signal_set;
+    act.sa_flags   = SA_RESTART;
+    for (i = 1; i < NSIG; i++) {
+        if (sigismember(&sim_signal_set, i) == 1)
+            sigaction(i, &act, NULL);
+    }
+}
+
+uint32_t os_arch_ldrex(volatile uint32_t *addr)
+{
+    sim_exclusive = addr;
+
+    return *addr;
+}
+
+uint32_t os_arch_strex(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t result = 1;
+    os_sr_t sr;
+
+    /* the check and store are one instruction on a processor */
+    sr = os_enter_critical();
+
+    if (sim_exclusive == addr) {
+        *addr  = value;
+        result = 0;
+    }
+    sim_exclusive = NULL;
+
+    os_exit_critical(sr);
+
+    return result;
+}
+
+void os_arch_clrex(void)
+{
+    sim_exclusive = NULL;
+}
+
+/**
+ * This function will seed the random numbers of simulator, the jitter of
+ * scripted interrupts is drawn from them.
+ *
+ * @param seed the seed, 0 is taken as 1
+ */
+void os_arch_sim_seed(uint32_t seed)
+{
+    sim_random_state = (seed != 0) ? seed : 1;
+}
+
+/**
+ * This function will return the next number of a xorshift sequence, the
+ * same seed always gives the same sequence.
+ *
+ * @return the random number
+ */
+uint32_t os_arch_sim_random(void)
+{
+    uint32_t x = sim_random_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim_random_state = x;
+
+    return x;
+}
+
+#ifdef OS_CFG_SIM_VIRTUAL_TIME
+static void _sim_event_insert(struct sim_event *event)
+{
+    struct sim_event **prev;
+
+    /* same tick keeps the order of scheduling */
+    for (prev = &sim_event_list; *prev != NULL; prev = &(*prev)->next) {
+        if ((int32_t)(event->tick - (*prev)->tick) < 0)
+            break;
+    }
+
+    event->next = *prev;
+    *prev       = event;
+}
+
+/**
+ * This function will script a simulated interrupt in virtual time.
+ *
+ * @param irq the interrupt number
+ * @param tick the absolute tick it is raised at, a passed tick raises it at once
+ * @param period the ticks to the next raise, 0 for once
+ * @param jitter at most so many random ticks added to each period
+ *
+ * @return OS_OK on success, OS_EFULL if no event is left
+ */
+os_err_t os_arch_sim_irq_schedule(uint32_t  irq,
+                                  os_tick_t tick,
+                                  os_tick_t period,
+                                  os_tick_t jitter)
+{
+    struct sim_event *event;
+    os_sr_t sr;
+    int i;
+
+    OS_ASSERT(irq < OS_ARCH_SIM_IRQ_MAX);
+
+    sr = os_enter_critical();
+
+    if (sim_event_free == NULL && sim_event_list == NULL) {
+        for (i = OS_SIM_EVENTS_MAX - 1; i >= 0; i--) {
+            sim_event_pool[i].next = sim_event_free;
+            sim_event_free = &sim_event_pool[i];
+        }
+    }
+
+    event = sim_event_free;
+    if (event == NULL) {
+        os_exit_critical(sr);
+
+        return OS_EFULL;
+    }
+    sim_event_free = event->next;
+
+    event->tick   = tick;
+    event->period = period;
+    event->jitter = jitter;
+    event->irq    = irq;
+    _sim_event_insert(event);
+
+    _sim_event_raise(os_tick_get());
+
+    os_exit_critical(sr);
+
+    return OS_OK;
+}
+
+/* mark every event due by tick pending, periodic ones are scheduled again */
+static void _sim_event_raise(os_tick_t tick)
+{
+    struct sim_event *event;
+
+    while ((event = sim_event_list) != NULL &&
+           (int32_t)(event->tick - tick) <= 0) {
+        sim_event_list = event->next;
+
+        __sync_fetch_and_or(&sim_irq_pending, 1UL << event->irq);
+
+        if (event->period != 0) {
+            event->tick += event->period;
+            if (event->jitter != 0)
+                event->tick += os_arch_sim_random() % (event->jitter + 1);
+
+            _sim_event_insert(event);
+        } else {
+            event->next    = sim_event_free;
+            sim_event_free = event;
+        }
+    }
+}
+
+/*
+ * The tickless idle of virtual time, it returns at once having passed the
+ * ticks to the timer or the scripted interrupt first due. Interrupts raised
+ * then run when idle enables interrupt.
+ */
+os_tick_t os_arch_tickless_sleep(os_tick_t tick)
+{
+    os_tick_t now = os_tick_get();
+
+    if (sim_event_list != NULL) {
+        if ((int32_t)(sim_event_list->tick - now) <= 0)
+            tick = 0;
+        else if (sim_event_list->tick - now < tick)
+            tick = sim_event_list->tick - now;
+    } else if (tick == OS_WAIT_FOREVER) {
+        /* nothing would ever wake a task */
+        printf("sim: all tasks blocked forever at tick %u\n", (uint32_t)now);
+        fflush(stdout);
+        exit(OS_ARCH_SIM_EXIT_BLOCKED);
+    }
+
+    _sim_event_raise(now + tick);
+
+    return tick;
+}
+
+/**
+ * This function will pass ticks of virtual time in the running task, as if it
+ * computed so long. Each tick is a tick interrupt, with the scripted ones due
+ * then, a task preempted by them passes the rest when it runs again.
+ *
+ * @param tick the ticks to pass
+ */
+void os_arch_sim_busy(os_tick_t tick)
+{
+    os_sr_t sr;
+
+    OS_ASSERT(sim_irq_disabled == 0);
+
+    while (tick-- > 0) {
+        sr = os_enter_critical();
+
+        /* the tick interrupt is 0, it runs before those of same tick */
+        _sim_event_raise(os_tick_get() + 1);
+        __sync_fetch_and_or(&sim_irq_pending, 1UL << OS_ARCH_SIM_IRQ_TICK);
+
+        os_exit_critical(sr);
+    }
+}
+#endif
+
+#ifdef OS_CFG_TASK_FPU
+/* the registers of simulated fpu, and the task whose context is in them */
+static volatile uint32_t sim_fpu_regs[OS_ARCH_FPU_CONTEXT_WORDS];
+static os_task_t *sim_fpu_owner;
+
+void os_arch_fpu_init(void)
+{
+    sim_fpu_owner = NULL;
+}
+
+/* as cortex-m4, a save and load only when another FPU task takes the fpu */
+void os_arch_fpu_switch(os_task_t *task)
+{
+    if (!(task->flags & OS_TASK_FLAG_FPU) || sim_fpu_owner == task)
+        return;
+
+    if (sim_fpu_owner != NULL)
+        memcpy(sim_fpu_owner->fpu_context, (void *)sim_fpu_regs, sizeof(sim_fpu_regs));
+    memcpy((void *)sim_fpu_regs, task->fpu_context, sizeof(sim_fpu_regs));
+
+    sim_fpu_owner = task;
+}
+
+void os_arch_fpu_release(os_task_t *task)
+{
+    if (sim_fpu_owner == task)
+        sim_fpu_owner = NULL;
+}
+#endif
+
+#if defined(OS_CFG_TASK_STATS) || defined(OS_CFG_TRACE)
+void os_arch_cycle_init(void)
+{
+}
+
+#ifdef OS_CFG_SIM_VIRTUAL_TIME
+/* nanoseconds of virtual time, no time passes while a task runs */
+uint32_t os_arch_cycle_get(void)
+{
+    return (uint32_t)os_tick_get() * (1000000000UL / OS_TICKS_PER_SEC);
+}
+#else
+/* the simulator counts in nanoseconds of monotonic clock, wraps at 2^32 */
+uint32_t os_arch_cycle_get(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)ts.tv_sec * 1000000000UL + (uint32_t)ts.tv_nsec;
+}
+#endif
+#endif
+
+#endif
@@ -28,6 +28,11 @@ void os_start(void)
     /* init idle task */
     os_init_idle_task();
 
+#ifdef OS_CFG_TIMER_SOFT
+    /* init soft timer task */
+    os_init_timer_task();
+#endif
+
     /* start scheduler */
     os_sched_start();
 }
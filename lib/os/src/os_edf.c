@@ -0,0 +1,239 @@
+/*
+ * File      : os_edf.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      admit under the registry lock
+ */
+
+#include <os.h>
+
+#ifdef OS_CFG_SCHED_EDF
+
+extern os_list_t os_task_registry;
+
+/* the density of a task in permille, budget over the shorter window */
+static uint32_t _os_edf_density(os_tick_t period,
+                                os_tick_t deadline,
+                                os_tick_t budget)
+{
+    return (uint32_t)(((uint64_t)budget * 1000 + deadline - 1) /
+                      (deadline < period ? deadline : period));
+}
+
+/*
+ * This function will release the next job of task, the release never goes
+ * back before current tick, so a late task does not run a burst of jobs.
+ */
+static void _os_edf_release(os_task_t *task, os_tick_t current_tick)
+{
+    task->edf_release += task->edf_period;
+    if ((int32_t)(task->edf_release - current_tick) < 0)
+        task->edf_release = current_tick;
+
+    task->edf_abs_deadline = task->edf_release + task->edf_deadline;
+    task->edf_remaining    = task->edf_budget;
+}
+
+/*
+ * This function will let the task wait for its release tick, or re-sort it
+ * in the ready queue with the new deadline when it is released already.
+ * irq must be disabled.
+ */
+static bool_t _os_edf_wait_release(os_task_t *task, os_tick_t current_tick)
+{
+    if (task->edf_release != current_tick) {
+        os_task_suspend(task);
+
+        os_timer_tick_set(&(task->timer), task->edf_release - current_tick);
+        os_timer_start(&(task->timer));
+
+        return TRUE;
+    }
+
+    os_sched_remove(task);
+    os_sched_insert(task);
+
+    return FALSE;
+}
+
+/**
+ * @ingroup Clock
+ *
+ * This function will charge one tick to the budget of current task. A task
+ * which runs out of budget is throttled until its next release, then goes on
+ * as a new job with a refilled budget.
+ *
+ * @note this function is invoked by os_tick_increase.
+ */
+void os_edf_tick(void)
+{
+    os_task_t *task;
+    os_tick_t current_tick;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    task = os_task_self();
+    if (task->edf_period == 0 ||
+        task->current_priority != OS_SCHED_EDF_PRIO ||
+        --task->edf_remaining != 0) {
+        os_exit_critical(sr);
+
+        return;
+    }
+
+    task->edf_overruns++;
+
+    OS_DEBUG_LOG(OS_DEBUG_SCHEDULER, ("task %.*s overruns budget\n",
+                                      OS_NAME_MAX, task->name));
+
+    current_tick = os_tick_get();
+    _os_edf_release(task, current_tick);
+    _os_edf_wait_release(task, current_tick);
+
+    os_exit_critical(sr);
+
+    os_sched();
+}
+
+/**
+ * @addtogroup Thread
+ */
+
+/*@{*/
+
+/**
+ * This function will move a task to earliest deadline first class, the
+ * first job is released at once. The task set is admitted only if the sum
+ * of densities stays within the processor, so every deadline can be met.
+ *
+ * @param task the task to be set, it shall not be started yet
+ * @param period the release period in ticks
+ * @param deadline the relative deadline in ticks, no more than period
+ * @param budget the execution budget of each job in ticks, no more than
+ *        deadline
+ *
+ * @return the operation status, OS_OK on OK, OS_ERROR on invalid parameter,
+ *         OS_EFULL if the task set is not schedulable with this task
+ */
+os_err_t os_task_edf_set(os_task_t *task,
+                         os_tick_t  period,
+                         os_tick_t  deadline,
+                         os_tick_t  budget)
+{
+    os_list_t *node;
+    os_task_t *edf;
+    uint32_t density;
+
+    OS_ASSERT(task != NULL);
+    OS_ASSERT(task->stat == OS_TASK_INIT);
+
+    if (budget == 0 || budget > deadline || deadline > period)
+        return OS_ERROR;
+
+    density = _os_edf_density(period, deadline, budget);
+
+    /* the registry is stable and no other task is admitted while locked */
+    os_task_registry_lock();
+
+    for (node = os_task_registry.next;
+         node != &os_task_registry;
+         node = node->next) {
+        edf = OS_LIST_ENTRY(node, os_task_t, rlist);
+        if (edf != task && edf->edf_period != 0)
+            density += _os_edf_density(edf->edf_period,
+                                       edf->edf_deadline,
+                                       edf->edf_budget);
+    }
+
+    if (density > 1000) {
+        os_task_registry_unlock();
+
+        OS_DEBUG_LOG(OS_DEBUG_SCHEDULER, ("task %.*s not schedulable\n",
+                                          OS_NAME_MAX, task->name));
+
+        return OS_EFULL;
+    }
+
+    task->edf_period       = period;
+    task->edf_deadline     = deadline;
+    task->edf_budget       = budget;
+    task->edf_release      = os_tick_get();
+    task->edf_abs_deadline = task->edf_release + deadline;
+    task->edf_remaining    = budget;
+
+    task->current_priority = OS_SCHED_EDF_PRIO;
+    task->init_priority    = OS_SCHED_EDF_PRIO;
+
+    os_task_registry_unlock();
+
+    return OS_OK;
+}
+
+/**
+ * This function will complete the current job of an earliest deadline first
+ * task, then wait for the release of next job. A job completed after its
+ * deadline is counted as a deadline miss.
+ *
+ * @return the operation status, OS_OK on OK, OS_ERROR if current task is
+ *         not an earliest deadline first task
+ */
+os_err_t os_task_edf_wait(void)
+{
+    os_task_t *task;
+    os_tick_t current_tick;
+    bool_t suspended;
+    os_sr_t sr;
+
+    /* current context checking */
+    OS_DEBUG_IN_TASK_CONTEXT;
+
+    task = os_task_self();
+    if (task->edf_period == 0)
+        return OS_ERROR;
+
+    sr = os_enter_critical();
+
+    current_tick = os_tick_get();
+    if ((int32_t)(current_tick - task->edf_abs_deadline) > 0) {
+        task->edf_misses++;
+
+        OS_DEBUG_LOG(OS_DEBUG_SCHEDULER, ("task %.*s misses deadline\n",
+                                          OS_NAME_MAX, task->name));
+    }
+
+    _os_edf_release(task, current_tick);
+    suspended = _os_edf_wait_release(task, current_tick);
+
+    os_exit_critical(sr);
+
+    os_sched();
+
+    /* the release timer is not a failure */
+    if (suspended == TRUE && task->error == OS_TIMEOUT)
+        task->error = OS_OK;
+
+    return OS_OK;
+}
+
+/*@}*/
+
+#endif
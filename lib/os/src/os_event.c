@@ -20,6 +20,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-09-14     Grissiom     add an option check in os_event_get
+ * 2026-10-17     kontais      pend on os_waitq
+ * 2026-10-17     kontais      trace wake
  */
 
 #include <os.h>
@@ -41,7 +43,7 @@ os_err_t os_event_init(os_event_t *event, uint8_t flag)
     event->flag = flag;
 
     /* init ipc object */
-    os_list_init(&(event->pending_list));
+    os_waitq_init(&(event->pending_list));
 
     /* init event */
     event->set = 0;
@@ -62,7 +64,7 @@ os_err_t os_event_delete(os_event_t *event)
     OS_ASSERT(event != NULL);
 
     /* resume all suspended task */
-    os_list_resume_all(&(event->pending_list));
+    os_waitq_resume_all(&(event->pending_list));
 
     return OS_OK;
 }
@@ -78,8 +80,8 @@ os_err_t os_event_delete(os_event_t *event)
  */
 os_err_t os_event_put(os_event_t *event, uint32_t set)
 {
-    struct os_list_node *n;
     os_task_t *task;
+    os_task_t *next;
     os_sr_t  sr;
     os_err_t status;
     bool_t need_schedule;
@@ -96,45 +98,43 @@ os_err_t os_event_put(os_event_t *event, uint32_t set)
     /* set event */
     event->set |= set;
 
-    if (!os_list_isempty(&event->pending_list)) {
-        /* search task list to resume task */
-        n = event->pending_list.next;
-        while (n != &(event->pending_list)) {
-            /* get task */
-            task = OS_LIST_ENTRY(n, os_task_t, tlist);
-
-            status = OS_ERROR;
-            if (task->event_info & OS_EVENT_AND) {
-                if ((task->event_set & event->set) == task->event_set) {
-                    /* received an AND event */
-                    status = OS_OK;
-                }
-            } else if (task->event_info & OS_EVENT_OR) {
-                if (task->event_set & event->set) {
-                    /* save recieved event set */
-                    task->event_set = task->event_set & event->set;
-
-                    /* received an OR event */
-                    status = OS_OK;
-                }
+    /* search task list to resume task */
+    task = os_waitq_first(&(event->pending_list));
+    while (task != NULL) {
+        status = OS_ERROR;
+        if (task->event_info & OS_EVENT_AND) {
+            if ((task->event_set & event->set) == task->event_set) {
+                /* received an AND event */
+                status = OS_OK;
             }
+        } else if (task->event_info & OS_EVENT_OR) {
+            if (task->event_set & event->set) {
+                /* save recieved event set */
+                task->event_set = task->event_set & event->set;
 
-            /* move node to the next */
-            n = n->next;
+                /* received an OR event */
+                status = OS_OK;
+            }
+        }
 
-            /* condition is satisfied, resume task */
-            if (status == OS_OK) {
-                /* clear event */
-                if (task->event_info & OS_EVENT_CLEAR)
-                    event->set &= ~task->event_set;
+        /* move node to the next */
+        next = os_waitq_next(&(event->pending_list), task);
 
-                /* resume task, and task list breaks out */
-                os_task_resume(task);
+        /* condition is satisfied, resume task */
+        if (status == OS_OK) {
+            /* clear event */
+            if (task->event_info & OS_EVENT_CLEAR)
+                event->set &= ~task->event_set;
 
-                /* need do a scheduling */
-                need_schedule = TRUE;
-            }
+            /* resume task, and task list breaks out */
+            OS_TRACE(OS_TRACE_IPC_WAKE, 0, task, &(event->pending_list));
+            os_task_resume(task);
+
+            /* need do a scheduling */
+            need_schedule = TRUE;
         }
+
+        task = next;
     }
 
     os_exit_critical(sr);
@@ -214,7 +214,7 @@ os_err_t os_event_get(os_event_t *event,
         task->event_info = option;
 
         /* put task to suspended task list */
-        os_list_suspend(&(event->pending_list),
+        os_waitq_suspend(&(event->pending_list),
                             task,
                             event->flag);
 
@@ -265,7 +265,7 @@ os_err_t os_event_reset(os_event_t *event, uint32_t set)
     sr = os_enter_critical();
 
     /* resume all waiting task */
-    os_list_resume_all(&event->pending_list);
+    os_waitq_resume_all(&event->pending_list);
 
     /* init event set */
     event->set = set;
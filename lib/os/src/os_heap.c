@@ -20,6 +20,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-10-14     Bernard      fix os_realloc issue when realloc a NULL pointer.
+ * 2026-10-17     kontais      yield to os_heap_tlsf.c with OS_CFG_HEAP_TLSF
+ * 2026-10-17     kontais      trace alloc and free
  */
 
 /*
@@ -58,7 +60,7 @@
 
 #define OS_HEAP_STATS
 
-#if defined (OS_CFG_HEAP)
+#if defined (OS_CFG_HEAP) && !defined (OS_CFG_HEAP_TLSF)
 
 #define HEAP_MAGIC 0x1ea0
 struct heap_mem
@@ -301,6 +303,7 @@ void *os_malloc(size_t size)
                          ("allocate memory at 0x%x, size: %d\n",
                           (uint32_t)((uint8_t *)mem + SIZEOF_STRUCT_MEM),
                           (uint32_t)(mem->next - ((uint8_t *)mem - heap_ptr))));
+            OS_TRACE(OS_TRACE_MALLOC, 0, (uint8_t *)mem + SIZEOF_STRUCT_MEM, size);
 
             /* return the memory data except mem struct */
             return (uint8_t *)mem + SIZEOF_STRUCT_MEM;
@@ -458,6 +461,7 @@ void os_free(void *rmem)
                  ("release memory 0x%x, size: %d\n",
                   (uint32_t)rmem,
                   (uint32_t)(mem->next - ((uint8_t *)mem - heap_ptr))));
+    OS_TRACE(OS_TRACE_FREE, 0, rmem, mem->next - ((uint8_t *)mem - heap_ptr));
 
     /* protect the heap from concurrent access */
     os_sem_take(&heap_sem, OS_WAIT_FOREVER);
@@ -0,0 +1,551 @@
+/*
+ * File      : os_heap_tlsf.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      trace alloc and free
+ */
+
+/*
+ * Two level segregated fit heap. Free blocks are kept in lists indexed by a
+ * power of two class (first level) and a linear subdivision of it (second
+ * level), with a bitmap per level. Both malloc and free are a constant
+ * number of bitmap and list operations, whatever the fragmentation is.
+ */
+#include <os.h>
+
+#define OS_HEAP_STATS
+
+#if defined (OS_CFG_HEAP) && defined (OS_CFG_HEAP_TLSF)
+
+/* log2 of second level lists per class */
+#ifndef OS_HEAP_TLSF_SL_LOG2
+#define OS_HEAP_TLSF_SL_LOG2    4
+#endif
+
+/* log2 of the largest block */
+#ifndef OS_HEAP_TLSF_FL_MAX
+#define OS_HEAP_TLSF_FL_MAX     20
+#endif
+
+#if OS_ALIGN_SIZE == 4
+#define TLSF_ALIGN_LOG2         2
+#elif OS_ALIGN_SIZE == 8
+#define TLSF_ALIGN_LOG2         3
+#elif OS_ALIGN_SIZE == 16
+#define TLSF_ALIGN_LOG2         4
+#else
+#error "OS_ALIGN_SIZE is not supported by TLSF heap"
+#endif
+
+#define TLSF_SL_COUNT           (1UL << OS_HEAP_TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT           (OS_HEAP_TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT           (OS_HEAP_TLSF_FL_MAX - TLSF_FL_SHIFT + 2)
+#define TLSF_SMALL_SIZE         (1UL << TLSF_FL_SHIFT)
+
+/* block header, the free list links live in the payload of a free block */
+struct heap_block
+{
+    struct heap_block *prev_phys;               /* previous physical block */
+    size_t size;                                /* payload size and flags */
+};
+
+struct heap_link
+{
+    struct heap_block *next_free;
+    struct heap_block *prev_free;
+};
+
+#define BLOCK_FREE              0x1
+#define BLOCK_PREV_FREE         0x2
+
+#define SIZEOF_BLOCK_HDR        OS_ALIGN(sizeof(struct heap_block), OS_ALIGN_SIZE)
+#define MIN_SIZE_ALIGNED        OS_ALIGN(sizeof(struct heap_link), OS_ALIGN_SIZE)
+#define MAX_SIZE_ALIGNED        OS_ALIGN_DOWN((1UL << (OS_HEAP_TLSF_FL_MAX + 1)) - 1, OS_ALIGN_SIZE)
+
+#define BLOCK_SIZE(b)           ((b)->size & ~(size_t)(BLOCK_FREE | BLOCK_PREV_FREE))
+#define BLOCK_PTR(b)            ((void *)((uint8_t *)(b) + SIZEOF_BLOCK_HDR))
+#define BLOCK_OF(p)             ((struct heap_block *)((uint8_t *)(p) - SIZEOF_BLOCK_HDR))
+#define BLOCK_NEXT(b)           ((struct heap_block *)((uint8_t *)BLOCK_PTR(b) + BLOCK_SIZE(b)))
+#define BLOCK_LINK(b)           ((struct heap_link *)BLOCK_PTR(b))
+
+static uint32_t heap_fl_bitmap;
+static uint32_t heap_sl_bitmap[TLSF_FL_COUNT];
+static struct heap_block *heap_blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+static os_sem_t heap_sem;
+static size_t mem_size_aligned;
+
+#ifdef OS_HEAP_STATS
+static size_t used_mem, max_mem;
+#endif
+
+/* find last set bit, value shall not be zero */
+static int _heap_fls(size_t value)
+{
+    int bit = 31;
+
+    if (!(value & 0xffff0000)) { value <<= 16; bit -= 16; }
+    if (!(value & 0xff000000)) { value <<= 8;  bit -= 8;  }
+    if (!(value & 0xf0000000)) { value <<= 4;  bit -= 4;  }
+    if (!(value & 0xc0000000)) { value <<= 2;  bit -= 2;  }
+    if (!(value & 0x80000000)) { bit -= 1; }
+
+    return bit;
+}
+
+/* get the list a block of size belongs to */
+static void _heap_mapping(size_t size, int *fl, int *sl)
+{
+    int f;
+
+    if (size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size >> TLSF_ALIGN_LOG2;
+    } else {
+        f   = _heap_fls(size);
+        *sl = (size >> (f - OS_HEAP_TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+static void _heap_insert(struct heap_block *block)
+{
+    struct heap_block *head;
+    int fl, sl;
+
+    _heap_mapping(BLOCK_SIZE(block), &fl, &sl);
+
+    head = heap_blocks[fl][sl];
+    BLOCK_LINK(block)->next_free = head;
+    BLOCK_LINK(block)->prev_free = NULL;
+    if (head != NULL)
+        BLOCK_LINK(head)->prev_free = block;
+    heap_blocks[fl][sl] = block;
+
+    heap_fl_bitmap     |= 1UL << fl;
+    heap_sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void _heap_remove(struct heap_block *block)
+{
+    struct heap_block *next;
+    struct heap_block *prev;
+    int fl, sl;
+
+    _heap_mapping(BLOCK_SIZE(block), &fl, &sl);
+
+    next = BLOCK_LINK(block)->next_free;
+    prev = BLOCK_LINK(block)->prev_free;
+    if (next != NULL)
+        BLOCK_LINK(next)->prev_free = prev;
+    if (prev != NULL) {
+        BLOCK_LINK(prev)->next_free = next;
+    } else {
+        heap_blocks[fl][sl] = next;
+        if (next == NULL) {
+            heap_sl_bitmap[fl] &= ~(1UL << sl);
+            if (heap_sl_bitmap[fl] == 0)
+                heap_fl_bitmap &= ~(1UL << fl);
+        }
+    }
+}
+
+/* take a free block at least size long out of free lists */
+static struct heap_block *_heap_locate(size_t size)
+{
+    struct heap_block *block;
+    uint32_t map;
+    int fl, sl;
+
+    /* round up to the next list, so any block of it fits */
+    _heap_mapping(size, &fl, &sl);
+    if (size >= TLSF_SMALL_SIZE)
+        _heap_mapping(size + (1UL << (_heap_fls(size) - OS_HEAP_TLSF_SL_LOG2)) - 1,
+                      &fl, &sl);
+
+    map = (fl < TLSF_FL_COUNT) ? heap_sl_bitmap[fl] & (~0UL << sl) : 0;
+    if (map == 0) {
+        map = (fl + 1 < TLSF_FL_COUNT) ? heap_fl_bitmap & (~0UL << (fl + 1)) : 0;
+        if (map == 0) {
+            /* no larger list, the head of its own list may still fit */
+            _heap_mapping(size, &fl, &sl);
+            block = heap_blocks[fl][sl];
+            if (block == NULL || BLOCK_SIZE(block) < size)
+                return NULL;
+
+            _heap_remove(block);
+
+            return block;
+        }
+
+        fl  = __ffs(map) - 1;
+        map = heap_sl_bitmap[fl];
+    }
+    sl = __ffs(map) - 1;
+
+    block = heap_blocks[fl][sl];
+    _heap_remove(block);
+
+    return block;
+}
+
+/* merge a block with its free neighbours, then put it to free lists */
+static void _heap_release(struct heap_block *block)
+{
+    struct heap_block *prev;
+    struct heap_block *next;
+
+    if (block->size & BLOCK_PREV_FREE) {
+        prev = block->prev_phys;
+        _heap_remove(prev);
+        prev->size += SIZEOF_BLOCK_HDR + BLOCK_SIZE(block);
+        block = prev;
+    }
+
+    next = BLOCK_NEXT(block);
+    if (next->size & BLOCK_FREE) {
+        _heap_remove(next);
+        block->size += SIZEOF_BLOCK_HDR + BLOCK_SIZE(next);
+    }
+
+    block->size |= BLOCK_FREE;
+    next = BLOCK_NEXT(block);
+    next->prev_phys = block;
+    next->size     |= BLOCK_PREV_FREE;
+
+    _heap_insert(block);
+}
+
+/* mark a block used, give the tail beyond size back to free lists */
+static void _heap_trim(struct heap_block *block, size_t size)
+{
+    struct heap_block *rest;
+    struct heap_block *next;
+
+    block->size &= ~(size_t)BLOCK_FREE;
+    next = BLOCK_NEXT(block);
+    next->size  &= ~(size_t)BLOCK_PREV_FREE;
+
+    if (BLOCK_SIZE(block) < size + SIZEOF_BLOCK_HDR + MIN_SIZE_ALIGNED)
+        return;
+
+    rest = (struct heap_block *)((uint8_t *)BLOCK_PTR(block) + size);
+    rest->prev_phys = block;
+    rest->size      = BLOCK_SIZE(block) - size - SIZEOF_BLOCK_HDR;
+    next->prev_phys = rest;
+
+    block->size = size | (block->size & BLOCK_PREV_FREE);
+
+    _heap_release(rest);
+}
+
+/**
+ * @ingroup SystemInit
+ *
+ * This function will add a memory region to system heap, the regions need
+ * not be contiguous.
+ *
+ * @param begin_addr the beginning address of the region.
+ * @param end_addr the end address of the region.
+ */
+void os_heap_add_region(void *begin_addr, void *end_addr)
+{
+    struct heap_block *block;
+    struct heap_block *sentinel;
+    uint32_t begin_align = OS_ALIGN((uint32_t)begin_addr, OS_ALIGN_SIZE);
+    uint32_t end_align = OS_ALIGN_DOWN((uint32_t)end_addr, OS_ALIGN_SIZE);
+    size_t size;
+
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    if ((end_align <= begin_align) ||
+        (end_align - begin_align < 2 * SIZEOF_BLOCK_HDR + MIN_SIZE_ALIGNED)) {
+        printf("mem init, error begin address 0x%x, and end address 0x%x\n",
+                   (uint32_t)begin_addr, (uint32_t)end_addr);
+
+        return;
+    }
+
+    /* one free block and a used sentinel, which stops merging */
+    size = end_align - begin_align - 2 * SIZEOF_BLOCK_HDR;
+    if (size > MAX_SIZE_ALIGNED)
+        size = MAX_SIZE_ALIGNED;
+
+    OS_DEBUG_LOG(OS_DEBUG_HEAP, ("mem init, heap region address 0x%x, size %d\n",
+                                begin_align, size));
+
+    block            = (struct heap_block *)begin_align;
+    block->prev_phys = NULL;
+    block->size      = size;
+
+    sentinel            = BLOCK_NEXT(block);
+    sentinel->prev_phys = block;
+    sentinel->size      = 0;
+
+    os_sem_take(&heap_sem, OS_WAIT_FOREVER);
+
+    _heap_release(block);
+    mem_size_aligned += size;
+
+    os_sem_give(&heap_sem);
+}
+
+/**
+ * @ingroup SystemInit
+ *
+ * This function will initialize system heap memory.
+ *
+ * @param begin_addr the beginning address of system heap memory.
+ * @param end_addr the end address of system heap memory.
+ */
+void os_heap_init(void *begin_addr, void *end_addr)
+{
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    heap_fl_bitmap = 0;
+    memset(heap_sl_bitmap, 0, sizeof(heap_sl_bitmap));
+    memset(heap_blocks, 0, sizeof(heap_blocks));
+
+    mem_size_aligned = 0;
+
+    os_sem_init(&heap_sem, 1, OS_IPC_FIFO);
+
+    os_heap_add_region(begin_addr, end_addr);
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/*@{*/
+
+/**
+ * Allocate a block of memory with a minimum of 'size' bytes.
+ *
+ * @param size is the minimum size of the requested block in bytes.
+ *
+ * @return pointer to allocated memory or NULL if no free memory was found.
+ */
+void *os_malloc(size_t size)
+{
+    struct heap_block *block;
+
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    if (size == 0 || size > MAX_SIZE_ALIGNED)
+        return NULL;
+
+    /* alignment size */
+    size = OS_ALIGN(size, OS_ALIGN_SIZE);
+
+    /* every data block must be at least MIN_SIZE_ALIGNED long */
+    if (size < MIN_SIZE_ALIGNED)
+        size = MIN_SIZE_ALIGNED;
+
+    /* take memory semaphore */
+    os_sem_take(&heap_sem, OS_WAIT_FOREVER);
+
+    block = _heap_locate(size);
+    if (block == NULL) {
+        os_sem_give(&heap_sem);
+
+        OS_DEBUG_LOG(OS_DEBUG_HEAP, ("no memory\n"));
+
+        return NULL;
+    }
+
+    _heap_trim(block, size);
+
+#ifdef OS_HEAP_STATS
+    used_mem += BLOCK_SIZE(block) + SIZEOF_BLOCK_HDR;
+    if (max_mem < used_mem)
+        max_mem = used_mem;
+#endif
+
+    os_sem_give(&heap_sem);
+
+    OS_DEBUG_LOG(OS_DEBUG_HEAP,
+                 ("allocate memory at 0x%x, size: %d\n",
+                  (uint32_t)BLOCK_PTR(block), BLOCK_SIZE(block)));
+    OS_TRACE(OS_TRACE_MALLOC, 0, BLOCK_PTR(block), BLOCK_SIZE(block));
+
+    return BLOCK_PTR(block);
+}
+
+/**
+ * This function will change the previously allocated memory block. The block
+ * grows in place when the physically next block is free and large enough.
+ *
+ * @param rmem pointer to memory allocated by os_malloc
+ * @param newsize the required new size
+ *
+ * @return the changed memory block address
+ */
+void *os_realloc(void *rmem, size_t newsize)
+{
+    struct heap_block *block;
+    struct heap_block *next;
+    size_t size;
+    void *nmem;
+
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    if (newsize > MAX_SIZE_ALIGNED) {
+        OS_DEBUG_LOG(OS_DEBUG_HEAP, ("realloc: out of memory\n"));
+
+        return NULL;
+    }
+
+    /* allocate a new memory block */
+    if (rmem == NULL)
+        return os_malloc(newsize);
+
+    /* alignment size */
+    newsize = OS_ALIGN(newsize, OS_ALIGN_SIZE);
+    if (newsize < MIN_SIZE_ALIGNED)
+        newsize = MIN_SIZE_ALIGNED;
+
+    block = BLOCK_OF(rmem);
+    OS_ASSERT(!(block->size & BLOCK_FREE));
+
+    os_sem_take(&heap_sem, OS_WAIT_FOREVER);
+
+    size = BLOCK_SIZE(block);
+    next = BLOCK_NEXT(block);
+
+    /* absorb the free neighbour to grow in place */
+    if (newsize > size && (next->size & BLOCK_FREE) &&
+        size + SIZEOF_BLOCK_HDR + BLOCK_SIZE(next) >= newsize) {
+        _heap_remove(next);
+        block->size += SIZEOF_BLOCK_HDR + BLOCK_SIZE(next);
+        BLOCK_NEXT(block)->prev_phys = block;
+    }
+
+    if (BLOCK_SIZE(block) >= newsize) {
+        _heap_trim(block, newsize);
+
+#ifdef OS_HEAP_STATS
+        used_mem = used_mem - size + BLOCK_SIZE(block);
+        if (max_mem < used_mem)
+            max_mem = used_mem;
+#endif
+        os_sem_give(&heap_sem);
+
+        return rmem;
+    }
+    os_sem_give(&heap_sem);
+
+    /* expand memory */
+    nmem = os_malloc(newsize);
+    if (nmem != NULL) /* check memory */
+    {
+        memcpy(nmem, rmem, size);
+        os_free(rmem);
+    }
+
+    return nmem;
+}
+
+/**
+ * This function will contiguously allocate enough space for count objects
+ * that are size bytes of memory each and returns a pointer to the allocated
+ * memory.
+ *
+ * The allocated memory is filled with bytes of value zero.
+ *
+ * @param count number of objects to allocate
+ * @param size size of the objects to allocate
+ *
+ * @return pointer to allocated memory / NULL pointer if there is an error
+ */
+void *os_calloc(size_t count, size_t size)
+{
+    void *p;
+
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    /* allocate 'count' objects of size 'size' */
+    p = os_malloc(count * size);
+
+    /* zero the memory */
+    if (p)
+        memset(p, 0, count * size);
+
+    return p;
+}
+
+/**
+ * This function will release the previously allocated memory block by
+ * os_malloc. The released memory block is taken back to system heap.
+ *
+ * @param rmem the address of memory which will be released
+ */
+void os_free(void *rmem)
+{
+    struct heap_block *block;
+
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    if (rmem == NULL)
+        return;
+    OS_ASSERT((((uint32_t)rmem) & (OS_ALIGN_SIZE-1)) == 0);
+
+    block = BLOCK_OF(rmem);
+
+    OS_DEBUG_LOG(OS_DEBUG_HEAP,
+                 ("release memory 0x%x, size: %d\n",
+                  (uint32_t)rmem, BLOCK_SIZE(block)));
+    OS_TRACE(OS_TRACE_FREE, 0, rmem, BLOCK_SIZE(block));
+
+    /* protect the heap from concurrent access */
+    os_sem_take(&heap_sem, OS_WAIT_FOREVER);
+
+    /* it has to be in a used state */
+    OS_ASSERT(!(block->size & BLOCK_FREE));
+
+#ifdef OS_HEAP_STATS
+    used_mem -= BLOCK_SIZE(block) + SIZEOF_BLOCK_HDR;
+#endif
+
+    /* see if prev or next are free also */
+    _heap_release(block);
+
+    os_sem_give(&heap_sem);
+}
+
+#ifdef OS_HEAP_STATS
+void os_memory_info(uint32_t *total,
+                    uint32_t *used,
+                    uint32_t *max_used)
+{
+    if (total != NULL)
+        *total = mem_size_aligned;
+    if (used  != NULL)
+        *used = used_mem;
+    if (max_used != NULL)
+        *max_used = max_mem;
+}
+
+#endif
+
+/*@}*/
+
+#endif /* end of OS_CFG_HEAP_TLSF */
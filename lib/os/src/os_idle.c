@@ -21,6 +21,9 @@
  * Date           Author       Notes
  * 2013-12-21     Grissiom     let os_task_idle_excute loop until there is no
  *                             dead task.
+ * 2026-10-17     kontais      add cpu load from idle task cycles
+ * 2026-10-17     kontais      keep stack high water marks up to date
+ * 2026-10-17     kontais      one idle task per processor
  */
 
 #include <os.h>
@@ -29,9 +32,20 @@
 #define IDLE_TASK_STACK_SIZE  128
 #endif
 
-static os_task_t idle;
+#ifndef OS_TICKLESS_MIN_TICK
+#define OS_TICKLESS_MIN_TICK  2
+#endif
+
+/* every processor has an idle task of its own */
+#ifdef OS_CFG_SMP
+#define IDLE_TASK_NR          OS_CPUS_NR
+#else
+#define IDLE_TASK_NR          1
+#endif
+
+static os_task_t idle[IDLE_TASK_NR];
 ALIGN(OS_ALIGN_SIZE)
-static uint8_t os_task_stack[IDLE_TASK_STACK_SIZE];
+static uint8_t os_task_stack[IDLE_TASK_NR][IDLE_TASK_STACK_SIZE];
 
 extern os_list_t os_defunct_task_list;
 
@@ -84,10 +98,81 @@ void os_task_idle_excute(void)
     }
 }
 
+#ifdef OS_CFG_TICKLESS
+/**
+ * @ingroup Thread
+ *
+ * This function will stop the periodic system tick until the next timer
+ * expires, then account for the ticks passed while sleeping.
+ */
+static void os_task_idle_tickless(void)
+{
+    os_sr_t sr;
+    os_tick_t timeout;
+    os_tick_t elapsed;
+
+    sr = os_enter_critical();
+
+    timeout = os_timer_next_timeout_tick();
+    if (timeout >= OS_TICKLESS_MIN_TICK) {
+        /* the board sleeps at most timeout ticks, any interrupt wakes it */
+        elapsed = os_arch_tickless_sleep(timeout);
+
+        os_tick_advance(elapsed);
+    }
+
+    os_exit_critical(sr);
+}
+#endif
+
+#ifdef OS_CFG_TASK_STATS
+/**
+ * @ingroup Thread
+ *
+ * This function will return the cpu load since the previous invoking, it is
+ * derived from the cycles idle task consumed in the same period.
+ *
+ * @return the cpu load in permille
+ */
+uint32_t os_cpu_load_get(void)
+{
+    static uint64_t last_total;
+    static uint64_t last_idle;
+    os_task_stats_t stats;
+    uint64_t total;
+    uint64_t busy;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    os_task_stats_get(&idle[0], &stats);
+    total = os_sched_cycles_get() - last_total;
+    busy  = total - (stats.run_cycles - last_idle);
+
+    last_total += total;
+    last_idle   = stats.run_cycles;
+
+    os_exit_critical(sr);
+
+    if (total == 0)
+        return 0;
+
+    return (uint32_t)(busy * 1000 / total);
+}
+#endif
+
 static void os_task_idle_entry(void *parameter)
 {
     while (1) {
         os_task_idle_excute();
+
+#ifdef OS_CFG_TASK_STACK_HWM
+        os_task_stack_watch();
+#endif
+
+#ifdef OS_CFG_TICKLESS
+        os_task_idle_tickless();
+#endif
     }
 }
 
@@ -100,16 +185,32 @@ static void os_task_idle_entry(void *parameter)
  */
 void os_init_idle_task(void)
 {
-    /* initialize task */
-    os_task_init(&idle,
-                   "idle",
-                   os_task_idle_entry,
-                   NULL,
-                   &os_task_stack[0],
-                   sizeof(os_task_stack),
-                   OS_IDLE_TASK_PRIO,
-                   32);
-
-    /* startup */
-    os_task_startup(&idle);
+    char name[] = "idle0";
+    uint32_t i;
+
+    for (i = 0; i < IDLE_TASK_NR; i++) {
+#ifdef OS_CFG_SMP
+        name[4] = '0' + i;
+#else
+        name[4] = '\0';
+#endif
+
+        /* initialize task */
+        os_task_init(&idle[i],
+                       name,
+                       os_task_idle_entry,
+                       NULL,
+                       &os_task_stack[i][0],
+                       sizeof(os_task_stack[i]),
+                       OS_IDLE_TASK_PRIO,
+                       32);
+
+#ifdef OS_CFG_SMP
+        /* an idle task never leaves its processor */
+        os_task_affinity_set(&idle[i], 1UL << i);
+#endif
+
+        /* startup */
+        os_task_startup(&idle[i]);
+    }
 }
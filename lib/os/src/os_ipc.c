@@ -20,10 +20,102 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-09-14     Grissiom     add an option check in os_event_get
+ * 2026-10-17     kontais      add os_list_requeue for priority inheritance
+ * 2026-10-17     kontais      priority bucketed wait queue, os_waitq
+ * 2026-10-17     kontais      trace block and wake
+ * 2026-10-17     kontais      O(1) queueing with a bucket for every priority
  */
 
 #include <os.h>
 
+/* the bucket of wait queue a priority falls in */
+#define OS_WAITQ_LEVEL(priority)    ((priority) * OS_IPC_WAITQ_LEVELS / OS_TASK_PRIORITY_MAX)
+
+/*
+ * insert a task to the wait queue. A PRIOed task goes to its priority bucket,
+ * behind the tasks with the same or higher priority. A bucket of one
+ * priority is a FIFO, a shared one is walked backward, so the usual case of
+ * equal priority is at once.
+ */
+static void _os_waitq_insert(os_waitq_t *wq, os_task_t *task, uint8_t flag)
+{
+    struct os_list_node *n;
+    os_list_t *list;
+    uint32_t level;
+
+    if (flag == OS_IPC_PRIO) {
+        level = OS_WAITQ_LEVEL(task->current_priority);
+        list  = &(wq->level[level]);
+
+#if OS_IPC_WAITQ_LEVELS < OS_TASK_PRIORITY_MAX
+        /* find a suitable position */
+        for (n = list->prev; n != list; n = n->prev) {
+            if (OS_LIST_ENTRY(n, os_task_t, tlist)->current_priority <=
+                task->current_priority)
+                break;
+        }
+#else
+        /* append to the end */
+        n = list->prev;
+#endif
+    } else {
+        level = 0;
+        list  = &(wq->level[0]);
+
+        /* append to the end */
+        n = list->prev;
+    }
+
+    os_list_insert_after(n, &(task->tlist));
+    wq->bitmap[level >> 5] |= 1UL << (level & 0x1F);
+#if OS_IPC_WAITQ_WORDS > 1
+    wq->group |= 1UL << (level >> 5);
+#endif
+}
+
+/*
+ * return the first task in the buckets from level on, the bits of buckets
+ * found empty are cleared. irq must be disabled.
+ */
+static os_task_t *_os_waitq_scan(os_waitq_t *wq, uint32_t level)
+{
+    uint32_t pending;
+    uint32_t word;
+
+    if (level >= OS_IPC_WAITQ_LEVELS)
+        return NULL;
+
+    word    = level >> 5;
+    pending = wq->bitmap[word] & ~((1UL << (level & 0x1F)) - 1);
+
+    while (1) {
+        while (pending != 0) {
+            level = (word << 5) + __ffs(pending) - 1;
+            if (!os_list_isempty(&(wq->level[level])))
+                return OS_LIST_ENTRY(wq->level[level].next, os_task_t, tlist);
+
+            /* the waiters of bucket left by timeout or resume */
+            wq->bitmap[word] &= ~(1UL << (level & 0x1F));
+            pending          &= pending - 1;
+        }
+
+#if OS_IPC_WAITQ_WORDS > 1
+        if (wq->bitmap[word] == 0)
+            wq->group &= ~(1UL << word);
+
+        /* the next word in use */
+        pending = wq->group & ~((2UL << word) - 1);
+        if (pending == 0)
+            return NULL;
+
+        word    = __ffs(pending) - 1;
+        pending = wq->bitmap[word];
+#else
+        return NULL;
+#endif
+    }
+}
+
 /**
  * @addtogroup IPC
  */
@@ -31,75 +123,140 @@
 /*@{*/
 
 /**
- * This function will suspend a task to a specified list. IPC object or some
- * double-queue object (mailbox etc.) contains this kind of list.
+ * This function will initialize a wait queue of IPC object.
  *
- * @param list the IPC suspended task list
+ * @param wq the wait queue
+ */
+void os_waitq_init(os_waitq_t *wq)
+{
+    uint32_t level;
+
+    OS_ASSERT(wq != NULL);
+
+#if OS_IPC_WAITQ_WORDS > 1
+    wq->group = 0;
+#endif
+    for (level = 0; level < OS_IPC_WAITQ_WORDS; level++)
+        wq->bitmap[level] = 0;
+    for (level = 0; level < OS_IPC_WAITQ_LEVELS; level++)
+        os_list_init(&(wq->level[level]));
+}
+
+/**
+ * This function will return the first task to be resumed in a wait queue,
+ * the highest priority one for a PRIOed IPC object.
+ *
+ * @param wq the wait queue
+ *
+ * @return the first task, NULL if no task waits
+ *
+ * @note this function shall be invoked with interrupt disabled.
+ */
+os_task_t *os_waitq_first(os_waitq_t *wq)
+{
+    return _os_waitq_scan(wq, 0);
+}
+
+/**
+ * This function will return the task behind a waiting task, in the order
+ * of resuming.
+ *
+ * @param wq the wait queue
+ * @param task the waiting task
+ *
+ * @return the next task, NULL if the task is the last one
+ *
+ * @note this function shall be invoked with interrupt disabled.
+ */
+os_task_t *os_waitq_next(os_waitq_t *wq, os_task_t *task)
+{
+    struct os_list_node *n;
+    uint32_t level;
+
+    /* the next node is a task, or the head of its bucket */
+    n = task->tlist.next;
+    if (n < &(wq->level[0]) || n >= &(wq->level[OS_IPC_WAITQ_LEVELS]))
+        return OS_LIST_ENTRY(n, os_task_t, tlist);
+
+    level = n - &(wq->level[0]);
+
+    return _os_waitq_scan(wq, level + 1);
+}
+
+/**
+ * This function will suspend a task to a wait queue of IPC object.
+ *
+ * @param wq the wait queue
  * @param task the task object to be suspended
  * @param flag the IPC object flag,
  *        which shall be OS_IPC_FIFO/OS_IPC_PRIO.
  *
  * @return the operation status, OS_OK on successful
  */
-os_err_t os_list_suspend(os_list_t        *list,
-                                       os_task_t *task,
-                                       uint8_t        flag)
+os_err_t os_waitq_suspend(os_waitq_t       *wq,
+                          os_task_t        *task,
+                          uint8_t           flag)
 {
+    OS_TRACE(OS_TRACE_IPC_BLOCK, 0, task, wq);
+
     /* suspend task */
     os_task_suspend(task);
 
-    switch (flag) {
-    case OS_IPC_FIFO:
-        os_list_insert_before(list, &(task->tlist));
-        break;
-
-    case OS_IPC_PRIO:
-        {
-            struct os_list_node *n;
-            os_task_t *sleep_task;
-
-            /* find a suitable position */
-            for (n = list->next; n != list; n = n->next) {
-                sleep_task = OS_LIST_ENTRY(n, os_task_t, tlist);
-
-                /* find out */
-                if (task->current_priority < sleep_task->current_priority) {
-                    /* insert this task before the sleep_task */
-                    os_list_insert_before(&(sleep_task->tlist), &(task->tlist));
-                    break;
-                }
-            }
-
-            /*
-             * not found a suitable position,
-             * append to the end of pending_list
-             */
-            if (n == list)
-                os_list_insert_before(list, &(task->tlist));
-        }
-        break;
+    _os_waitq_insert(wq, task, flag);
+
+    /* a change of priority finds the queue to requeue in */
+    task->pending_waitq = wq;
+    task->pending_flag  = flag;
+
+    return OS_OK;
+}
+
+/**
+ * This function will move a waiting task to the right position after its
+ * priority changed, the order of a FIFOed wait queue is kept.
+ *
+ * @param wq the wait queue
+ * @param task the task object waiting in the queue
+ * @param flag the IPC object flag,
+ *        which shall be OS_IPC_FIFO/OS_IPC_PRIO.
+ *
+ * @return the operation status, OS_OK on successful
+ *
+ * @note this function shall be invoked with interrupt disabled.
+ */
+os_err_t os_waitq_requeue(os_waitq_t       *wq,
+                          os_task_t        *task,
+                          uint8_t           flag)
+{
+    if (flag == OS_IPC_PRIO) {
+        os_list_remove(&(task->tlist));
+        _os_waitq_insert(wq, task, flag);
     }
 
     return OS_OK;
 }
 
 /**
- * This function will resume the first task in the list of a IPC object:
+ * This function will resume the first task in the wait queue of a IPC object:
  * - remove the task from suspend queue of IPC object
  * - put the task into system ready queue
  *
- * @param list the task list
+ * @param wq the wait queue
  *
- * @return the operation status, OS_OK on successful
+ * @return the operation status, OS_OK on successful, OS_ERROR if no task
+ *         waits
  */
-os_err_t os_list_resume(os_list_t *list)
+os_err_t os_waitq_resume(os_waitq_t *wq)
 {
     os_task_t *task;
 
     /* get task entry */
-    task = OS_LIST_ENTRY(list->next, os_task_t, tlist);
+    task = os_waitq_first(wq);
+    if (task == NULL)
+        return OS_ERROR;
 
     OS_DEBUG_LOG(OS_DEBUG_IPC, ("resume task:%s\n", task->name));
+    OS_TRACE(OS_TRACE_IPC_WAKE, 0, task, wq);
 
     /* resume it */
     os_task_resume(task);
@@ -108,27 +265,34 @@ os_err_t os_list_resume(os_list_t *list)
 }
 
 /**
- * This function will resume all suspended tasks in a list, including
- * suspend list of IPC object and private list of mailbox etc.
+ * This function will resume all suspended tasks in a wait queue.
  *
- * @param list of the tasks to resume
+ * @param wq the wait queue
  *
  * @return the operation status, OS_OK on successful
  */
-os_err_t os_list_resume_all(os_list_t *list)
+os_err_t os_waitq_resume_all(os_waitq_t *wq)
 {
     os_task_t *task;
     os_sr_t sr;
 
     /* wakeup all suspend tasks */
-    while (!os_list_isempty(list)) {
+    while (1) {
         sr = os_enter_critical();
 
         /* get next suspend task */
-        task = OS_LIST_ENTRY(list->next, os_task_t, tlist);
+        task = os_waitq_first(wq);
+        if (task == NULL) {
+            os_exit_critical(sr);
+
+            break;
+        }
+
         /* set error code to OS_ERROR */
         task->error = OS_ERROR;
 
+        OS_TRACE(OS_TRACE_IPC_WAKE, 0, task, wq);
+
         /*
          * resume task
          * In os_task_resume function, it will remove current task from
@@ -141,3 +305,5 @@ os_err_t os_list_resume_all(os_list_t *list)
 
     return OS_OK;
 }
+
+/*@}*/
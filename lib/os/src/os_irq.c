@@ -20,6 +20,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2006-05-03     Bernard      add IRQ_DEBUG
+ * 2026-10-17     kontais      trace interrupt enter and leave
+ * 2026-10-17     kontais      interrupt nest per processor
  */
 
 #include <os.h>
@@ -32,7 +34,9 @@
 
 /*@{*/
 
+#ifndef OS_CFG_SMP
 volatile uint8_t os_isr_nest = 0;
+#endif
 
 /**
  * This function will be invoked by BSP, when enter interrupt service routine
@@ -50,6 +54,7 @@ void os_isr_enter(void)
 
     sr = os_enter_critical();
     os_isr_nest++;
+    OS_TRACE(OS_TRACE_ISR_ENTER, os_isr_nest, 0, 0);
     os_exit_critical(sr);
 }
 
@@ -68,6 +73,7 @@ void os_isr_leave(void)
                                 os_isr_nest));
 
     sr = os_enter_critical();
+    OS_TRACE(OS_TRACE_ISR_LEAVE, os_isr_nest, 0, 0);
     os_isr_nest--;
     os_exit_critical(sr);
 }
@@ -82,6 +88,18 @@ void os_isr_leave(void)
  */
 uint8_t os_isr_nest_get(void)
 {
+#ifdef OS_CFG_SMP
+    uint8_t nest;
+    os_sr_t sr;
+
+    /* the processor may change unless interrupt is disabled */
+    sr = os_arch_irq_save();
+    nest = os_isr_nest;
+    os_arch_irq_restore(sr);
+
+    return nest;
+#else
     return os_isr_nest;
+#endif
 }
 
@@ -20,6 +20,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-09-14     Grissiom     add an option check in os_event_get
+ * 2026-10-17     kontais      pend on os_waitq
  */
 
 #include <os.h>
@@ -46,7 +47,7 @@ os_err_t os_mbox_init(os_mbox_t *mb,
     mb->flag = flag;
 
     /* init ipc object */
-    os_list_init(&(mb->pending_list));
+    os_waitq_init(&(mb->pending_list));
 
     /* init mailbox */
     mb->msg_pool   = msgpool;
@@ -56,7 +57,7 @@ os_err_t os_mbox_init(os_mbox_t *mb,
     mb->out_offset = 0;
 
     /* init an additional list of sender suspend task */
-    os_list_init(&(mb->sender_pending_list));
+    os_waitq_init(&(mb->sender_pending_list));
 
     return OS_OK;
 }
@@ -74,9 +75,9 @@ os_err_t os_mbox_delete(os_mbox_t *mb)
     OS_ASSERT(mb != NULL);
 
     /* resume all suspended task */
-    os_list_resume_all(&(mb->pending_list));
+    os_waitq_resume_all(&(mb->pending_list));
     /* also resume all mailbox private suspended task */
-    os_list_resume_all(&(mb->sender_pending_list));
+    os_waitq_resume_all(&(mb->sender_pending_list));
 
     return OS_OK;
 }
@@ -128,7 +129,7 @@ os_err_t os_mbox_put_wait(os_mbox_t *mb,
 
         OS_DEBUG_IN_TASK_CONTEXT;
         /* suspend current task */
-        os_list_suspend(&(mb->sender_pending_list),
+        os_waitq_suspend(&(mb->sender_pending_list),
                             task,
                             mb->flag);
 
@@ -179,8 +180,8 @@ os_err_t os_mbox_put_wait(os_mbox_t *mb,
     mb->entry++;
 
     /* resume suspended task */
-    if (!os_list_isempty(&mb->pending_list)) {
-        os_list_resume(&(mb->pending_list));
+    if (!os_waitq_isempty(&mb->pending_list)) {
+        os_waitq_resume(&(mb->pending_list));
 
         os_exit_critical(sr);
 
@@ -256,7 +257,7 @@ os_err_t os_mbox_get(os_mbox_t *mb, uint32_t *value, os_tick_t timeout)
 
         OS_DEBUG_IN_TASK_CONTEXT;
         /* suspend current task */
-        os_list_suspend(&(mb->pending_list),
+        os_waitq_suspend(&(mb->pending_list),
                             task,
                             mb->flag);
 
@@ -309,8 +310,8 @@ os_err_t os_mbox_get(os_mbox_t *mb, uint32_t *value, os_tick_t timeout)
     mb->entry--;
 
     /* resume suspended task */
-    if (!os_list_isempty(&(mb->sender_pending_list))) {
-        os_list_resume(&(mb->sender_pending_list));
+    if (!os_waitq_isempty(&(mb->sender_pending_list))) {
+        os_waitq_resume(&(mb->sender_pending_list));
 
         os_exit_critical(sr);
 
@@ -340,9 +341,9 @@ os_err_t os_mbox_reset(os_mbox_t *mb, void *arg)
     sr = os_enter_critical();
 
     /* resume all waiting task */
-    os_list_resume_all(&(mb->pending_list));
+    os_waitq_resume_all(&(mb->pending_list));
     /* also resume all mailbox private suspended task */
-    os_list_resume_all(&(mb->sender_pending_list));
+    os_waitq_resume_all(&(mb->sender_pending_list));
 
     /* re-init mailbox */
     mb->entry      = 0;
@@ -20,10 +20,100 @@
  * Change Logs:
  * Date           Author       Notes
  * 2012-03-22     Bernard      fix align issue in os_mpool_init and os_mpool_create.
+ * 2026-10-17     kontais      add os_mpool_alloc_isr and os_mpool_free_isr.
+ * 2026-10-17     kontais      pend on os_waitq in priority order.
  */
 
 #include <os.h>
 
+/*
+ * The free block list and free counter can be changed by an interrupt while
+ * another interrupt is in the middle of it, with exclusive access they are
+ * updated without disabling interrupt, or else in a short critical section.
+ */
+#ifdef OS_ARCH_EXCLUSIVE
+/* pop a block from free block list */
+static uint8_t *_os_mpool_pop(os_mpool_t *mp)
+{
+    uint8_t *block_ptr;
+
+    do {
+        block_ptr = (uint8_t *)os_arch_ldrex((volatile uint32_t *)&mp->block_list);
+        if (block_ptr == NULL) {
+            os_arch_clrex();
+
+            return NULL;
+        }
+    } while (os_arch_strex((uint32_t)*(uint8_t **)block_ptr,
+                           (volatile uint32_t *)&mp->block_list) != 0);
+
+    return block_ptr;
+}
+
+/* push a block to free block list */
+static void _os_mpool_push(os_mpool_t *mp, uint8_t *block_ptr)
+{
+    do {
+        *(uint8_t **)block_ptr =
+            (uint8_t *)os_arch_ldrex((volatile uint32_t *)&mp->block_list);
+    } while (os_arch_strex((uint32_t)block_ptr,
+                           (volatile uint32_t *)&mp->block_list) != 0);
+}
+
+/* add delta to free block counter */
+static void _os_mpool_count(os_mpool_t *mp, int32_t delta)
+{
+    uint32_t count;
+
+    do {
+        count = os_arch_ldrex((volatile uint32_t *)&mp->block_free_count);
+    } while (os_arch_strex(count + delta,
+                           (volatile uint32_t *)&mp->block_free_count) != 0);
+}
+#else
+/* pop a block from free block list */
+static uint8_t *_os_mpool_pop(os_mpool_t *mp)
+{
+    uint8_t *block_ptr;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    block_ptr = mp->block_list;
+    if (block_ptr != NULL)
+        mp->block_list = *(uint8_t **)block_ptr;
+
+    os_exit_critical(sr);
+
+    return block_ptr;
+}
+
+/* push a block to free block list */
+static void _os_mpool_push(os_mpool_t *mp, uint8_t *block_ptr)
+{
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    *(uint8_t **)block_ptr = mp->block_list;
+    mp->block_list = block_ptr;
+
+    os_exit_critical(sr);
+}
+
+/* add delta to free block counter */
+static void _os_mpool_count(os_mpool_t *mp, int32_t delta)
+{
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    mp->block_free_count += delta;
+
+    os_exit_critical(sr);
+}
+#endif
+
 /**
  * @addtogroup MM
  */
@@ -65,7 +155,7 @@ os_err_t os_mpool_init(os_mpool_t *mp,
     mp->block_free_count  = mp->block_total_count;
 
     /* initialize suspended task list */
-    os_list_init(&(mp->pending_list));
+    os_waitq_init(&(mp->pending_list));
     mp->suspend_task_count = 0;
 
     /* initialize free block list */
@@ -99,11 +189,17 @@ os_err_t os_mpool_delete(os_mpool_t *mp)
     OS_ASSERT(mp != NULL);
 
     /* wake up all suspended tasks */
-    while (!os_list_isempty(&(mp->pending_list))) {
+    while (1) {
         sr = os_enter_critical();
 
         /* get next suspend task */
-        task = OS_LIST_ENTRY(mp->pending_list.next, os_task_t, tlist);
+        task = os_waitq_first(&(mp->pending_list));
+        if (task == NULL) {
+            os_exit_critical(sr);
+
+            break;
+        }
+
         /* set error code to OS_ERROR */
         task->error = OS_ERROR;
 
@@ -143,7 +239,7 @@ void *os_mpool_alloc(os_mpool_t *mp, os_tick_t timeout)
 
     sr = os_enter_critical();
 
-    while (mp->block_free_count == 0) {
+    while (mp->block_list == NULL) {
         /* memory block is unavailable. */
         if (timeout == OS_NO_WAIT) {
             os_exit_critical(sr);
@@ -158,8 +254,7 @@ void *os_mpool_alloc(os_mpool_t *mp, os_tick_t timeout)
         task->error = OS_OK;
 
         /* need suspend task */
-        os_task_suspend(task);
-        os_list_insert_after(&(mp->pending_list), &(task->tlist));
+        os_waitq_suspend(&(mp->pending_list), task, OS_IPC_PRIO);
         mp->suspend_task_count++;
 
         /* no wait forever, start task timer */
@@ -177,8 +272,16 @@ void *os_mpool_alloc(os_mpool_t *mp, os_tick_t timeout)
         /* do a schedule */
         os_sched();
 
-        if (task->error != OS_OK)
+        if (task->error != OS_OK) {
+            /* a timed out task is no longer counted */
+            if (task->error == OS_TIMEOUT) {
+                sr = os_enter_critical();
+                mp->suspend_task_count--;
+                os_exit_critical(sr);
+            }
+
             return NULL;
+        }
 
         sr = os_enter_critical();
 
@@ -193,21 +296,18 @@ void *os_mpool_alloc(os_mpool_t *mp, os_tick_t timeout)
         }
     }
 
-    /* memory block is available. decrease the free block counter */
-    mp->block_free_count--;
-
     /* get block from block list */
-    block_ptr = mp->block_list;
+    block_ptr = _os_mpool_pop(mp);
     OS_ASSERT(block_ptr != NULL);
 
-    /* Setup the next free node. */
-    mp->block_list = *(uint8_t **)block_ptr;
+    os_exit_critical(sr);
+
+    /* memory block is available. decrease the free block counter */
+    _os_mpool_count(mp, -1);
 
     /* point to memory pool */
     *(uint8_t **)block_ptr = (uint8_t *)mp;
 
-    os_exit_critical(sr);
-
     return (uint8_t *)(block_ptr + sizeof(uint8_t *));
 }
 
@@ -227,21 +327,17 @@ void os_mpool_free(void *block)
     block_ptr = (uint8_t **)((uint8_t *)block - sizeof(uint8_t *));
     mp        = (os_mpool_t *)*block_ptr;
 
-    sr = os_enter_critical();
+    /* link the block into the block list */
+    _os_mpool_push(mp, (uint8_t *)block_ptr);
 
     /* increase the free block count */
-    mp->block_free_count++;
-
-    /* link the block into the block list */
-    *block_ptr = mp->block_list;
-    mp->block_list = (uint8_t *)block_ptr;
+    _os_mpool_count(mp, 1);
 
-    if (mp->suspend_task_count > 0) {
-        /* get the suspended task */
-        task = OS_LIST_ENTRY(mp->pending_list.next,
-                               os_task_t,
-                               tlist);
+    sr = os_enter_critical();
 
+    /* get the suspended task, it may have timed out */
+    task = os_waitq_first(&(mp->pending_list));
+    if (task != NULL) {
         /* set error */
         task->error = OS_OK;
 
@@ -262,4 +358,80 @@ void os_mpool_free(void *block)
     os_exit_critical(sr);
 }
 
+/**
+ * This function will allocate a block from memory pool in interrupt service
+ * routine, it never waits and does not disable interrupt on a CPU with
+ * exclusive access.
+ *
+ * @param mp the memory pool object
+ *
+ * @return the allocated memory block or NULL if the pool is empty
+ */
+void *os_mpool_alloc_isr(os_mpool_t *mp)
+{
+    uint8_t *block_ptr;
+
+    OS_ASSERT(mp != NULL);
+
+    block_ptr = _os_mpool_pop(mp);
+    if (block_ptr == NULL)
+        return NULL;
+
+    _os_mpool_count(mp, -1);
+
+    /* point to memory pool */
+    *(uint8_t **)block_ptr = (uint8_t *)mp;
+
+    return (uint8_t *)(block_ptr + sizeof(uint8_t *));
+}
+
+/**
+ * This function will release a memory block in interrupt service routine.
+ * A critical section is only taken when a task waits for the pool, and the
+ * context switch to it is deferred to the interrupt exit.
+ *
+ * @param block the address of memory block to be released
+ */
+void os_mpool_free_isr(void *block)
+{
+    uint8_t **block_ptr;
+    os_mpool_t *mp;
+    os_task_t *task;
+    os_sr_t sr;
+
+    /* get the control block of pool which the block belongs to */
+    block_ptr = (uint8_t **)((uint8_t *)block - sizeof(uint8_t *));
+    mp        = (os_mpool_t *)*block_ptr;
+
+    _os_mpool_push(mp, (uint8_t *)block_ptr);
+    _os_mpool_count(mp, 1);
+
+    if (mp->suspend_task_count == 0)
+        return;
+
+    sr = os_enter_critical();
+
+    /* re-check, another context may have woken the waiter */
+    task = os_waitq_first(&(mp->pending_list));
+    if (task != NULL) {
+        /* set error */
+        task->error = OS_OK;
+
+        /* resume task */
+        os_task_resume(task);
+
+        /* decrease suspended task count */
+        mp->suspend_task_count--;
+
+        os_exit_critical(sr);
+
+        /* in interrupt, it only pends the switch */
+        os_sched();
+
+        return;
+    }
+
+    os_exit_critical(sr);
+}
+
 /*@}*/
@@ -20,6 +20,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-09-14     Grissiom     add an option check in os_event_get
+ * 2026-10-17     kontais      add zero-copy reserve/commit and borrow/release
+ * 2026-10-17     kontais      pend on os_waitq
  */
 
 #include <os.h>
@@ -58,7 +60,7 @@ os_err_t os_mqueue_init(os_mqueue_t *mq,
     mq->flag = flag;
 
     /* init ipc object */
-    os_list_init(&(mq->pending_list));
+    os_waitq_init(&(mq->pending_list));
 
     /* set messasge pool */
     mq->msg_pool = msgpool;
@@ -99,33 +101,76 @@ os_err_t os_mqueue_delete(os_mqueue_t *mq)
     OS_ASSERT(mq != NULL);
 
     /* resume all suspended task */
-    os_list_resume_all(&mq->pending_list);
+    os_waitq_resume_all(&mq->pending_list);
 
     return OS_OK;
 }
 
+/* link a message to message queue, then wake up a receiver */
+static void _os_mqueue_link(os_mqueue_t *mq, os_mqueue_msg_t *msg, bool_t urgent)
+{
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    if (urgent == TRUE) {
+        /* link msg to the beginning of message queue */
+        msg->next = mq->msg_queue_head;
+        mq->msg_queue_head = msg;
+
+        /* if there is no tail */
+        if (mq->msg_queue_tail == NULL)
+            mq->msg_queue_tail = msg;
+    } else {
+        /* the msg is the new tailer of list, the next shall be NULL */
+        msg->next = NULL;
+
+        /* link msg to message queue */
+        if (mq->msg_queue_tail != NULL) {
+            /* if the tail exists, */
+            ((os_mqueue_msg_t *)mq->msg_queue_tail)->next = msg;
+        }
+
+        /* set new tail */
+        mq->msg_queue_tail = msg;
+        /* if the head is empty, set head */
+        if (mq->msg_queue_head == NULL)
+            mq->msg_queue_head = msg;
+    }
+
+    /* increase message entry */
+    mq->entry++;
+
+    /* resume suspended task */
+    if (!os_waitq_isempty(&mq->pending_list)) {
+        os_waitq_resume(&(mq->pending_list));
+
+        os_exit_critical(sr);
+
+        os_sched();
+
+        return;
+    }
+
+    os_exit_critical(sr);
+}
+
 /**
- * This function will put a message to message queue object, if there are
- * tasks suspended on message queue object, it will be waked up.
+ * This function will reserve a free message of message queue object, the
+ * message is built in place then sent by os_mqueue_commit.
  *
  * @param mq the message queue object
- * @param buffer the message
- * @param size the size of buffer
+ * @param buffer the reserved message of msg_size bytes
  *
- * @return the error code
+ * @return the error code, OS_EFULL if there is no free message
  */
-os_err_t os_mqueue_put(os_mqueue_t *mq, void *buffer, size_t size)
+os_err_t os_mqueue_reserve(os_mqueue_t *mq, void **buffer)
 {
     os_sr_t sr;
     os_mqueue_msg_t *msg;
 
     OS_ASSERT(mq != NULL);
     OS_ASSERT(buffer != NULL);
-    OS_ASSERT(size != 0);
-
-    /* greater than one message size */
-    if (size > mq->msg_size)
-        return OS_ERROR;
 
     sr = os_enter_critical();
 
@@ -142,39 +187,61 @@ os_err_t os_mqueue_put(os_mqueue_t *mq, void *buffer, size_t size)
 
     os_exit_critical(sr);
 
-    /* the msg is the new tailer of list, the next shall be NULL */
-    msg->next = NULL;
-    /* copy buffer */
-    memcpy(msg + 1, buffer, size);
+    *buffer = msg + 1;
 
-    sr = os_enter_critical();
-    /* link msg to message queue */
-    if (mq->msg_queue_tail != NULL) {
-        /* if the tail exists, */
-        ((os_mqueue_msg_t *)mq->msg_queue_tail)->next = msg;
-    }
+    return OS_OK;
+}
 
-    /* set new tail */
-    mq->msg_queue_tail = msg;
-    /* if the head is empty, set head */
-    if (mq->msg_queue_head == NULL)
-        mq->msg_queue_head = msg;
+/**
+ * This function will send a reserved message to message queue object, if
+ * there are tasks suspended on message queue object, it will be waked up.
+ *
+ * @param mq the message queue object
+ * @param buffer the message returned by os_mqueue_reserve
+ *
+ * @return the error code
+ */
+os_err_t os_mqueue_commit(os_mqueue_t *mq, void *buffer)
+{
+    OS_ASSERT(mq != NULL);
+    OS_ASSERT(buffer != NULL);
 
-    /* increase message entry */
-    mq->entry++;
+    _os_mqueue_link(mq, (os_mqueue_msg_t *)buffer - 1, FALSE);
 
-    /* resume suspended task */
-    if (!os_list_isempty(&mq->pending_list)) {
-        os_list_resume(&(mq->pending_list));
+    return OS_OK;
+}
 
-        os_exit_critical(sr);
+/**
+ * This function will put a message to message queue object, if there are
+ * tasks suspended on message queue object, it will be waked up.
+ *
+ * @param mq the message queue object
+ * @param buffer the message
+ * @param size the size of buffer
+ *
+ * @return the error code
+ */
+os_err_t os_mqueue_put(os_mqueue_t *mq, void *buffer, size_t size)
+{
+    os_err_t err;
+    void *msg;
 
-        os_sched();
+    OS_ASSERT(mq != NULL);
+    OS_ASSERT(buffer != NULL);
+    OS_ASSERT(size != 0);
 
-        return OS_OK;
-    }
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return OS_ERROR;
 
-    os_exit_critical(sr);
+    err = os_mqueue_reserve(mq, &msg);
+    if (err != OS_OK)
+        return err;
+
+    /* copy buffer */
+    memcpy(msg, buffer, size);
+
+    _os_mqueue_link(mq, (os_mqueue_msg_t *)msg - 1, FALSE);
 
     return OS_OK;
 }
@@ -192,8 +259,8 @@ os_err_t os_mqueue_put(os_mqueue_t *mq, void *buffer, size_t size)
  */
 os_err_t os_mqueue_put_urgent(os_mqueue_t *mq, void *buffer, size_t size)
 {
-    os_sr_t sr;
-    os_mqueue_msg_t *msg;
+    os_err_t err;
+    void *msg;
 
     OS_ASSERT(mq != NULL);
     OS_ASSERT(buffer != NULL);
@@ -203,69 +270,30 @@ os_err_t os_mqueue_put_urgent(os_mqueue_t *mq, void *buffer, size_t size)
     if (size > mq->msg_size)
         return OS_ERROR;
 
-    sr = os_enter_critical();
-
-    /* get a free list, there must be an empty item */
-    msg = (os_mqueue_msg_t *)mq->msg_queue_free;
-    /* message queue is full */
-    if (msg == NULL) {
-        os_exit_critical(sr);
-
-        return OS_EFULL;
-    }
-    /* move free list pointer */
-    mq->msg_queue_free = msg->next;
-
-    os_exit_critical(sr);
+    err = os_mqueue_reserve(mq, &msg);
+    if (err != OS_OK)
+        return err;
 
     /* copy buffer */
-    memcpy(msg + 1, buffer, size);
-
-    sr = os_enter_critical();
-
-    /* link msg to the beginning of message queue */
-    msg->next = mq->msg_queue_head;
-    mq->msg_queue_head = msg;
-
-    /* if there is no tail */
-    if (mq->msg_queue_tail == NULL)
-        mq->msg_queue_tail = msg;
-
-    /* increase message entry */
-    mq->entry++;
-
-    /* resume suspended task */
-    if (!os_list_isempty(&mq->pending_list)) {
-        os_list_resume(&(mq->pending_list));
-
-        os_exit_critical(sr);
+    memcpy(msg, buffer, size);
 
-        os_sched();
-
-        return OS_OK;
-    }
-
-    os_exit_critical(sr);
+    _os_mqueue_link(mq, (os_mqueue_msg_t *)msg - 1, TRUE);
 
     return OS_OK;
 }
 
 /**
- * This function will receive a message from message queue object, if there is
- * no message in message queue object, the task shall wait for a specified
- * time.
+ * This function will receive a message from message queue object without
+ * copy, if there is no message in message queue object, the task shall wait
+ * for a specified time. The message must be given back by os_mqueue_release.
  *
  * @param mq the message queue object
- * @param buffer the received message will be saved in
- * @param size the size of buffer
+ * @param buffer the received message, valid until released
  * @param timeout the waiting time
  *
  * @return the error code
  */
-os_err_t os_mqueue_get(os_mqueue_t *mq,
-                    void      *buffer,
-                    size_t  size,
-                    os_tick_t timeout)
+os_err_t os_mqueue_recv_borrow(os_mqueue_t *mq, void **buffer, os_tick_t timeout)
 {
     os_task_t *task;
     os_sr_t sr;
@@ -274,7 +302,6 @@ os_err_t os_mqueue_get(os_mqueue_t *mq,
 
     OS_ASSERT(mq != NULL);
     OS_ASSERT(buffer != NULL);
-    OS_ASSERT(size != 0);
 
     /* get current task */
     task = os_task_self();
@@ -305,7 +332,7 @@ os_err_t os_mqueue_get(os_mqueue_t *mq,
         }
 
         /* suspend current task */
-        os_list_suspend(&(mq->pending_list),
+        os_waitq_suspend(&(mq->pending_list),
                             task,
                             mq->flag);
 
@@ -360,8 +387,29 @@ os_err_t os_mqueue_get(os_mqueue_t *mq,
 
     os_exit_critical(sr);
 
-    /* copy message */
-    memcpy(buffer, msg + 1, size > mq->msg_size ? mq->msg_size : size);
+    *buffer = msg + 1;
+
+    return OS_OK;
+}
+
+/**
+ * This function will give back a borrowed or reserved message to the free
+ * list of message queue object.
+ *
+ * @param mq the message queue object
+ * @param buffer the message returned by os_mqueue_recv_borrow
+ *
+ * @return the error code
+ */
+os_err_t os_mqueue_release(os_mqueue_t *mq, void *buffer)
+{
+    os_sr_t sr;
+    os_mqueue_msg_t *msg;
+
+    OS_ASSERT(mq != NULL);
+    OS_ASSERT(buffer != NULL);
+
+    msg = (os_mqueue_msg_t *)buffer - 1;
 
     sr = os_enter_critical();
     /* put message to free list */
@@ -372,6 +420,40 @@ os_err_t os_mqueue_get(os_mqueue_t *mq,
     return OS_OK;
 }
 
+/**
+ * This function will receive a message from message queue object, if there is
+ * no message in message queue object, the task shall wait for a specified
+ * time.
+ *
+ * @param mq the message queue object
+ * @param buffer the received message will be saved in
+ * @param size the size of buffer
+ * @param timeout the waiting time
+ *
+ * @return the error code
+ */
+os_err_t os_mqueue_get(os_mqueue_t *mq,
+                    void      *buffer,
+                    size_t  size,
+                    os_tick_t timeout)
+{
+    os_err_t err;
+    void *msg;
+
+    OS_ASSERT(mq != NULL);
+    OS_ASSERT(buffer != NULL);
+    OS_ASSERT(size != 0);
+
+    err = os_mqueue_recv_borrow(mq, &msg, timeout);
+    if (err != OS_OK)
+        return err;
+
+    /* copy message */
+    memcpy(buffer, msg, size > mq->msg_size ? mq->msg_size : size);
+
+    return os_mqueue_release(mq, msg);
+}
+
 /**
  * This function can get or set some extra attributions of a message queue
  * object.
@@ -391,7 +473,7 @@ os_err_t os_mqueue_reset(os_mqueue_t *mq, void *arg)
     sr = os_enter_critical();
 
     /* resume all waiting task */
-    os_list_resume_all(&mq->pending_list);
+    os_waitq_resume_all(&mq->pending_list);
 
     /* release all message in the queue */
     while (mq->msg_queue_head != NULL) {
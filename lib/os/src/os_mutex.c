@@ -20,10 +20,175 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-09-14     Grissiom     add an option check in os_event_get
+ * 2026-10-17     kontais      transitive priority inheritance, restore on timeout
+ * 2026-10-17     kontais      pend on os_waitq
+ * 2026-10-17     kontais      uncontended take and release without critical section
+ * 2026-10-17     kontais      lend priority by os_task_priority_inherit
+ * 2026-10-17     kontais      the pending order is kept by os_task_priority_inherit
+ * 2026-10-17     kontais      a priority ceiling mutex held keeps its ceiling
  */
 
 #include <os.h>
 
+/*
+ * An uncontended mutex only changes its owner. With exclusive access it is
+ * done without disabling interrupt, or else in a short critical section. The
+ * mutex taken so is put to the mutex list of owner by the first task pending
+ * on it, the release of a mutex on that list goes the slow way.
+ */
+#if defined(OS_ARCH_EXCLUSIVE) && !defined(OS_CFG_SMP)
+/* let a task own a free mutex, FALSE if it has an owner */
+static bool_t _os_mutex_fast_take(os_mutex_t *mutex, os_task_t *task)
+{
+    do {
+        if (os_arch_ldrex((volatile uint32_t *)&mutex->owner) != 0) {
+            os_arch_clrex();
+
+            return FALSE;
+        }
+    } while (os_arch_strex((uint32_t)task,
+                           (volatile uint32_t *)&mutex->owner) != 0);
+
+    return TRUE;
+}
+
+/* free a mutex nobody waits for, FALSE if a task may wait */
+static bool_t _os_mutex_fast_release(os_mutex_t *mutex)
+{
+    do {
+        os_arch_ldrex((volatile uint32_t *)&mutex->owner);
+        if (os_waitq_pending(&(mutex->pending_list)) ||
+            !os_list_isempty(&(mutex->list))) {
+            os_arch_clrex();
+
+            return FALSE;
+        }
+    } while (os_arch_strex(0, (volatile uint32_t *)&mutex->owner) != 0);
+
+    return TRUE;
+}
+#else
+/* let a task own a free mutex, FALSE if it has an owner */
+static bool_t _os_mutex_fast_take(os_mutex_t *mutex, os_task_t *task)
+{
+    bool_t taken = FALSE;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    if (mutex->owner == NULL) {
+        mutex->owner = task;
+        taken = TRUE;
+    }
+
+    os_exit_critical(sr);
+
+    return taken;
+}
+
+/* free a mutex nobody waits for, FALSE if a task may wait */
+static bool_t _os_mutex_fast_release(os_mutex_t *mutex)
+{
+    bool_t released = FALSE;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    if (!os_waitq_pending(&(mutex->pending_list)) &&
+        os_list_isempty(&(mutex->list))) {
+        mutex->owner = NULL;
+        released = TRUE;
+    }
+
+    os_exit_critical(sr);
+
+    return released;
+}
+#endif
+
+/* return the highest priority of pending tasks, irq must be disabled */
+static uint8_t _os_mutex_pending_priority(os_mutex_t *mutex)
+{
+    os_task_t *task;
+    uint8_t priority;
+
+    task = os_waitq_first(&(mutex->pending_list));
+
+    /* a PRIOed mutex resumes the highest priority first */
+    if (mutex->flag == OS_IPC_PRIO)
+        return task != NULL ? task->current_priority : 0xff;
+
+    priority = 0xff;
+    for (; task != NULL; task = os_waitq_next(&(mutex->pending_list), task)) {
+        if (task->current_priority < priority)
+            priority = task->current_priority;
+    }
+
+    return priority;
+}
+
+/*
+ * This function will recompute the priority of a task from its own priority,
+ * the ceiling of priority ceiling mutexes and the mutexes it holds. When a pending task changes priority, the change
+ * goes on along the chain of mutex owners.
+ *
+ * @param task the task to be updated
+ *
+ * @note this function shall be invoked with interrupt disabled.
+ */
+void os_mutex_priority_update(os_task_t *task)
+{
+    os_list_t *node;
+    os_mutex_t *mutex;
+    uint8_t priority;
+
+    while (task != NULL) {
+        priority = task->init_priority;
+        if (task->ceiling_priority < priority)
+            priority = task->ceiling_priority;
+        for (node = task->mutex_list.next;
+             node != &(task->mutex_list);
+             node = node->next) {
+            mutex = OS_LIST_ENTRY(node, os_mutex_t, list);
+            if (mutex->priority < priority)
+                priority = mutex->priority;
+        }
+
+        /* the chain stops where nothing changes */
+        if (priority == task->current_priority)
+            break;
+
+        OS_DEBUG_LOG(OS_DEBUG_IPC, ("mutex: task %s priority %d -> %d\n",
+                                    task->name, task->current_priority,
+                                    priority));
+
+        os_task_priority_inherit(task, priority);
+
+        mutex = task->pending_mutex;
+        if (mutex == NULL)
+            break;
+
+        /* the pending order is kept already, pass the change to owner */
+        mutex->priority = _os_mutex_pending_priority(mutex);
+
+        task = mutex->owner;
+    }
+}
+
+/* let a task own the mutex, irq must be disabled */
+static void _os_mutex_own(os_mutex_t *mutex, os_task_t *task)
+{
+    mutex->owner    = task;
+    mutex->priority = _os_mutex_pending_priority(mutex);
+    mutex->hold     = 1;
+
+    task->pending_mutex = NULL;
+    os_list_insert_after(&(task->mutex_list), &(mutex->list));
+
+    /* the new owner inherits from the tasks still pending */
+    os_mutex_priority_update(task);
+}
+
 /**
  * This function will initialize a mutex and put it under control of resource
  * management.
@@ -39,12 +204,12 @@ os_err_t os_mutex_init(os_mutex_t *mutex, uint8_t flag)
     OS_ASSERT(mutex != NULL);
 
     /* init ipc object */
-    os_list_init(&(mutex->pending_list));
+    os_waitq_init(&(mutex->pending_list));
+    os_list_init(&(mutex->list));
 
-    mutex->value = 1;
-    mutex->owner = NULL;
-    mutex->original_priority = 0xFF;
-    mutex->hold  = 0;
+    mutex->owner    = NULL;
+    mutex->priority = 0xFF;
+    mutex->hold     = 0;
 
     /* set flag */
     mutex->flag = flag;
@@ -62,10 +227,35 @@ os_err_t os_mutex_init(os_mutex_t *mutex, uint8_t flag)
  */
 os_err_t os_mutex_delete(os_mutex_t *mutex)
 {
+    os_sr_t sr;
+    os_task_t *task;
+    os_task_t *owner;
+
     OS_ASSERT(mutex != NULL);
 
+    sr = os_enter_critical();
+
+    /* the pending tasks no longer wait for this mutex */
+    for (task = os_waitq_first(&(mutex->pending_list));
+         task != NULL;
+         task = os_waitq_next(&(mutex->pending_list), task)) {
+        task->pending_mutex = NULL;
+    }
+
+    /* the owner gives back the priority it inherited */
+    owner = mutex->owner;
+    if (owner != NULL) {
+        os_list_remove(&(mutex->list));
+        mutex->owner    = NULL;
+        mutex->priority = 0xFF;
+
+        os_mutex_priority_update(owner);
+    }
+
+    os_exit_critical(sr);
+
     /* wakeup all suspend tasks */
-    os_list_resume_all(&(mutex->pending_list));
+    os_waitq_resume_all(&(mutex->pending_list));
 
     return OS_OK;
 }
@@ -92,35 +282,35 @@ os_err_t os_mutex_take(os_mutex_t *mutex, os_tick_t timeout)
     /* get current task */
     task = os_task_self();
 
-    sr = os_enter_critical();
-
-    OS_DEBUG_LOG(OS_DEBUG_IPC,
-                 ("mutex_take: current task %s, mutex value: %d, hold: %d\n",
-                  task->name, mutex->value, mutex->hold));
-
     /* reset task error */
     task->error = OS_OK;
 
-    /* it's the same task */
+    /* it's the same task, only owner changes hold */
     if (mutex->owner == task) {
         mutex->hold++;
 
-        os_exit_critical(sr);
+        return OS_OK;
+    }
+
+    /* mutex is free, no critical section */
+    if (_os_mutex_fast_take(mutex, task)) {
+        mutex->hold = 1;
 
         return OS_OK;
     }
 
-    /* The value of mutex is 1 in initial status. Therefore, if the
-     * value is great than 0, it indicates the mutex is avaible.
-     */
-    if (mutex->value > 0) {
-        /* mutex is available */
-        mutex->value--;
+    sr = os_enter_critical();
 
-        /* set mutex owner and original priority */
-        mutex->owner             = task;
-        mutex->original_priority = task->current_priority;
-        mutex->hold++;
+    OS_DEBUG_LOG(OS_DEBUG_IPC,
+                 ("mutex_take: current task %s, mutex owner: %s, hold: %d\n",
+                  task->name,
+                  mutex->owner != NULL ? mutex->owner->name : "none",
+                  mutex->hold));
+
+    /* released since the fast way failed */
+    if (mutex->owner == NULL) {
+        /* set mutex owner */
+        _os_mutex_own(mutex, task);
 
         os_exit_critical(sr);
 
@@ -142,16 +332,21 @@ os_err_t os_mutex_take(os_mutex_t *mutex, os_tick_t timeout)
     OS_DEBUG_LOG(OS_DEBUG_IPC, ("mutex_take: suspend task: %s\n",
                                 task->name));
 
-    /* change the owner task priority of mutex */
-    if (task->current_priority < mutex->owner->current_priority) {
-        /* change the owner task priority */
-        os_task_priority_set(mutex->owner, task->current_priority);
-    }
-
     /* suspend current task */
-    os_list_suspend(&(mutex->pending_list),
+    os_waitq_suspend(&(mutex->pending_list),
                         task,
                         mutex->flag);
+    task->pending_mutex = mutex;
+
+    /* a mutex taken the fast way joins the mutex list of owner now */
+    if (os_list_isempty(&(mutex->list)))
+        os_list_insert_after(&(mutex->owner->mutex_list), &(mutex->list));
+
+    /* lend the priority to owner, and to the owners it waits for */
+    if (task->current_priority < mutex->priority) {
+        mutex->priority = task->current_priority;
+        os_mutex_priority_update(mutex->owner);
+    }
 
     /* no wait forever, start task timer */
     if (timeout != OS_WAIT_FOREVER) {
@@ -184,6 +379,7 @@ os_err_t os_mutex_release(os_mutex_t *mutex)
 {
     os_sr_t sr;
     os_task_t *task;
+    os_task_t *owner;
     bool_t need_schedule;
 
     need_schedule = FALSE;
@@ -192,17 +388,30 @@ os_err_t os_mutex_release(os_mutex_t *mutex)
     OS_DEBUG_IN_TASK_CONTEXT;
 
     /* get current task */
-    task = os_task_self();
+    owner = os_task_self();
+
+    if (mutex->owner == owner) {
+        /* still held, only owner changes hold */
+        if (mutex->hold > 1) {
+            mutex->hold--;
+
+            return OS_OK;
+        }
+
+        /* nobody waits, no critical section */
+        if (_os_mutex_fast_release(mutex))
+            return OS_OK;
+    }
 
     OS_DEBUG_LOG(OS_DEBUG_IPC,
-                 ("mutex_release:current task %s, mutex value: %d, hold: %d\n",
-                  task->name, mutex->value, mutex->hold));
+                 ("mutex_release:current task %s, hold: %d\n",
+                  owner->name, mutex->hold));
 
     sr = os_enter_critical();
 
     /* mutex only can be released by owner */
-    if (mutex->owner != task) {
-        task->error = OS_ERROR;
+    if (mutex->owner != owner) {
+        owner->error = OS_ERROR;
 
         os_exit_critical(sr);
 
@@ -213,37 +422,33 @@ os_err_t os_mutex_release(os_mutex_t *mutex)
     mutex->hold--;
     /* if no hold */
     if (mutex->hold == 0) {
-        /* change the owner task to original priority */
-        if (mutex->original_priority != mutex->owner->current_priority) {
-            os_task_priority_set(mutex->owner, mutex->original_priority);
-        }
+        /* the mutex no longer lends priority to owner */
+        os_list_remove(&(mutex->list));
 
         /* wakeup suspended task */
-        if (!os_list_isempty(&mutex->pending_list)) {
-            /* get suspended task */
-            task = OS_LIST_ENTRY(mutex->pending_list.next,
-                                   os_task_t,
-                                   tlist);
-
+        task = os_waitq_first(&(mutex->pending_list));
+        if (task != NULL) {
             OS_DEBUG_LOG(OS_DEBUG_IPC, ("mutex_release: resume task: %s\n",
                                         task->name));
 
-            /* set new owner and priority */
-            mutex->owner             = task;
-            mutex->original_priority = task->current_priority;
-            mutex->hold++;
-
             /* resume task */
-            os_list_resume(&(mutex->pending_list));
+            os_waitq_resume(&(mutex->pending_list));
+
+            /* set new owner, it inherits from the rest */
+            _os_mutex_own(mutex, task);
 
             need_schedule = TRUE;
         } else {
-            /* increase value */
-            mutex->value++;
-
             /* clear owner */
-            mutex->owner             = NULL;
-            mutex->original_priority = 0xff;
+            mutex->owner    = NULL;
+            mutex->priority = 0xff;
+        }
+
+        /* change the owner task to the priority of the rest it holds */
+        if (owner->current_priority != owner->init_priority) {
+            os_mutex_priority_update(owner);
+
+            need_schedule = TRUE;
         }
     }
 
@@ -255,3 +460,28 @@ os_err_t os_mutex_release(os_mutex_t *mutex)
 
     return OS_OK;
 }
+
+/*
+ * This function will remove a timed out task from the pending tasks of its
+ * mutex, and restore the priority of owner chain at once, instead of when
+ * the owner releases the mutex.
+ *
+ * @param task the task timed out, already removed from pending list
+ *
+ * @note this function is invoked by task timeout with interrupt disabled.
+ */
+void os_mutex_pend_abort(os_task_t *task)
+{
+    os_mutex_t *mutex;
+
+    mutex = task->pending_mutex;
+    task->pending_mutex = NULL;
+
+    OS_DEBUG_LOG(OS_DEBUG_IPC, ("mutex: task %s pending aborted\n",
+                                task->name));
+
+    if (mutex->priority == task->current_priority) {
+        mutex->priority = _os_mutex_pending_priority(mutex);
+        os_mutex_priority_update(mutex->owner);
+    }
+}
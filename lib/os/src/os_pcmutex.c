@@ -0,0 +1,210 @@
+/*
+ * File      : os_pcmutex.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      raise to ceiling by os_task_priority_inherit
+ * 2026-10-17     kontais      keep the base priority, restore the ceiling LIFO
+ */
+
+#include <os.h>
+
+/**
+ * @addtogroup IPC
+ */
+
+/*@{*/
+
+/**
+ * This function will initialize a priority ceiling mutex.
+ *
+ * The mutex is deadlock free and never blocks on a single core when:
+ * - the ceiling is no lower than the priority of every task locking it,
+ *   and at most one of them runs at the ceiling priority itself, as time
+ *   slice may switch between tasks of the same priority,
+ * - the owner never suspends, sleeps or waits while holding it,
+ * - nested mutexes are unlocked in reverse order of locking.
+ * Only the owner is raised, so it fits short critical sections which do not
+ * need interrupt disabled.
+ *
+ * @param mutex the priority ceiling mutex object
+ * @param ceiling the highest priority of tasks locking the mutex
+ *
+ * @return the operation status, OS_OK on successful
+ */
+os_err_t os_pcmutex_init(os_pcmutex_t *mutex, uint8_t ceiling)
+{
+    OS_ASSERT(mutex != NULL);
+    OS_ASSERT(ceiling < OS_TASK_PRIORITY_MAX);
+
+    mutex->ceiling        = ceiling;
+    mutex->saved_priority = 0xFF;
+    mutex->hold           = 0;
+    mutex->owner          = NULL;
+
+    return OS_OK;
+}
+
+/**
+ * This function will detach a priority ceiling mutex.
+ *
+ * @param mutex the priority ceiling mutex object
+ *
+ * @return the operation status, OS_OK on successful, OS_EBUSY if the mutex
+ *         is still held
+ */
+os_err_t os_pcmutex_delete(os_pcmutex_t *mutex)
+{
+    OS_ASSERT(mutex != NULL);
+
+    if (mutex->owner != NULL)
+        return OS_EBUSY;
+
+    return OS_OK;
+}
+
+/**
+ * This function will lock a priority ceiling mutex, the current task is
+ * raised to the ceiling at once. It never waits.
+ *
+ * @param mutex the priority ceiling mutex object
+ *
+ * @return the error code, OS_OK on successful, OS_EBUSY if the mutex is held
+ *         by another task, which breaks the rules of os_pcmutex_init
+ */
+os_err_t os_pcmutex_lock(os_pcmutex_t *mutex)
+{
+    os_sr_t sr;
+    os_task_t *task;
+
+    /* this function must not be used in interrupt */
+    OS_DEBUG_IN_TASK_CONTEXT;
+
+    OS_ASSERT(mutex != NULL);
+
+    /* get current task */
+    task = os_task_self();
+
+    /* a task above the ceiling breaks the protocol, nested ones are not */
+    OS_ASSERT(task->init_priority >= mutex->ceiling);
+
+    sr = os_enter_critical();
+
+    /* it's the same task */
+    if (mutex->owner == task) {
+        mutex->hold++;
+
+        os_exit_critical(sr);
+
+        return OS_OK;
+    }
+
+    if (mutex->owner != NULL) {
+        os_exit_critical(sr);
+
+        OS_DEBUG_LOG(OS_DEBUG_IPC, ("pcmutex_lock: held by task: %s\n",
+                                    mutex->owner->name));
+
+        return OS_EBUSY;
+    }
+
+    mutex->owner = task;
+    mutex->hold  = 1;
+
+    /* the ceiling held, inheritance never drops below it */
+    mutex->saved_priority = task->ceiling_priority;
+    if (mutex->ceiling < task->ceiling_priority)
+        task->ceiling_priority = mutex->ceiling;
+
+    /* raising the running task never needs a schedule */
+    if (mutex->ceiling < task->current_priority)
+        os_task_priority_inherit(task, mutex->ceiling);
+
+    os_exit_critical(sr);
+
+    return OS_OK;
+}
+
+/**
+ * This function will unlock a priority ceiling mutex, the owner goes back
+ * to its priority before lock, or to the priority it inherits.
+ *
+ * @param mutex the priority ceiling mutex object
+ *
+ * @return the error code, OS_OK on successful, OS_ERROR if current task is
+ *         not the owner
+ */
+os_err_t os_pcmutex_unlock(os_pcmutex_t *mutex)
+{
+    os_sr_t sr;
+    os_task_t *task;
+    uint8_t priority;
+
+    /* only task could unlock mutex because we need test the ownership */
+    OS_DEBUG_IN_TASK_CONTEXT;
+
+    OS_ASSERT(mutex != NULL);
+
+    /* get current task */
+    task = os_task_self();
+
+    sr = os_enter_critical();
+
+    /* mutex only can be unlocked by owner */
+    if (mutex->owner != task) {
+        os_exit_critical(sr);
+
+        return OS_ERROR;
+    }
+
+    mutex->hold--;
+    if (mutex->hold > 0) {
+        os_exit_critical(sr);
+
+        return OS_OK;
+    }
+
+    /* the mutexes nested are unlocked in reverse order of locking */
+    OS_ASSERT(task->ceiling_priority ==
+              (mutex->ceiling < mutex->saved_priority ?
+               mutex->ceiling : mutex->saved_priority));
+
+    mutex->owner = NULL;
+
+    /* the ceiling before lock, an outer one is still held */
+    priority = task->current_priority;
+    if (task->ceiling_priority != mutex->saved_priority) {
+        task->ceiling_priority = mutex->saved_priority;
+
+        /* no requeue unless the priority runs out of ceiling */
+        if (priority == mutex->ceiling)
+            os_mutex_priority_update(task);
+    }
+
+    os_exit_critical(sr);
+
+    /* a lowered task may be preempted */
+    if (task->current_priority != priority)
+        os_sched();
+
+    return OS_OK;
+}
+
+/*@}*/
@@ -0,0 +1,397 @@
+/*
+ * File      : os_ringbuf.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      order data and index with a memory barrier
+ * 2026-10-17     kontais      order index and data of a peek
+ */
+
+#include <os.h>
+
+/*
+ * the barrier between data and index. It is a dmb where the arch has one, the
+ * other side may run on another processor, on one processor the compiler
+ * barrier is enough.
+ */
+#ifdef OS_ARCH_MB
+#define _OS_RINGBUF_BARRIER()           os_arch_mb()
+#else
+#define _OS_RINGBUF_BARRIER()           COMPILER_BARRIER()
+#endif
+
+/* wake up the consumer task if it waits for data */
+static void _os_ringbuf_wakeup(os_ringbuf_t *rb)
+{
+    os_sr_t sr;
+    os_task_t *task;
+
+    sr = os_enter_critical();
+
+    task = rb->reader;
+    if (task != NULL) {
+        rb->reader = NULL;
+
+        /* the reader may have timed out already */
+        if (os_task_resume(task) != OS_OK)
+            task = NULL;
+    }
+
+    os_exit_critical(sr);
+
+    /* resume a task, re-schedule */
+    if (task != NULL) {
+        os_sched();
+    }
+}
+
+/**
+ * @addtogroup IPC
+ */
+
+/*@{*/
+
+/**
+ * This function will initialize a ring buffer.
+ *
+ * @param rb the ring buffer object
+ * @param pool the start address of ring buffer storage
+ * @param size the size of storage, must be power of two
+ *
+ * @return the operation status, OS_OK on successful, OS_ERROR if the size
+ *         is not power of two
+ */
+os_err_t os_ringbuf_init(os_ringbuf_t *rb, void *pool, uint32_t size)
+{
+    OS_ASSERT(rb != NULL);
+    OS_ASSERT(pool != NULL);
+
+    if (size == 0 || (size & (size - 1)) != 0)
+        return OS_ERROR;
+
+    rb->buffer = (uint8_t *)pool;
+    rb->mask   = size - 1;
+
+    rb->head   = 0;
+    rb->tail   = 0;
+    rb->reader = NULL;
+
+    return OS_OK;
+}
+
+/**
+ * This function will detach a ring buffer, the waiting consumer is waked up.
+ *
+ * @param rb the ring buffer object
+ *
+ * @return the operation status, OS_OK on successful
+ */
+os_err_t os_ringbuf_delete(os_ringbuf_t *rb)
+{
+    OS_ASSERT(rb != NULL);
+
+    _os_ringbuf_wakeup(rb);
+
+    return OS_OK;
+}
+
+/**
+ * This function will return the number of bytes in a ring buffer.
+ *
+ * @param rb the ring buffer object
+ *
+ * @return the bytes can be read
+ */
+uint32_t os_ringbuf_len(os_ringbuf_t *rb)
+{
+    return rb->head - rb->tail;
+}
+
+/**
+ * This function will return the free space of a ring buffer.
+ *
+ * @param rb the ring buffer object
+ *
+ * @return the bytes can be written
+ */
+uint32_t os_ringbuf_space(os_ringbuf_t *rb)
+{
+    return rb->mask + 1 - (rb->head - rb->tail);
+}
+
+/**
+ * This function will put one byte to a ring buffer.
+ *
+ * @param rb the ring buffer object
+ * @param ch the byte to be put
+ *
+ * @return the error code, OS_OK on successful, OS_EFULL if the ring buffer
+ *         is full
+ *
+ * @note this function can be invoked in interrupt service routine.
+ */
+os_err_t os_ringbuf_putc(os_ringbuf_t *rb, uint8_t ch)
+{
+    uint32_t head;
+
+    head = rb->head;
+    if (head - rb->tail > rb->mask)
+        return OS_EFULL;
+
+    rb->buffer[head & rb->mask] = ch;
+
+    /* publish the data before the index */
+    _OS_RINGBUF_BARRIER();
+    rb->head = head + 1;
+
+    if (rb->reader != NULL)
+        _os_ringbuf_wakeup(rb);
+
+    return OS_OK;
+}
+
+/**
+ * This function will write data to a ring buffer, as much as it can hold.
+ *
+ * @param rb the ring buffer object
+ * @param buffer the data to be written
+ * @param size the size of data
+ *
+ * @return the bytes written
+ *
+ * @note this function can be invoked in interrupt service routine.
+ */
+uint32_t os_ringbuf_write(os_ringbuf_t *rb, const void *buffer, uint32_t size)
+{
+    uint32_t head;
+    uint32_t space;
+    uint32_t offset;
+    uint32_t part;
+
+    head  = rb->head;
+    space = rb->mask + 1 - (head - rb->tail);
+    if (size > space)
+        size = space;
+    if (size == 0)
+        return 0;
+
+    /* copy in two parts when it wraps */
+    offset = head & rb->mask;
+    part   = rb->mask + 1 - offset;
+    if (part > size)
+        part = size;
+
+    memcpy(&rb->buffer[offset], buffer, part);
+    memcpy(&rb->buffer[0], (const uint8_t *)buffer + part, size - part);
+
+    /* publish the data before the index */
+    _OS_RINGBUF_BARRIER();
+    rb->head = head + size;
+
+    if (rb->reader != NULL)
+        _os_ringbuf_wakeup(rb);
+
+    return size;
+}
+
+/**
+ * This function will reserve the contiguous free space of a ring buffer,
+ * the producer writes it in place then invokes os_ringbuf_commit.
+ *
+ * @param rb the ring buffer object
+ * @param ptr the start address of the free span
+ *
+ * @return the size of the free span, it may be less than the free space
+ *         when the ring buffer wraps
+ */
+uint32_t os_ringbuf_reserve(os_ringbuf_t *rb, uint8_t **ptr)
+{
+    uint32_t head;
+    uint32_t space;
+    uint32_t part;
+
+    OS_ASSERT(ptr != NULL);
+
+    head  = rb->head;
+    space = rb->mask + 1 - (head - rb->tail);
+    part  = rb->mask + 1 - (head & rb->mask);
+
+    *ptr = &rb->buffer[head & rb->mask];
+
+    return part < space ? part : space;
+}
+
+/**
+ * This function will commit the data written to a reserved span.
+ *
+ * @param rb the ring buffer object
+ * @param size the size of data written, no more than reserved
+ */
+void os_ringbuf_commit(os_ringbuf_t *rb, uint32_t size)
+{
+    OS_ASSERT(size <= os_ringbuf_space(rb));
+
+    if (size == 0)
+        return;
+
+    /* publish the data before the index */
+    _OS_RINGBUF_BARRIER();
+    rb->head += size;
+
+    if (rb->reader != NULL)
+        _os_ringbuf_wakeup(rb);
+}
+
+/**
+ * This function will read data from a ring buffer, if the ring buffer is
+ * empty, the task shall wait for a specified time.
+ *
+ * @param rb the ring buffer object
+ * @param buffer the buffer to save data
+ * @param size the size of buffer
+ * @param timeout the waiting time
+ *
+ * @return the bytes read, 0 on timeout
+ */
+uint32_t os_ringbuf_read(os_ringbuf_t *rb,
+                         void      *buffer,
+                         uint32_t   size,
+                         os_tick_t  timeout)
+{
+    os_sr_t sr;
+    os_task_t *task;
+    uint32_t tail;
+    uint32_t len;
+    uint32_t offset;
+    uint32_t part;
+
+    OS_ASSERT(rb != NULL);
+
+    if (rb->head == rb->tail && timeout != OS_NO_WAIT) {
+        /* current context checking */
+        OS_DEBUG_IN_TASK_CONTEXT;
+
+        /* get current task */
+        task = os_task_self();
+
+        sr = os_enter_critical();
+
+        /* re-check, the producer may not take the critical section */
+        if (rb->head == rb->tail) {
+            /* reset task error */
+            task->error = OS_OK;
+
+            OS_ASSERT(rb->reader == NULL);
+            rb->reader = task;
+
+            /* no pending list, the producer resumes the task directly */
+            os_task_suspend(task);
+
+            /* no wait forever, start task timer */
+            if (timeout != OS_WAIT_FOREVER) {
+                /* reset the timeout of task timer and start it */
+                os_timer_tick_set(&(task->timer), timeout);
+                os_timer_start(&(task->timer));
+            }
+
+            os_exit_critical(sr);
+
+            /* do schedule */
+            os_sched();
+
+            sr = os_enter_critical();
+            rb->reader = NULL;
+        }
+
+        os_exit_critical(sr);
+    }
+
+    tail = rb->tail;
+    len  = rb->head - tail;
+    if (size > len)
+        size = len;
+    if (size == 0)
+        return 0;
+
+    /* observe the index before the data */
+    _OS_RINGBUF_BARRIER();
+
+    /* copy in two parts when it wraps */
+    offset = tail & rb->mask;
+    part   = rb->mask + 1 - offset;
+    if (part > size)
+        part = size;
+
+    memcpy(buffer, &rb->buffer[offset], part);
+    memcpy((uint8_t *)buffer + part, &rb->buffer[0], size - part);
+
+    /* finish reading before the index frees the space */
+    _OS_RINGBUF_BARRIER();
+    rb->tail = tail + size;
+
+    return size;
+}
+
+/**
+ * This function will peek the contiguous data of a ring buffer, the
+ * consumer reads it in place then invokes os_ringbuf_release.
+ *
+ * @param rb the ring buffer object
+ * @param ptr the start address of the data span
+ *
+ * @return the size of the data span, it may be less than the data in
+ *         ring buffer when it wraps
+ */
+uint32_t os_ringbuf_peek(os_ringbuf_t *rb, uint8_t **ptr)
+{
+    uint32_t tail;
+    uint32_t len;
+    uint32_t part;
+
+    OS_ASSERT(ptr != NULL);
+
+    tail = rb->tail;
+    len  = rb->head - tail;
+    part = rb->mask + 1 - (tail & rb->mask);
+
+    /* observe the index before the caller reads the data */
+    _OS_RINGBUF_BARRIER();
+
+    *ptr = &rb->buffer[tail & rb->mask];
+
+    return part < len ? part : len;
+}
+
+/**
+ * This function will release the data consumed from a peeked span.
+ *
+ * @param rb the ring buffer object
+ * @param size the size of data consumed, no more than peeked
+ */
+void os_ringbuf_release(os_ringbuf_t *rb, uint32_t size)
+{
+    OS_ASSERT(size <= os_ringbuf_len(rb));
+
+    /* finish reading before the index frees the space */
+    _OS_RINGBUF_BARRIER();
+    rb->tail += size;
+}
+
+/*@}*/
@@ -20,14 +20,30 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-12-21     Grissiom     add os_critical_level
+ * 2026-10-17     kontais      cache the highest priority ready task
+ * 2026-10-17     kontais      add cpu usage accounting
+ * 2026-10-17     kontais      order earliest deadline first band by deadline
+ * 2026-10-17     kontais      leave overflow check to mpu stack guard
+ * 2026-10-17     kontais      trace context switch
+ * 2026-10-17     kontais      hand over fpu on switch
+ * 2026-10-17     kontais      add symmetric multi processing
+ * 2026-10-17     kontais      charge the outgoing task before current changes
+ * 2026-10-17     kontais      pick through the ready group and bitmaps
  */
 
 #include <os.h>
 
+#ifdef OS_CFG_SMP
+/* the scheduler lock and current task are per processor, see os_smp.h */
+#define os_sched_lock_nest  (os_cpu_self()->sched_lock_nest)
+#else
 static int16_t os_sched_lock_nest;
+#endif
 
 os_list_t os_ready_task_priority_list[OS_TASK_PRIORITY_MAX];
+#ifndef OS_CFG_SMP
 os_task_t *os_current_task;
+#endif
 
 #if OS_TASK_PRIORITY_MAX > 32
 /* Maximum priority level, 256 */
@@ -40,7 +56,165 @@ uint32_t os_ready_task_bitmap;
 
 os_list_t os_defunct_task_list = OS_LIST_INIT(os_defunct_task_list);
 
-#ifdef OS_CFG_OVERFLOW_CHECK
+/* the highest priority ready task, kept up to date by insert and remove */
+static os_task_t *os_sched_next_task;
+
+#ifdef OS_CFG_TASK_STATS
+/* cycle counter at the last accounting, and cycles accounted since start */
+static uint32_t os_sched_stamp;
+static uint64_t os_sched_cycles;
+#endif
+
+/* look up the highest priority ready task from the ready bitmap */
+static os_task_t *_os_sched_highest_ready(void)
+{
+    uint32_t highest_ready_priority;
+
+#if OS_TASK_PRIORITY_MAX > 32
+    uint8_t group;
+
+    if (os_ready_task_group == 0)
+        return NULL;
+
+    group = __ffs(os_ready_task_group) - 1;
+    highest_ready_priority = (group << 5) + __ffs(os_ready_task_bitmap[group]) - 1;
+#else
+    if (os_ready_task_bitmap == 0)
+        return NULL;
+
+    highest_ready_priority = __ffs(os_ready_task_bitmap) - 1;
+#endif
+
+    return OS_LIST_ENTRY(os_ready_task_priority_list[highest_ready_priority].next,
+                         os_task_t,
+                         tlist);
+}
+
+#ifdef OS_CFG_SCHED_EDF
+/*
+ * insert a task to earliest deadline first band, before any later deadline.
+ * A fixed priority task only gets here by inheritance, it blocks an earlier
+ * deadline, so it goes first.
+ */
+static void _os_sched_edf_insert(os_task_t *task)
+{
+    os_list_t *list;
+    os_list_t *node;
+
+    list = &(os_ready_task_priority_list[OS_SCHED_EDF_PRIO]);
+    if (task->edf_period == 0) {
+        os_list_insert_after(list, &(task->tlist));
+
+        return;
+    }
+
+    for (node = list->next; node != list; node = node->next) {
+        if ((int32_t)(task->edf_abs_deadline -
+                      OS_LIST_ENTRY(node, os_task_t, tlist)->edf_abs_deadline) < 0)
+            break;
+    }
+
+    os_list_insert_before(node, &(task->tlist));
+}
+#endif
+
+#ifdef OS_CFG_SMP
+/* a task may run on the processor if it is allowed and not running elsewhere */
+#define _OS_SCHED_RUNNABLE(task, cpu)                                    \
+    (((task)->cpu_affinity & (1UL << (cpu))) &&                         \
+     ((task)->oncpu == OS_CPU_NONE || (task)->oncpu == (cpu)))
+
+/*
+ * look up the highest priority task a processor may run among 32 priorities
+ * from base, only the ready ones set in bitmap are visited.
+ */
+static os_task_t *_os_sched_pick_word(uint32_t base, uint32_t bitmap, uint32_t cpu)
+{
+    os_list_t *list;
+    os_list_t *node;
+    os_task_t *task;
+
+    for (; bitmap != 0; bitmap &= bitmap - 1) {
+        list = &(os_ready_task_priority_list[base + __ffs(bitmap) - 1]);
+        for (node = list->next; node != list; node = node->next) {
+            task = OS_LIST_ENTRY(node, os_task_t, tlist);
+            if (_OS_SCHED_RUNNABLE(task, cpu))
+                return task;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * This function will look up the highest priority ready task for a
+ * processor, a task kept by its affinity or running on another processor
+ * is passed over. irq must be disabled.
+ *
+ * @param cpu the processor id
+ *
+ * @return the task to run, NULL if there is none
+ */
+os_task_t *os_sched_pick(uint32_t cpu)
+{
+#if OS_TASK_PRIORITY_MAX > 32
+    os_task_t *task;
+    uint32_t group_bits;
+    uint32_t group;
+
+    /* the groups with ready tasks, then the ready priorities of each */
+    for (group_bits = os_ready_task_group; group_bits != 0;
+         group_bits &= group_bits - 1) {
+        group = __ffs(group_bits) - 1;
+        task  = _os_sched_pick_word(group << 5, os_ready_task_bitmap[group], cpu);
+        if (task != NULL)
+            return task;
+    }
+
+    return NULL;
+#else
+    return _os_sched_pick_word(0, os_ready_task_bitmap, cpu);
+#endif
+}
+
+/*
+ * This function will ask a processor to schedule for a ready task. Current
+ * processor schedules by itself when it is allowed to run the task, else
+ * one running lower priority is interrupted. irq must be disabled.
+ */
+static void _os_sched_smp_kick(os_task_t *task)
+{
+    os_task_t *current;
+    uint32_t self;
+    uint32_t cpu;
+
+    /* a running task is put back to ready queue, nothing to do */
+    if (task->oncpu != OS_CPU_NONE)
+        return;
+
+    self = os_arch_cpu_id();
+
+    current = os_cpus[self].current_task;
+    if ((task->cpu_affinity & (1UL << self)) &&
+        (current == NULL || task->current_priority < current->current_priority))
+        return;
+
+    for (cpu = 0; cpu < OS_CPUS_NR; cpu++) {
+        if (cpu == self || !(task->cpu_affinity & (1UL << cpu)))
+            continue;
+
+        current = os_cpus[cpu].current_task;
+        if (current == NULL || task->current_priority < current->current_priority) {
+            os_arch_ipi_send(1UL << cpu);
+
+            return;
+        }
+    }
+}
+#endif
+
+/* the mpu stack guard traps an overflow at once, the check is left to it */
+#if defined(OS_CFG_OVERFLOW_CHECK) && !defined(OS_CFG_STACK_GUARD)
 static void _os_sched_stack_check(os_task_t *task)
 {
     OS_ASSERT(task != NULL);
@@ -80,6 +254,7 @@ void os_sched_init(void)
     }
 
     os_current_task     = NULL;
+    os_sched_next_task  = NULL;
 
 #if OS_TASK_PRIORITY_MAX > 32
     /* initialize ready priority group */
@@ -99,24 +274,48 @@ void os_sched_init(void)
 void os_sched_start(void)
 {
     register os_task_t *to_task;
-    uint32_t highest_ready_priority;
 
-#if OS_TASK_PRIORITY_MAX > 32
-    uint8_t group;
+#ifdef OS_CFG_SMP
+    /* the kernel lock goes with the first task, it releases the lock */
+    os_enter_critical();
 
-    group = __ffs(os_ready_task_group) - 1;
-    highest_ready_priority = (group << 5) + __ffs(os_ready_task_bitmap[group]) - 1;
-#else
-    highest_ready_priority = __ffs(os_ready_task_bitmap) - 1;
-#endif
+    to_task = os_sched_pick(os_arch_cpu_id());
+    OS_ASSERT(to_task != NULL);
 
+    to_task->oncpu = os_arch_cpu_id();
+#else
     /* get switch to task */
-    to_task = OS_LIST_ENTRY(os_ready_task_priority_list[highest_ready_priority].next,
-                              os_task_t,
-                              tlist);
+    to_task = os_sched_next_task;
+    OS_ASSERT(to_task != NULL);
+#endif
 
     os_current_task = to_task;
 
+#ifdef OS_CFG_STACK_GUARD
+    os_arch_stack_guard_init(to_task->stack_addr);
+#endif
+
+#ifdef OS_CFG_TASK_FPU
+    os_arch_fpu_init();
+    os_arch_fpu_switch(to_task);
+#endif
+
+#if defined(OS_CFG_TASK_STATS) || defined(OS_CFG_TRACE)
+    os_arch_cycle_init();
+#endif
+
+#ifdef OS_CFG_TASK_STATS
+    os_sched_stamp = os_arch_cycle_get();
+    to_task->stats.run_switches++;
+#endif
+
+    OS_TRACE(OS_TRACE_SWITCH, to_task->current_priority, to_task, NULL);
+
+#ifdef OS_CFG_SMP
+    /* secondary processors wait for the kernel lock till the switch */
+    os_arch_secondary_cpu_up();
+#endif
+
     /* switch to new task */
     os_arch_context_switch_to((uint32_t)&to_task->sp);
 
@@ -129,39 +328,100 @@ void os_sched_start(void)
 
 /*@{*/
 
+#ifdef OS_CFG_SMP
 /**
- * This function will perform one schedule. It will select one task
- * with the highest priority level, then switch to it.
+ * This function will perform one schedule on current processor. It will
+ * select the highest priority task allowed here, then switch to it. In
+ * interrupt the schedule is put off till interrupt exit.
  */
 void os_sched(void)
 {
     os_sr_t sr;
+    os_cpu_t *cpu;
     os_task_t *to_task;
     os_task_t *from_task;
+    uint32_t nest;
 
-    sr = os_enter_critical();
+    sr  = os_enter_critical();
+    cpu = os_cpu_self();
+
+    if (cpu->isr_nest != 0) {
+        cpu->need_sched = 1;
+        os_exit_critical(sr);
+
+        return;
+    }
 
     /* check the scheduler is enabled or not */
-    if (os_sched_lock_nest == 0) {
-        uint32_t highest_ready_priority;
+    if (cpu->sched_lock_nest == 0) {
+        cpu->need_sched = 0;
 
-#if OS_TASK_PRIORITY_MAX > 32
-        uint8_t group;
+        /* get switch to task */
+        to_task = os_sched_pick(os_arch_cpu_id());
 
-        group = __ffs(os_ready_task_group) - 1;
-        highest_ready_priority = (group << 5) + __ffs(os_ready_task_bitmap[group]) - 1;
-#else
-        highest_ready_priority = __ffs(os_ready_task_bitmap) - 1;
+        /* if the destination task is not the same as current task */
+        if (to_task != cpu->current_task && to_task != NULL) {
+            from_task         = cpu->current_task;
+            cpu->current_task = to_task;
+
+            from_task->oncpu  = OS_CPU_NONE;
+            to_task->oncpu    = os_arch_cpu_id();
+
+            /* the task left is free to run on another processor */
+            if (from_task->stat == OS_TASK_READY)
+                _os_sched_smp_kick(from_task);
+
+            OS_DEBUG_LOG(OS_DEBUG_SCHEDULER,
+                         ("[cpu%d]switch to priority#%d "
+                          "task:%.*s(sp:0x%p), "
+                          "from task:%.*s(sp: 0x%p)\n",
+                          os_arch_cpu_id(), to_task->current_priority,
+                          OS_NAME_MAX, to_task->name, to_task->sp,
+                          OS_NAME_MAX, from_task->name, from_task->sp));
+
+#if defined(OS_CFG_OVERFLOW_CHECK) && !defined(OS_CFG_STACK_GUARD)
+            _os_sched_stack_check(to_task);
 #endif
 
+            OS_TRACE(OS_TRACE_SWITCH, to_task->current_priority, to_task, from_task);
+
+            /* the kernel lock is held across the switch, its nest is not */
+            nest = os_smp_lock_nest_get();
+            os_arch_context_switch((uint32_t)&from_task->sp,
+                                 (uint32_t)&to_task->sp);
+            os_smp_lock_nest_set(nest);
+        }
+    }
+
+    os_exit_critical(sr);
+}
+#else
+/**
+ * This function will perform one schedule. It will select one task
+ * with the highest priority level, then switch to it.
+ */
+void os_sched(void)
+{
+    os_sr_t sr;
+    os_task_t *to_task;
+    os_task_t *from_task;
+
+    sr = os_enter_critical();
+
+    /* check the scheduler is enabled or not */
+    if (os_sched_lock_nest == 0) {
         /* get switch to task */
-        to_task = OS_LIST_ENTRY(os_ready_task_priority_list[highest_ready_priority].next,
-                                  os_task_t,
-                                  tlist);
+        to_task = os_sched_next_task;
 
         /* if the destination task is not the same as current task */
-        if (to_task != os_current_task) {
+        if (to_task != os_current_task && to_task != NULL) {
             from_task           = os_current_task;
+
+#ifdef OS_CFG_TASK_STATS
+            /* charge the outgoing task while it is still current */
+            os_sched_account();
+#endif
+
             os_current_task     = to_task;
 
             /* switch to new task */
@@ -169,14 +429,32 @@ void os_sched(void)
                          ("[%d]switch to priority#%d "
                           "task:%.*s(sp:0x%p), "
                           "from task:%.*s(sp: 0x%p)\n",
-                          os_isr_nest, highest_ready_priority,
+                          os_isr_nest, to_task->current_priority,
                           OS_NAME_MAX, to_task->name, to_task->sp,
                           OS_NAME_MAX, from_task->name, from_task->sp));
 
-#ifdef OS_CFG_OVERFLOW_CHECK
+#if defined(OS_CFG_OVERFLOW_CHECK) && !defined(OS_CFG_STACK_GUARD)
             _os_sched_stack_check(to_task);
 #endif
 
+#ifdef OS_CFG_TASK_STATS
+            /* classify why the outgoing task leaves */
+            to_task->stats.run_switches++;
+            if (from_task->stat == OS_TASK_READY &&
+                !(from_task->flags & OS_TASK_FLAG_YIELD))
+                from_task->stats.run_preempts++;
+            else
+                from_task->stats.run_yields++;
+            from_task->flags &= ~OS_TASK_FLAG_YIELD;
+#endif
+
+            OS_TRACE(OS_TRACE_SWITCH, to_task->current_priority, to_task, from_task);
+
+#ifdef OS_CFG_TASK_FPU
+            /* no task code runs until the switch, the fpu is handed now */
+            os_arch_fpu_switch(to_task);
+#endif
+
             if (os_isr_nest == 0) {
                 os_arch_context_switch((uint32_t)&from_task->sp,
                                      (uint32_t)&to_task->sp);
@@ -191,6 +469,7 @@ void os_sched(void)
 
     os_exit_critical(sr);
 }
+#endif
 
 /*
  * This function will insert a task to system ready queue. The state of
@@ -211,6 +490,11 @@ void os_sched_insert(os_task_t *task)
     task->stat = OS_TASK_READY;
 
     /* insert task to ready list */
+#ifdef OS_CFG_SCHED_EDF
+    if (task->current_priority == OS_SCHED_EDF_PRIO)
+        _os_sched_edf_insert(task);
+    else
+#endif
     os_list_insert_before(&(os_ready_task_priority_list[task->current_priority]),
                           &(task->tlist));
 
@@ -234,6 +518,23 @@ void os_sched_insert(os_task_t *task)
     os_ready_task_bitmap |= task->priority_mask;
 #endif
 
+    /* a task queued behind an equal priority one never becomes the next */
+    if (os_sched_next_task == NULL ||
+        task->current_priority < os_sched_next_task->current_priority) {
+        os_sched_next_task = task;
+    }
+#ifdef OS_CFG_SCHED_EDF
+    /* an earlier deadline goes ahead of the next task in the same band */
+    else if (os_ready_task_priority_list[task->current_priority].next == &(task->tlist) &&
+             task->current_priority == os_sched_next_task->current_priority) {
+        os_sched_next_task = task;
+    }
+#endif
+
+#ifdef OS_CFG_SMP
+    _os_sched_smp_kick(task);
+#endif
+
     os_exit_critical(sr);
 }
 
@@ -278,8 +579,57 @@ void os_sched_remove(os_task_t *task)
 #endif
     }
 
+    /* only removing the next task changes the decision */
+    if (os_sched_next_task == task) {
+        os_sched_next_task = _os_sched_highest_ready();
+    }
+
+    os_exit_critical(sr);
+}
+
+#ifdef OS_CFG_TASK_STATS
+/*
+ * This function will charge the cycles since the last accounting to current
+ * task. It is invoked on every switch and every tick, so that the cycle
+ * counter never wraps between two accounting.
+ */
+void os_sched_account(void)
+{
+    os_sr_t sr;
+    uint32_t now;
+    uint32_t delta;
+
+    sr = os_enter_critical();
+
+    if (os_current_task != NULL) {
+        now   = os_arch_cycle_get();
+        delta = now - os_sched_stamp;
+
+        os_sched_stamp = now;
+        os_sched_cycles += delta;
+        os_current_task->stats.run_cycles += delta;
+    }
+
+    os_exit_critical(sr);
+}
+
+/**
+ * This function will return the cycles accounted since scheduler start.
+ *
+ * @return the accounted cycles
+ */
+uint64_t os_sched_cycles_get(void)
+{
+    os_sr_t sr;
+    uint64_t cycles;
+
+    sr = os_enter_critical();
+    cycles = os_sched_cycles;
     os_exit_critical(sr);
+
+    return cycles;
 }
+#endif
 
 /**
  * This function will lock the task scheduler.
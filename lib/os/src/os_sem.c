@@ -20,10 +20,93 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-09-14     Grissiom     add an option check in os_event_get
+ * 2026-10-17     kontais      pend on os_waitq
+ * 2026-10-17     kontais      uncontended take and give without critical section
  */
 
 #include <os.h>
 
+/*
+ * An uncontended take or give only changes the value. With exclusive access
+ * it is done without disabling interrupt, or else in a short critical section.
+ * A task pends only after an interrupt, which breaks the exclusive access, so
+ * a waiter can not slip in between the check and the update. Another core
+ * can, the kernel lock shall be taken on SMP.
+ */
+#if defined(OS_ARCH_EXCLUSIVE) && !defined(OS_CFG_SMP)
+/* decrease a positive value, FALSE if it is 0 */
+static bool_t _os_sem_fast_take(os_sem_t *sem)
+{
+    uint32_t value;
+
+    do {
+        value = os_arch_ldrex((volatile uint32_t *)&sem->value);
+        if (value == 0) {
+            os_arch_clrex();
+
+            return FALSE;
+        }
+    } while (os_arch_strex(value - 1,
+                           (volatile uint32_t *)&sem->value) != 0);
+
+    return TRUE;
+}
+
+/* increase the value, FALSE if a task may wait */
+static bool_t _os_sem_fast_give(os_sem_t *sem)
+{
+    uint32_t value;
+
+    do {
+        value = os_arch_ldrex((volatile uint32_t *)&sem->value);
+        if (os_waitq_pending(&(sem->pending_list))) {
+            os_arch_clrex();
+
+            return FALSE;
+        }
+    } while (os_arch_strex(value + 1,
+                           (volatile uint32_t *)&sem->value) != 0);
+
+    return TRUE;
+}
+#else
+/* decrease a positive value, FALSE if it is 0 */
+static bool_t _os_sem_fast_take(os_sem_t *sem)
+{
+    bool_t taken = FALSE;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    if (sem->value > 0) {
+        sem->value--;
+        taken = TRUE;
+    }
+
+    os_exit_critical(sr);
+
+    return taken;
+}
+
+/* increase the value, FALSE if a task may wait */
+static bool_t _os_sem_fast_give(os_sem_t *sem)
+{
+    bool_t given = FALSE;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    if (!os_waitq_pending(&(sem->pending_list))) {
+        sem->value++;
+        given = TRUE;
+    }
+
+    os_exit_critical(sr);
+
+    return given;
+}
+#endif
+
 /**
  * This function will initialize a semaphore and put it under control of
  * resource management.
@@ -41,7 +124,7 @@ os_err_t os_sem_init(os_sem_t *sem,
     OS_ASSERT(sem != NULL);
 
     /* init ipc object */
-    os_list_init(&(sem->pending_list));
+    os_waitq_init(&(sem->pending_list));
 
     /* set init value */
     sem->value = value;
@@ -65,7 +148,7 @@ os_err_t os_sem_delete(os_sem_t *sem)
     OS_ASSERT(sem != NULL);
 
     /* wakeup all suspend tasks */
-    os_list_resume_all(&(sem->pending_list));
+    os_waitq_resume_all(&(sem->pending_list));
 
     return OS_OK;
 }
@@ -86,6 +169,10 @@ os_err_t os_sem_take(os_sem_t *sem, os_tick_t timeout)
 
     OS_ASSERT(sem != NULL);
 
+    /* semaphore is available, no critical section */
+    if (_os_sem_fast_take(sem))
+        return OS_OK;
+
     /* get current task */
     task = os_task_self();
 
@@ -118,7 +205,7 @@ os_err_t os_sem_take(os_sem_t *sem, os_tick_t timeout)
     task->error = OS_OK;
 
     /* semaphore is unavailable, push to suspend list */
-    os_list_suspend(&(sem->pending_list),
+    os_waitq_suspend(&(sem->pending_list),
                         task,
                         sem->flag);
 
@@ -167,15 +254,19 @@ os_err_t os_sem_give(os_sem_t *sem)
 
     need_schedule = FALSE;
 
+    /* nobody waits, no critical section */
+    if (_os_sem_fast_give(sem))
+        return OS_OK;
+
     sr = os_enter_critical();
 
     OS_DEBUG_LOG(OS_DEBUG_IPC, ("task %s releases sem which value is: %d\n",
                                 os_task_self()->name,
                                 sem->value));
 
-    if (!os_list_isempty(&sem->pending_list)) {
+    if (!os_waitq_isempty(&sem->pending_list)) {
         /* resume the suspended task */
-        os_list_resume(&(sem->pending_list));
+        os_waitq_resume(&(sem->pending_list));
         need_schedule = TRUE;
     } else {
         sem->value++; /* increase value */
@@ -207,7 +298,7 @@ os_err_t os_sem_reset(os_sem_t *sem, uint32_t value)
     sr = os_enter_critical();
 
     /* resume all waiting task */
-    os_list_resume_all(&sem->pending_list);
+    os_waitq_resume_all(&sem->pending_list);
 
     /* set new value */
     sem->value = value;
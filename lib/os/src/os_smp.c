@@ -0,0 +1,142 @@
+/*
+ * File      : os_smp.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+#include <os.h>
+
+#ifdef OS_CFG_SMP
+
+os_cpu_t os_cpus[OS_CPUS_NR];
+
+/*
+ * the kernel lock, one processor at a time runs in critical section. It is
+ * taken again by its owner without blocking, and passed to the next task on
+ * a context switch.
+ */
+static os_spinlock_t os_kernel_lock;
+static volatile uint32_t os_kernel_lock_owner = OS_CPU_NONE;
+static uint32_t os_kernel_lock_nest;
+
+/**
+ * This function will enter critical section, interrupt of current processor
+ * is disabled and the kernel lock is taken.
+ *
+ * @return the interrupt status to be restored
+ */
+os_sr_t os_enter_critical(void)
+{
+    os_sr_t sr;
+    uint32_t cpu;
+
+    sr  = os_arch_irq_save();
+    cpu = os_arch_cpu_id();
+
+    if (os_kernel_lock_owner != cpu) {
+        os_arch_spin_lock(&os_kernel_lock);
+        os_kernel_lock_owner = cpu;
+    }
+    os_kernel_lock_nest++;
+
+    return sr;
+}
+
+/**
+ * This function will leave critical section, the kernel lock is released by
+ * the outermost one.
+ *
+ * @param sr the interrupt status returned by os_enter_critical
+ */
+void os_exit_critical(os_sr_t sr)
+{
+    OS_ASSERT(os_kernel_lock_owner == os_arch_cpu_id());
+
+    if (--os_kernel_lock_nest == 0) {
+        os_kernel_lock_owner = OS_CPU_NONE;
+        os_arch_spin_unlock(&os_kernel_lock);
+    }
+
+    os_arch_irq_restore(sr);
+}
+
+/*
+ * The nest of kernel lock belongs to the task holding it, a task saves it
+ * before a context switch and takes it back when switched in again.
+ */
+uint32_t os_smp_lock_nest_get(void)
+{
+    return os_kernel_lock_nest;
+}
+
+void os_smp_lock_nest_set(uint32_t nest)
+{
+    os_kernel_lock_nest = nest;
+}
+
+/**
+ * This function is the first code of every task in SMP mode. A new task is
+ * switched to with the kernel lock held, it releases the lock before going
+ * into its entry.
+ *
+ * @param parameter the task object
+ */
+void os_smp_task_entry(void *parameter)
+{
+    os_task_t *task;
+
+    task = (os_task_t *)parameter;
+
+    os_kernel_lock_nest = 1;
+    os_exit_critical(os_arch_irq_save());
+
+    ((void (*)(void *))task->entry)(task->parameter);
+}
+
+/**
+ * This function will start scheduling on a secondary processor, which runs
+ * its own idle task until other tasks are ready for it.
+ *
+ * @note this function is invoked by arch, and never returns.
+ */
+void os_smp_secondary_entry(void)
+{
+    os_task_t *to_task;
+
+    os_enter_critical();
+
+    to_task = os_sched_pick(os_arch_cpu_id());
+    OS_ASSERT(to_task != NULL);
+
+    to_task->oncpu    = os_arch_cpu_id();
+    os_current_task   = to_task;
+
+    OS_DEBUG_LOG(OS_DEBUG_SCHEDULER, ("cpu%d start task:%.*s\n",
+                                      os_arch_cpu_id(),
+                                      OS_NAME_MAX, to_task->name));
+
+    /* switch to new task, the kernel lock goes with it */
+    os_arch_context_switch_to((uint32_t)&to_task->sp);
+
+    /* never come back */
+}
+
+#endif
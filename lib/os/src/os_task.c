@@ -20,14 +20,135 @@
  * Change Logs:
  * Date           Author       Notes
  * 2012-12-29     Bernard      fixed compiling warning.
+ * 2026-10-17     kontais      yield through the scheduler queue
+ * 2026-10-17     kontais      add task notification
+ * 2026-10-17     kontais      add cpu usage accounting
+ * 2026-10-17     kontais      add task registry and snapshot
+ * 2026-10-17     kontais      add earliest deadline first
+ * 2026-10-17     kontais      add transitive priority inheritance
+ * 2026-10-17     kontais      add stack high water mark
+ * 2026-10-17     kontais      add fpu ownership
+ * 2026-10-17     kontais      add processor affinity
+ * 2026-10-17     kontais      add os_task_sleep_until
+ * 2026-10-17     kontais      reject an unknown notify action
+ * 2026-10-17     kontais      keep fixed priority tasks out of the EDF band
+ * 2026-10-17     kontais      requeue a waiter of any IPC object on priority change
+ * 2026-10-17     kontais      lock the registry against other processors
+ * 2026-10-17     kontais      wake and block on notification by a fast path
+ * 2026-10-17     kontais      set the base priority under mutex inheritance
+ * 2026-10-17     kontais      keep the ceiling of priority ceiling mutexes apart
+ * 2026-10-17     kontais      scan stacks a task at a time, registry unlocked between
  */
 
 #include <os.h>
 
-extern os_list_t os_ready_task_priority_list[OS_TASK_PRIORITY_MAX];
+#ifndef OS_CFG_SMP
 extern os_task_t *os_current_task;
+#endif
 extern os_list_t os_defunct_task_list;
 
+#ifdef OS_CFG_TASK_STACK_HWM
+#ifndef OS_TASK_STACK_SCAN_WORDS
+#define OS_TASK_STACK_SCAN_WORDS  8
+#endif
+
+#ifndef OS_TASK_STACK_MARGIN
+#define OS_TASK_STACK_MARGIN      64
+#endif
+
+/* the '#' filled by task init, a word at a time */
+#define OS_TASK_STACK_FILL        0x23232323UL
+#endif
+
+/* every initialized task, until it is closed */
+os_list_t os_task_registry = OS_LIST_INIT(os_task_registry);
+static uint32_t  os_task_registry_count;
+
+#ifdef OS_CFG_TASK_STACK_HWM
+/* the next task of the stack walks, which unlock the registry between tasks */
+static os_list_t *os_task_stack_watch_next  = &os_task_registry;
+static os_list_t *os_task_stack_report_next = NULL;
+#endif
+
+#ifdef OS_CFG_SMP
+/* a processor walks the registry, it is not changed meanwhile */
+static volatile bool_t os_task_registry_walked;
+
+/*
+ * This function will wait in critical section until no processor walks the
+ * registry. The kernel lock is let go while waiting, so that the walker takes
+ * it for a task, the caller shall hold it only once.
+ */
+static os_sr_t _os_task_registry_wait(os_sr_t sr)
+{
+    while (os_task_registry_walked == TRUE) {
+        os_exit_critical(sr);
+        sr = os_enter_critical();
+    }
+
+    return sr;
+}
+#else
+/* the scheduler lock of walker keeps every other task out */
+#define _os_task_registry_wait(sr)  (sr)
+#endif
+
+/**
+ * This function will lock the task registry for a walk. No task is
+ * registered or closed until it is unlocked, and no other walk takes place.
+ *
+ * @note the scheduler lock is per processor under OS_CFG_SMP, a walk also
+ * holds the registry off the other processors, without the kernel lock.
+ */
+void os_task_registry_lock(void)
+{
+#ifdef OS_CFG_SMP
+    os_sr_t sr;
+#endif
+
+    os_sched_lock();
+
+#ifdef OS_CFG_SMP
+    sr = _os_task_registry_wait(os_enter_critical());
+    os_task_registry_walked = TRUE;
+    os_exit_critical(sr);
+#endif
+}
+
+/**
+ * This function will unlock the task registry.
+ */
+void os_task_registry_unlock(void)
+{
+#ifdef OS_CFG_SMP
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+    os_task_registry_walked = FALSE;
+    os_exit_critical(sr);
+#endif
+
+    os_sched_unlock();
+}
+
+/*
+ * This function will remove a task from the registry, a stack walk left
+ * on it goes on from the next task. Interrupt must be disabled and no
+ * processor walks the registry.
+ */
+static void _os_task_registry_remove(os_task_t *task)
+{
+#ifdef OS_CFG_TASK_STACK_HWM
+    if (os_task_stack_watch_next == &(task->rlist))
+        os_task_stack_watch_next = task->rlist.next;
+    if (os_task_stack_report_next == &(task->rlist))
+        os_task_stack_report_next = task->rlist.next;
+#endif
+
+    os_list_remove(&(task->rlist));
+    os_task_registry_count--;
+}
+
 void os_task_timeout(void *parameter);
 
 void os_task_exit(void)
@@ -35,11 +156,11 @@ void os_task_exit(void)
     os_task_t *task;
     os_sr_t sr;
 
+    sr = _os_task_registry_wait(os_enter_critical());
+
     /* get current task */
     task = os_current_task;
 
-    sr = os_enter_critical();
-
     /* remove from schedule */
     os_sched_remove(task);
     /* change stat */
@@ -48,6 +169,13 @@ void os_task_exit(void)
     /* remove it from timer list */
     os_timer_delete(&task->timer);
 
+    /* remove it from task registry */
+    _os_task_registry_remove(task);
+
+#ifdef OS_CFG_TASK_FPU
+    os_arch_fpu_release(task);
+#endif
+
     if (task->cleanup != NULL) {
         /* insert to defunct task list */
         os_list_insert_after(&os_defunct_task_list, &(task->tlist));
@@ -68,6 +196,8 @@ static os_err_t _os_task_init(os_task_t *task,
                                 uint8_t        priority,
                                 uint32_t       tick)
 {
+    os_sr_t sr;
+
     /* init task list */
     os_list_init(&(task->tlist));
     
@@ -82,13 +212,31 @@ static os_err_t _os_task_init(os_task_t *task,
 
     /* init task stack */
     memset(task->stack_addr, '#', task->stack_size);
+#ifdef OS_CFG_TASK_STACK_HWM
+    task->stack_free = OS_ALIGN_DOWN(task->stack_size, 4);
+    task->stack_scan = 0;
+#endif
+#ifdef OS_CFG_SMP
+    /* a task starts with the kernel lock held, os_smp_task_entry drops it */
+    task->sp = (void *)os_arch_task_stack_init((void *)os_smp_task_entry, task,
+                    (void *)((char *)task->stack_addr + task->stack_size - 4),
+                    (void *)os_task_exit);
+#else
     task->sp = (void *)os_arch_task_stack_init(task->entry, task->parameter,
                     (void *)((char *)task->stack_addr + task->stack_size - 4),
                     (void *)os_task_exit);
+#endif
 
     /* priority init */
     OS_ASSERT(priority < OS_TASK_PRIORITY_MAX);
     task->current_priority = priority;
+    task->init_priority    = priority;
+    task->ceiling_priority = 0xFF;
+
+    /* priority inheritance init */
+    os_list_init(&(task->mutex_list));
+    task->pending_mutex = NULL;
+    task->pending_waitq = NULL;
 
     /* tick init */
     task->slice_tick     = tick;
@@ -97,11 +245,42 @@ static os_err_t _os_task_init(os_task_t *task,
     /* error and flags */
     task->error = OS_OK;
     task->stat  = OS_TASK_INIT;
+    task->flags = 0;
 
     /* initialize cleanup function and user data */
     task->cleanup   = NULL;
     task->user_data = 0;
 
+#ifdef OS_CFG_TASK_NOTIFY
+    /* initialize notification */
+    task->notify_value = 0;
+    task->notify_state = OS_TASK_NOTIFY_IDLE;
+#endif
+
+#ifdef OS_CFG_TASK_STATS
+    /* initialize statistics */
+    memset(&(task->stats), 0, sizeof(task->stats));
+#endif
+
+#ifdef OS_CFG_SCHED_EDF
+    /* fixed priority until os_task_edf_set */
+    task->edf_period   = 0;
+    task->edf_misses   = 0;
+    task->edf_overruns = 0;
+#endif
+
+#ifdef OS_CFG_SMP
+    /* any processor */
+    task->cpu_affinity = OS_CPU_MASK_ALL;
+    task->oncpu        = OS_CPU_NONE;
+#endif
+
+    /* register the task */
+    sr = _os_task_registry_wait(os_enter_critical());
+    os_list_insert_before(&os_task_registry, &(task->rlist));
+    os_task_registry_count++;
+    os_exit_critical(sr);
+
     /* init task timer */
     os_timer_init(&(task->timer),
                   os_task_timeout,
@@ -128,7 +307,8 @@ static os_err_t _os_task_init(os_task_t *task,
  * @param parameter the parameter of task enter function
  * @param stack_start the start address of task stack
  * @param stack_size the size of task stack
- * @param priority the priority of task
+ * @param priority the priority of task, not OS_SCHED_EDF_PRIO with
+ *        OS_CFG_SCHED_EDF
  * @param tick the time slice if there are same priority task
  *
  * @return the operation status, OS_OK on OK, OS_ERROR on error
@@ -146,6 +326,12 @@ os_err_t os_task_init(os_task_t *task,
     OS_ASSERT(task != NULL);
     OS_ASSERT(stack_start != NULL);
 
+#ifdef OS_CFG_SCHED_EDF
+    /* the band of deadlines is entered by os_task_edf_set only */
+    if (priority == OS_SCHED_EDF_PRIO)
+        return OS_ERROR;
+#endif
+
     return _os_task_init(task,
                            name,
                            entry,
@@ -163,8 +349,88 @@ os_err_t os_task_init(os_task_t *task,
  */
 os_task_t *os_task_self(void)
 {
+#ifdef OS_CFG_SMP
+    os_task_t *task;
+    os_sr_t sr;
+
+    /* the processor may change unless interrupt is disabled */
+    sr = os_arch_irq_save();
+    task = os_current_task;
+    os_arch_irq_restore(sr);
+
+    return task;
+#else
     return os_current_task;
+#endif
+}
+
+#ifdef OS_CFG_SMP
+/**
+ * This function will set the processors a task is allowed to run on. A
+ * running task on a processor no longer allowed leaves it at once.
+ *
+ * @param task the task to be set
+ * @param cpu_mask the mask of processors, bit n for processor n
+ *
+ * @return the operation status, OS_OK on OK, OS_ERROR if no processor
+ *         in the mask
+ */
+os_err_t os_task_affinity_set(os_task_t *task, uint32_t cpu_mask)
+{
+    os_sr_t sr;
+    uint8_t oncpu;
+
+    OS_ASSERT(task != NULL);
+
+    cpu_mask &= OS_CPU_MASK_ALL;
+    if (cpu_mask == 0)
+        return OS_ERROR;
+
+    sr = os_enter_critical();
+
+    task->cpu_affinity = cpu_mask;
+
+    oncpu = task->oncpu;
+    if (oncpu != OS_CPU_NONE && !(cpu_mask & (1UL << oncpu))) {
+        if (oncpu == os_arch_cpu_id()) {
+            os_exit_critical(sr);
+
+            /* switch out, another processor picks it up */
+            os_sched();
+
+            return OS_OK;
+        }
+
+        os_arch_ipi_send(1UL << oncpu);
+    }
+
+    os_exit_critical(sr);
+
+    return OS_OK;
+}
+#endif
+
+#ifdef OS_CFG_TASK_FPU
+/**
+ * This function will let a task use the FPU. The task gets a FPU context of
+ * its own, which is saved only when another FPU task runs. A task which is
+ * not enabled never carries FPU registers, it faults on a FPU instruction.
+ *
+ * @param task the task to be enabled, it shall not be started yet
+ *
+ * @return the operation status, OS_OK on OK
+ */
+os_err_t os_task_fpu_enable(os_task_t *task)
+{
+    OS_ASSERT(task != NULL);
+    OS_ASSERT(task->stat == OS_TASK_INIT);
+
+    memset(task->fpu_context, 0, sizeof(task->fpu_context));
+    task->flags |= OS_TASK_FLAG_FPU;
+
+    return OS_OK;
 }
+#endif
 
 /**
  * This function will start a task and put it to system ready queue
@@ -223,6 +489,14 @@ os_err_t os_task_delete(os_task_t *task)
     /* change stat */
     task->stat = OS_TASK_CLOSE;
 
+    /* remove it from task registry */
+    sr = _os_task_registry_wait(os_enter_critical());
+    _os_task_registry_remove(task);
+#ifdef OS_CFG_TASK_FPU
+    os_arch_fpu_release(task);
+#endif
+    os_exit_critical(sr);
+
     if (task->cleanup != NULL) {
         sr = os_enter_critical();
 
@@ -255,17 +529,24 @@ os_err_t os_task_yield(void)
     /* if the task stat is READY and on ready queue list */
     if (task->stat == OS_TASK_READY &&
         task->tlist.next != task->tlist.prev) {
-        /* remove task from task list */
-        os_list_remove(&(task->tlist));
+        /* put task to end of ready queue, the next task follows it */
+        os_sched_remove(task);
+        os_sched_insert(task);
 
-        /* put task to end of ready queue */
-        os_list_insert_before(&(os_ready_task_priority_list[task->current_priority]),
-                              &(task->tlist));
+#ifdef OS_CFG_TASK_STATS
+        /* a time slice yield in tick interrupt is a preemption */
+        if (os_isr_nest == 0)
+            task->flags |= OS_TASK_FLAG_YIELD;
+#endif
 
         os_exit_critical(sr);
 
         os_sched();
 
+#ifdef OS_CFG_TASK_STATS
+        task->flags &= ~OS_TASK_FLAG_YIELD;
+#endif
+
         return OS_OK;
     }
 
@@ -309,6 +590,69 @@ os_err_t os_task_sleep(os_tick_t tick)
     return OS_OK;
 }
 
+/**
+ * This function will let current task sleep until a period after its last
+ * wake tick, a periodic task calling it in a loop does not drift with the
+ * time its work takes.
+ *
+ * @param last_wake the wake tick of previous period, advanced by period
+ * @param period the ticks of a period
+ *
+ * @return OS_OK, or OS_TIMEOUT if the wake tick passed already and the task
+ *         did not sleep
+ */
+os_err_t os_task_sleep_until(os_tick_t *last_wake, os_tick_t period)
+{
+    os_sr_t sr;
+    os_task_t *task;
+    os_tick_t tick;
+
+    OS_ASSERT(last_wake != NULL);
+
+    sr = os_enter_critical();
+    /* set to current task */
+    task = os_current_task;
+    OS_ASSERT(task != NULL);
+
+    *last_wake += period;
+
+    /* late, the period is overrun */
+    tick = *last_wake - os_tick_get();
+    if ((int32_t)tick <= 0) {
+        os_exit_critical(sr);
+
+        return OS_TIMEOUT;
+    }
+
+    /* suspend task */
+    os_task_suspend(task);
+
+    /* reset the timeout of task timer and start it */
+    os_timer_tick_set(&(task->timer), tick);
+    os_timer_start(&(task->timer));
+
+    os_exit_critical(sr);
+
+    os_sched();
+
+    /* clear error number of this task to OS_OK */
+    if (task->error == OS_TIMEOUT)
+        task->error = OS_OK;
+
+    return OS_OK;
+}
+
+/**
+ * This function will change the priority of a task. It is the base under
+ * what the mutexes the task holds lend it, the task runs at the higher of
+ * them. The change of a task pending on a mutex goes on to its owner.
+ *
+ * @param task the task to be changed
+ * @param priority the new priority, OS_SCHED_EDF_PRIO only for a task of
+ *        earliest deadline first with OS_CFG_SCHED_EDF
+ *
+ * @return the operation status, OS_OK on OK, OS_ERROR on error
+ */
 os_err_t os_task_priority_set(os_task_t *task, uint8_t priority)
 {
     os_sr_t sr;
@@ -316,6 +660,41 @@ os_err_t os_task_priority_set(os_task_t *task, uint8_t priority)
     /* task check */
     OS_ASSERT(task != NULL);
 
+#ifdef OS_CFG_SCHED_EDF
+    /* a fixed priority task is ordered by no deadline in the band */
+    if (priority == OS_SCHED_EDF_PRIO && task->edf_period == 0)
+        return OS_ERROR;
+#endif
+
+    sr = os_enter_critical();
+
+    task->init_priority = priority;
+    os_mutex_priority_update(task);
+
+    os_exit_critical(sr);
+
+    return OS_OK;
+}
+
+/**
+ * This function will change the current priority of a task for a mutex,
+ * which lends it or raises it to a ceiling. A fixed priority task may enter
+ * the band of earliest deadline first so, it runs ahead of the deadlines
+ * it blocks. A task waiting on a PRIOed IPC object moves to its new place
+ * in the wait queue.
+ *
+ * @param task the task to be changed
+ * @param priority the new priority
+ *
+ * @return the operation status, OS_OK on OK
+ */
+os_err_t os_task_priority_inherit(os_task_t *task, uint8_t priority)
+{
+    os_sr_t sr;
+
+    /* task check */
+    OS_ASSERT(task != NULL);
+
     sr = os_enter_critical();
 
     /* for ready task, change queue */
@@ -342,6 +721,10 @@ os_err_t os_task_priority_set(os_task_t *task, uint8_t priority)
         task->priority_group = task->current_priority >> 5;             /* 3bit */
     #endif
         task->priority_mask  = 1UL << (task->current_priority & 0x1f);  /* 5bit */
+
+        /* keep the order of wait queue */
+        if (task->stat == OS_TASK_SUSPEND && task->pending_waitq != NULL)
+            os_waitq_requeue(task->pending_waitq, task, task->pending_flag);
     }
 
     os_exit_critical(sr);
@@ -381,6 +764,9 @@ os_err_t os_task_suspend(os_task_t *task)
     task->stat = OS_TASK_SUSPEND;
     os_sched_remove(task);
 
+    /* in no wait queue until os_waitq_suspend puts it */
+    task->pending_waitq = NULL;
+
     /* stop task timer anyway */
     os_timer_stop(&(task->timer));
 
@@ -427,6 +813,278 @@ os_err_t os_task_resume(os_task_t *task)
     return OS_OK;
 }
 
+/**
+ * This function will find a registered task by its name.
+ *
+ * @param name the name of task
+ *
+ * @return the task object, NULL if no task has the name
+ *
+ * @note the registry is walked with it locked, interrupt enabled.
+ */
+os_task_t *os_task_find(const char *name)
+{
+    os_list_t *node;
+    os_task_t *task;
+
+    OS_ASSERT(name != NULL);
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    os_task_registry_lock();
+
+    task = NULL;
+    for (node = os_task_registry.next;
+         node != &os_task_registry;
+         node = node->next) {
+        if (strncmp(OS_LIST_ENTRY(node, os_task_t, rlist)->name,
+                    name, OS_NAME_MAX) == 0) {
+            task = OS_LIST_ENTRY(node, os_task_t, rlist);
+            break;
+        }
+    }
+
+    os_task_registry_unlock();
+
+    return task;
+}
+
+/**
+ * This function will return the number of registered tasks.
+ *
+ * @return the number of tasks
+ */
+uint32_t os_task_count(void)
+{
+    return os_task_registry_count;
+}
+
+/**
+ * This function will copy the registered tasks to a packed array.
+ *
+ * Tasks are only created and closed in task context, so the registry is
+ * stable while it is locked. Each task is copied in its own short critical
+ * section, interrupt is never disabled for the whole walk.
+ *
+ * @param info the array to save task snapshots
+ * @param max the number of elements in array
+ *
+ * @return the number of tasks copied
+ */
+uint32_t os_task_snapshot(os_task_info_t *info, uint32_t max)
+{
+    os_sr_t sr;
+    os_list_t *node;
+    os_task_t *task;
+    uint32_t count;
+
+    OS_ASSERT(info != NULL);
+    OS_DEBUG_NOT_IN_INTERRUPT;
+
+    os_task_registry_lock();
+
+#ifdef OS_CFG_TASK_STATS
+    os_sched_account();
+#endif
+
+    count = 0;
+    for (node = os_task_registry.next;
+         node != &os_task_registry && count < max;
+         node = node->next) {
+        task = OS_LIST_ENTRY(node, os_task_t, rlist);
+
+        sr = os_enter_critical();
+
+        info[count].task             = task;
+        memcpy(info[count].name, task->name, OS_NAME_MAX);
+        info[count].stat             = task->stat;
+        info[count].current_priority = task->current_priority;
+        info[count].stack_size       = task->stack_size;
+        info[count].stack_used       = (uint32_t)task->stack_addr +
+                                       task->stack_size - (uint32_t)task->sp;
+#ifdef OS_CFG_TASK_STACK_HWM
+        info[count].stack_hwm        = task->stack_size - task->stack_free;
+#endif
+#ifdef OS_CFG_TASK_STATS
+        info[count].stats            = task->stats;
+#endif
+
+        os_exit_critical(sr);
+
+        count++;
+    }
+
+    os_task_registry_unlock();
+
+    return count;
+}
+
+#ifdef OS_CFG_TASK_STACK_HWM
+/*
+ * This function will scan at most words of the untouched stack bottom of
+ * a task, from where the last scan stopped. A touched word lowers the
+ * untouched bottom and starts a new pass. Scheduler must be locked.
+ *
+ * @return TRUE when a pass is finished
+ */
+static bool_t _os_task_stack_scan(os_task_t *task, uint32_t words)
+{
+    uint32_t *stack;
+    uint32_t limit;
+#ifdef OS_CFG_STACK_GUARD
+    uint32_t first;
+#endif
+
+    stack = (uint32_t *)task->stack_addr;
+    limit = task->stack_free / 4;
+
+#ifdef OS_CFG_STACK_GUARD
+    /* the words up to the end of mpu guard are never touched nor readable */
+    first = (OS_ALIGN((uint32_t)stack, OS_ARCH_STACK_GUARD_SIZE) +
+             OS_ARCH_STACK_GUARD_SIZE - (uint32_t)stack) / 4;
+    if (task->stack_scan < first)
+        task->stack_scan = first;
+#endif
+
+    for (; words > 0 && task->stack_scan < limit; words--) {
+        if (stack[task->stack_scan] != OS_TASK_STACK_FILL) {
+            /* the words below were untouched when they were scanned */
+            task->stack_free = task->stack_scan * 4;
+            task->stack_scan = 0;
+
+            return TRUE;
+        }
+
+        task->stack_scan++;
+    }
+
+    if (task->stack_scan < limit)
+        return FALSE;
+
+    task->stack_scan = 0;
+
+    return TRUE;
+}
+
+/**
+ * This function will return the most stack a task has ever used, from one
+ * whole pass over its untouched stack bottom. The pass is made a few words
+ * at a time, the registry is unlocked between them.
+ *
+ * @param task the task to be inspected, which shall not be closed meanwhile
+ *
+ * @return the high water mark of stack in bytes
+ */
+uint32_t os_task_stack_hwm(os_task_t *task)
+{
+    uint32_t hwm;
+
+    OS_ASSERT(task != NULL);
+
+    os_task_registry_lock();
+
+    /* one whole pass from the beginning is exact */
+    task->stack_scan = 0;
+    while (_os_task_stack_scan(task, OS_TASK_STACK_SCAN_WORDS) == FALSE) {
+        os_task_registry_unlock();
+        os_task_registry_lock();
+    }
+    hwm = task->stack_size - task->stack_free;
+
+    os_task_registry_unlock();
+
+    return hwm;
+}
+
+/**
+ * This function will go on scanning the stack of the next task a little, so
+ * that high water marks keep up to date without rescanning whole stacks.
+ * The scheduler is locked for a few words of one task only.
+ *
+ * @note this function is invoked by idle task.
+ */
+void os_task_stack_watch(void)
+{
+    os_list_t *node;
+
+    os_task_registry_lock();
+
+    node = os_task_stack_watch_next;
+    if (node == &os_task_registry)
+        node = node->next;
+
+    if (node != &os_task_registry)
+        _os_task_stack_scan(OS_LIST_ENTRY(node, os_task_t, rlist),
+                            OS_TASK_STACK_SCAN_WORDS);
+    os_task_stack_watch_next = node->next;
+
+    os_task_registry_unlock();
+}
+
+/**
+ * This function will print the stack usage of every task, with the minimal
+ * stack size recommended, which is the high water mark plus a margin.
+ * Run the application through its worst case, then set the stack sizes of
+ * the next build from this report.
+ *
+ * @note the registry is unlocked every few words scanned, a task closed
+ * meanwhile is left out. One report is printed at a time.
+ */
+void os_task_stack_report(void)
+{
+    os_list_t *node;
+    os_task_t *task;
+    char name[OS_NAME_MAX];
+    uint32_t size;
+    uint32_t used;
+    uint32_t hwm;
+
+    os_task_registry_lock();
+
+    if (os_task_stack_report_next != NULL) {
+        os_task_registry_unlock();
+
+        return;
+    }
+
+    printf("task     size   used   hwm    recommend\n");
+    printf("-------- ------ ------ ------ ---------\n");
+
+    os_task_stack_report_next = os_task_registry.next;
+    while (os_task_stack_report_next != &os_task_registry) {
+        node = os_task_stack_report_next;
+        task = OS_LIST_ENTRY(node, os_task_t, rlist);
+
+        /* one whole pass from the beginning, the task may be closed */
+        task->stack_scan = 0;
+        while (os_task_stack_report_next == node &&
+               _os_task_stack_scan(task, OS_TASK_STACK_SCAN_WORDS) == FALSE) {
+            os_task_registry_unlock();
+            os_task_registry_lock();
+        }
+        if (os_task_stack_report_next != node)
+            continue;
+
+        memcpy(name, task->name, OS_NAME_MAX);
+        size = task->stack_size;
+        used = (uint32_t)task->stack_addr + task->stack_size - (uint32_t)task->sp;
+        hwm  = task->stack_size - task->stack_free;
+        os_task_stack_report_next = node->next;
+
+        os_task_registry_unlock();
+
+        printf("%-*.*s %-6d %-6d %-6d %d\n",
+               OS_NAME_MAX, OS_NAME_MAX, name, size, used, hwm,
+               OS_ALIGN(hwm + OS_TASK_STACK_MARGIN, OS_ALIGN_SIZE));
+
+        os_task_registry_lock();
+    }
+
+    os_task_stack_report_next = NULL;
+
+    os_task_registry_unlock();
+}
+#endif
+
 /**
  * This function is the timeout function for task, normally which is invoked
  * when task is timeout to wait some resource.
@@ -449,6 +1107,10 @@ void os_task_timeout(void *parameter)
     /* remove from suspend list */
     os_list_remove(&(task->tlist));
 
+    /* give back the priority lent to the mutex owner at once */
+    if (task->pending_mutex != NULL)
+        os_mutex_pend_abort(task);
+
     /* insert to schedule ready list */
     os_sched_insert(task);
 
@@ -456,4 +1118,333 @@ void os_task_timeout(void *parameter)
     os_sched();
 }
 
+#ifdef OS_CFG_TASK_NOTIFY
+/* block current task on its own notification, irq must be disabled */
+static void _os_task_notify_block(os_task_t *task, os_tick_t timeout)
+{
+    /* current context checking */
+    OS_DEBUG_IN_TASK_CONTEXT;
+
+    /* reset task error */
+    task->error = OS_OK;
+    task->notify_state = OS_TASK_NOTIFY_WAITING;
+
+    /*
+     * no pending list, the notifier resumes the task directly. Current task
+     * is ready and in no wait queue, its timer is stopped, leaving the ready
+     * queue is all os_task_suspend would do.
+     */
+    task->stat = OS_TASK_SUSPEND;
+    os_sched_remove(task);
+
+    /* no wait forever, start task timer */
+    if (timeout != OS_WAIT_FOREVER) {
+        /* reset the timeout of task timer and start it */
+        os_timer_tick_set(&(task->timer), timeout);
+        os_timer_start(&(task->timer));
+    }
+}
+
+/*
+ * This function will wake a task waiting for its notification, irq must be
+ * disabled. The task is in no wait queue and holds no ready node, only its
+ * timer is stopped when a timeout was given, no generic resume is needed.
+ *
+ * @return TRUE if the task woken shall preempt current task
+ */
+static bool_t _os_task_notify_wake(os_task_t *task, uint8_t state)
+{
+    /* the waiting task may have timed out already */
+    if (state != OS_TASK_NOTIFY_WAITING || task->stat != OS_TASK_SUSPEND)
+        return FALSE;
+
+    if (task->timer.flag & OS_TIMER_ACTIVATED)
+        os_timer_stop(&(task->timer));
+
+    os_sched_insert(task);
+
+#ifdef OS_CFG_SMP
+    /* another processor may run it, the schedule decides */
+    return TRUE;
+#else
+    return os_current_task == NULL ||
+           task->current_priority < os_current_task->current_priority;
+#endif
+}
+
+/**
+ * This function will send a notification to a task, if the task is waiting
+ * for notification, it will be waked up.
+ *
+ * @param task the task to be notified
+ * @param value the notification value
+ * @param action how value updates the notification, OS_TASK_NOTIFY_*
+ *
+ * @return the operation status, OS_OK on OK, OS_EFULL if the action is
+ *         OS_TASK_NOTIFY_NO_OVERWRITE and a notification is pending, OS_ERROR
+ *         if the action is unknown, the task is not touched then
+ *
+ * @note this function can be invoked in interrupt service routine.
+ */
+os_err_t os_task_notify(os_task_t *task, uint32_t value, uint8_t action)
+{
+    os_sr_t sr;
+    uint8_t state;
+    bool_t need_schedule;
+
+    /* task check */
+    OS_ASSERT(task != NULL);
+
+    sr = os_enter_critical();
+
+    state = task->notify_state;
+
+    switch (action) {
+    case OS_TASK_NOTIFY_NONE:
+        break;
+
+    case OS_TASK_NOTIFY_SET_BITS:
+        task->notify_value |= value;
+        break;
+
+    case OS_TASK_NOTIFY_INCREMENT:
+        task->notify_value++;
+        break;
+
+    case OS_TASK_NOTIFY_OVERWRITE:
+        task->notify_value = value;
+        break;
+
+    case OS_TASK_NOTIFY_NO_OVERWRITE:
+        if (state == OS_TASK_NOTIFY_PENDING) {
+            os_exit_critical(sr);
+
+            return OS_EFULL;
+        }
+        task->notify_value = value;
+        break;
+
+    default:
+        os_exit_critical(sr);
+
+        return OS_ERROR;
+    }
+
+    task->notify_state = OS_TASK_NOTIFY_PENDING;
+
+    need_schedule = _os_task_notify_wake(task, state);
+
+    os_exit_critical(sr);
+
+    /* resume a task, re-schedule */
+    if (need_schedule == TRUE) {
+        os_sched();
+    }
+
+    return OS_OK;
+}
+
+/**
+ * This function will increase the notification of a task, it is the
+ * lightweight replacement of a binary or counting semaphore.
+ *
+ * @param task the task to be notified
+ *
+ * @return the operation status, OS_OK on OK
+ *
+ * @note this function can be invoked in interrupt service routine.
+ */
+os_err_t os_task_notify_give(os_task_t *task)
+{
+    os_sr_t sr;
+    uint8_t state;
+    bool_t need_schedule;
+
+    /* task check */
+    OS_ASSERT(task != NULL);
+
+    sr = os_enter_critical();
+
+    state = task->notify_state;
+    task->notify_value++;
+    task->notify_state = OS_TASK_NOTIFY_PENDING;
+
+    need_schedule = _os_task_notify_wake(task, state);
+
+    os_exit_critical(sr);
+
+    /* resume a task, re-schedule */
+    if (need_schedule == TRUE)
+        os_sched();
+
+    return OS_OK;
+}
+
+/**
+ * This function will take the notification of current task as a counting
+ * semaphore, if it is zero, the task shall wait for a specified time.
+ *
+ * @param clear TRUE to clear notification, FALSE to decrease it
+ * @param value the notification value before taken, may be NULL
+ * @param timeout the waiting time
+ *
+ * @return the error code, OS_OK on OK, OS_TIMEOUT on timeout
+ */
+os_err_t os_task_notify_take(bool_t clear, uint32_t *value, os_tick_t timeout)
+{
+    os_sr_t sr;
+    os_task_t *task;
+
+    /* get current task */
+    task = os_task_self();
+
+    sr = os_enter_critical();
+
+    if (task->notify_value == 0 && timeout != OS_NO_WAIT) {
+        _os_task_notify_block(task, timeout);
+
+        os_exit_critical(sr);
+
+        /* do schedule */
+        os_sched();
+
+        sr = os_enter_critical();
+    }
+
+    task->notify_state = OS_TASK_NOTIFY_IDLE;
+
+    if (task->notify_value == 0) {
+        os_exit_critical(sr);
+
+        return OS_TIMEOUT;
+    }
+
+    if (value != NULL)
+        *value = task->notify_value;
+
+    if (clear == TRUE)
+        task->notify_value = 0;
+    else
+        task->notify_value--;
+
+    os_exit_critical(sr);
+
+    return OS_OK;
+}
+
+/**
+ * This function will wait for a notification of current task.
+ *
+ * @param clear_on_entry bits cleared before waiting, if none is pending
+ * @param clear_on_exit bits cleared after a notification is received
+ * @param value the notification value received, may be NULL
+ * @param timeout the waiting time
+ *
+ * @return the error code, OS_OK on OK, OS_TIMEOUT on timeout
+ */
+os_err_t os_task_notify_wait(uint32_t clear_on_entry,
+                             uint32_t clear_on_exit,
+                             uint32_t *value,
+                             os_tick_t timeout)
+{
+    os_sr_t sr;
+    os_task_t *task;
+
+    /* get current task */
+    task = os_task_self();
+
+    sr = os_enter_critical();
+
+    if (task->notify_state != OS_TASK_NOTIFY_PENDING) {
+        task->notify_value &= ~clear_on_entry;
+
+        if (timeout != OS_NO_WAIT) {
+            _os_task_notify_block(task, timeout);
+
+            os_exit_critical(sr);
+
+            /* do schedule */
+            os_sched();
+
+            sr = os_enter_critical();
+        }
+    }
+
+    if (task->notify_state != OS_TASK_NOTIFY_PENDING) {
+        task->notify_state = OS_TASK_NOTIFY_IDLE;
+        os_exit_critical(sr);
+
+        return OS_TIMEOUT;
+    }
+
+    if (value != NULL)
+        *value = task->notify_value;
+
+    task->notify_value &= ~clear_on_exit;
+    task->notify_state  = OS_TASK_NOTIFY_IDLE;
+
+    os_exit_critical(sr);
+
+    return OS_OK;
+}
+#endif
+
+#ifdef OS_CFG_TASK_STATS
+/**
+ * This function will get a consistent copy of the runtime statistics of
+ * a task, the cycles of current task are brought up to date first.
+ *
+ * @param task the task to be inspected
+ * @param stats the buffer to save statistics
+ *
+ * @return the operation status, OS_OK on OK
+ */
+os_err_t os_task_stats_get(os_task_t *task, os_task_stats_t *stats)
+{
+    os_sr_t sr;
+
+    OS_ASSERT(task != NULL);
+    OS_ASSERT(stats != NULL);
+
+    sr = os_enter_critical();
+
+    os_sched_account();
+    *stats = task->stats;
+
+    os_exit_critical(sr);
+
+    return OS_OK;
+}
+
+/**
+ * This function will invoke the callback for every initialized task, the
+ * cycles of current task are brought up to date first.
+ *
+ * @param callback the function to be invoked for each task
+ * @param arg the argument of callback
+ *
+ * @note the callback is invoked with interrupt disabled, it shall only copy
+ *       the statistics out and never block.
+ */
+void os_task_stats_foreach(void (*callback)(os_task_t *task, void *arg),
+                           void *arg)
+{
+    os_sr_t sr;
+    os_list_t *node;
+
+    OS_ASSERT(callback != NULL);
+
+    sr = os_enter_critical();
+
+    os_sched_account();
+    for (node = os_task_registry.next;
+         node != &os_task_registry;
+         node = node->next) {
+        callback(OS_LIST_ENTRY(node, os_task_t, rlist), arg);
+    }
+
+    os_exit_critical(sr);
+}
+#endif
+
 /*@}*/
@@ -20,6 +20,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2011-06-26     Bernard      add os_tick_set function.
+ * 2026-10-17     kontais      account task cycles every tick
+ * 2026-10-17     kontais      charge earliest deadline first budget
+ * 2026-10-17     kontais      no switch in the timeouts of tickless catch-up
  */
 
 #include <os.h>
@@ -56,6 +59,16 @@ void os_tick_increase(void)
     /* increase the global tick */
     os_tick++;
 
+#ifdef OS_CFG_TASK_STATS
+    /* fold the cycle counter before it can wrap */
+    os_sched_account();
+#endif
+
+#ifdef OS_CFG_SCHED_EDF
+    /* charge budget, current task may be throttled */
+    os_edf_tick();
+#endif
+
     /* check time slice */
     task = os_task_self();
 
@@ -72,6 +85,31 @@ void os_tick_increase(void)
     os_timer_check();
 }
 
+/**
+ * This function will account for several ticks at once, normally it is
+ * invoked after the system tick was stopped in tickless idle. Timers which
+ * expired during the sleep are handled before return.
+ *
+ * @param tick the number of ticks passed
+ *
+ * @note this function shall be invoked with interrupt disabled. Out of
+ * interrupt, a timeout function waking a task would switch in the middle of
+ * timer check, so the scheduler is locked until all timeouts are done.
+ */
+void os_tick_advance(os_tick_t tick)
+{
+    if (tick == 0)
+        return;
+
+    /* increase the global tick */
+    os_tick += tick;
+
+    /* check timer */
+    os_sched_lock();
+    os_timer_check();
+    os_sched_unlock();
+}
+
 /**
  * This function will calculate the tick from millisecond.
  *
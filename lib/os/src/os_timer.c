@@ -21,18 +21,219 @@
  * Date           Author       Notes
  * 2014-07-12     Bernard      does not lock scheduler when invoking soft-timer
  *                             timeout function.
+ * 2026-10-17     kontais      add hierarchical timing wheel, OS_CFG_TIMER_WHEEL
+ * 2026-10-17     kontais      add soft timer, OS_CFG_TIMER_SOFT
+ * 2026-10-17     kontais      trace timer fire
+ * 2026-10-17     kontais      periodic timer keeps its deadlines, add overrun policy
+ * 2026-10-17     kontais      wake timer task for a soft periodic timer at head
+ * 2026-10-17     kontais      wheel skips empty slots when it catches up
  */
 
 #include <os.h>
 
+#ifdef OS_CFG_TIMER_WHEEL
+/*
+ * Hierarchical timing wheel. Level 0 has one slot per tick, every upper level
+ * slot covers a whole turn of the level below it. A timer is hashed into the
+ * slot of the lowest level that can hold its distance, and is cascaded down
+ * when the lower level wraps. Start and stop are a single list operation.
+ */
+#ifndef OS_TIMER_WHEEL_BITS
+#define OS_TIMER_WHEEL_BITS         5
+#endif
+
+#ifndef OS_TIMER_WHEEL_LEVELS
+#define OS_TIMER_WHEEL_LEVELS       4
+#endif
+
+#define OS_TIMER_WHEEL_SLOTS        (1UL << OS_TIMER_WHEEL_BITS)
+#define OS_TIMER_WHEEL_MASK         (OS_TIMER_WHEEL_SLOTS - 1)
+#define OS_TIMER_WHEEL_RANGE        (1UL << (OS_TIMER_WHEEL_BITS * OS_TIMER_WHEEL_LEVELS))
+
+static os_list_t os_timer_wheel[OS_TIMER_WHEEL_LEVELS][OS_TIMER_WHEEL_SLOTS];
+
+/* the next tick the wheel will process */
+static os_tick_t os_timer_wheel_tick;
+static bool_t    os_timer_wheel_ready;
+#else
 /* hard timer list */
 static os_list_t os_timer_list = OS_LIST_INIT(os_timer_list);
+#endif
 
 void _os_timer_remove(os_timer_t *timer)
 {
     os_list_remove(&timer->list);
 }
 
+#ifdef OS_CFG_TIMER_WHEEL
+static void _os_timer_wheel_init(void)
+{
+    offset_t level, slot;
+
+    for (level = 0; level < OS_TIMER_WHEEL_LEVELS; level++) {
+        for (slot = 0; slot < OS_TIMER_WHEEL_SLOTS; slot++) {
+            os_list_init(&os_timer_wheel[level][slot]);
+        }
+    }
+
+    os_timer_wheel_tick  = os_tick_get();
+    os_timer_wheel_ready = TRUE;
+}
+
+/* hash an armed timer into its wheel slot, must be called with irq disabled */
+static void _os_timer_wheel_insert(os_timer_t *timer)
+{
+    os_tick_t delta;
+    os_tick_t expire;
+    offset_t  level;
+
+    if (os_timer_wheel_ready != TRUE)
+        _os_timer_wheel_init();
+
+    expire = timer->timeout_tick;
+    delta  = expire - os_timer_wheel_tick;
+
+    if ((int32_t)delta < 0) {
+        /* already late, fire on the next processed tick */
+        delta  = 0;
+        expire = os_timer_wheel_tick;
+    } else if (delta >= OS_TIMER_WHEEL_RANGE) {
+        /* park it in the farthest slot, it is re-hashed on cascade */
+        delta  = OS_TIMER_WHEEL_RANGE - 1;
+        expire = os_timer_wheel_tick + delta;
+    }
+
+    for (level = 0; level < OS_TIMER_WHEEL_LEVELS - 1; level++) {
+        if (delta < (1UL << (OS_TIMER_WHEEL_BITS * (level + 1))))
+            break;
+    }
+
+    os_list_insert_before(&os_timer_wheel[level][(expire >> (OS_TIMER_WHEEL_BITS * level)) & OS_TIMER_WHEEL_MASK],
+                          &(timer->list));
+}
+
+/* move all timers of the given upper level slot down the wheel */
+static void _os_timer_wheel_cascade(offset_t level, offset_t slot)
+{
+    os_list_t  list;
+    os_timer_t *timer;
+
+    os_list_init(&list);
+    if (os_list_isempty(&os_timer_wheel[level][slot]))
+        return;
+
+    /* detach the whole slot, then re-hash every timer of it */
+    os_list_insert_after(&os_timer_wheel[level][slot], &list);
+    os_list_remove(&os_timer_wheel[level][slot]);
+
+    while (!os_list_isempty(&list)) {
+        timer = OS_LIST_ENTRY(list.next, os_timer_t, list);
+        _os_timer_remove(timer);
+        _os_timer_wheel_insert(timer);
+    }
+}
+
+/*
+ * find the next tick the wheel has work at, the expiry of a level 0 slot or
+ * the cascade of an upper level slot, irq must be disabled
+ */
+static bool_t _os_timer_wheel_next(os_tick_t *next_tick)
+{
+    os_tick_t block_tick;
+    offset_t  level;
+    offset_t  offset;
+    offset_t  slot;
+    uint8_t   shift;
+    bool_t    found;
+
+    found = FALSE;
+
+    /* level 0 holds the exact expiry of the current turn */
+    for (offset = 0; offset < OS_TIMER_WHEEL_SLOTS; offset++) {
+        slot = (os_timer_wheel_tick + offset) & OS_TIMER_WHEEL_MASK;
+        if (!os_list_isempty(&os_timer_wheel[0][slot])) {
+            *next_tick = os_timer_wheel_tick + offset;
+            found      = TRUE;
+            break;
+        }
+    }
+
+    /* an upper level slot can not expire before it is cascaded */
+    for (level = 1; level < OS_TIMER_WHEEL_LEVELS; level++) {
+        shift = OS_TIMER_WHEEL_BITS * level;
+
+        /* the current slot was cascaded already, unless its turn starts now */
+        offset = (os_timer_wheel_tick & ((1UL << shift) - 1)) ? 1 : 0;
+
+        for (; offset <= OS_TIMER_WHEEL_SLOTS; offset++) {
+            slot = ((os_timer_wheel_tick >> shift) + offset) & OS_TIMER_WHEEL_MASK;
+            if (os_list_isempty(&os_timer_wheel[level][slot]))
+                continue;
+
+            block_tick = ((os_timer_wheel_tick >> shift) + offset) << shift;
+            if (found != TRUE ||
+                (int32_t)(block_tick - *next_tick) < 0) {
+                *next_tick = block_tick;
+                found      = TRUE;
+            }
+            break;
+        }
+    }
+
+    return found;
+}
+#endif
+
+#if !defined(OS_CFG_TIMER_WHEEL) || defined(OS_CFG_TIMER_SOFT)
+/* insert timer to a sorted timer list, irq must be disabled */
+static void _os_timer_list_insert(os_list_t *timer_list, os_timer_t *timer)
+{
+    struct os_list_node *n;
+
+    for (n = timer_list; n != timer_list->prev; n  = n->next) {
+        os_timer_t *timer_entry;
+
+        /* fix up the entry pointer */
+        timer_entry = OS_LIST_ENTRY(n->next, os_timer_t, list);
+
+        /* If we have two timers that timeout at the same time, it's
+         * preferred that the timer inserted early get called early.
+         * So insert the new timer to the end the the some-timeout timer
+         * list. A periodic timer behind its deadlines sorts before the
+         * current tick.
+         */
+        if ((int32_t)(timer_entry->timeout_tick - timer->timeout_tick) > 0)
+            break;
+    }
+
+    os_list_insert_after(n, &(timer->list));
+}
+#endif
+
+/* put an armed timer to its list, irq must be disabled, TRUE if timer task shall wake */
+static bool_t _os_timer_insert(os_timer_t *timer)
+{
+#ifdef OS_CFG_TIMER_SOFT
+    if (timer->flag & OS_TIMER_SOFT) {
+        /* insert timer to soft timer list */
+        _os_timer_list_insert(&os_soft_timer_list, timer);
+
+        /* the timer task sleeps until the head timer, re-arm it */
+        return os_soft_timer_list.next == &(timer->list);
+    }
+#endif
+
+#ifdef OS_CFG_TIMER_WHEEL
+    /* insert timer to its wheel slot */
+    _os_timer_wheel_insert(timer);
+#else
+    /* insert timer to system timer list */
+    _os_timer_list_insert(&os_timer_list, timer);
+#endif
+
+    return FALSE;
+}
+
 /**
  * @addtogroup Clock
  */
@@ -55,6 +256,7 @@ static void _os_timer_init(os_timer_t *timer,
     timer->startup_tick = 0;
     timer->timeout_tick = 0;
     timer->interval_tick    = time;
+    timer->overrun      = 0;
 
     /* initialize timer list */
     os_list_init(&(timer->list));
@@ -93,10 +295,10 @@ void os_timer_init(os_timer_t *timer,
  */
 os_err_t os_timer_start(os_timer_t *timer)
 {
-    os_list_t *timer_list;
+#ifdef OS_CFG_TIMER_SOFT
+    bool_t wakeup;
+#endif
     os_sr_t sr;
-    struct os_list_node *n;
-    os_tick_t current_tick;
 
     /* timer check */
     OS_ASSERT(timer != NULL);
@@ -111,35 +313,21 @@ os_err_t os_timer_start(os_timer_t *timer)
     timer->startup_tick = os_tick_get();
     timer->timeout_tick = timer->startup_tick + timer->interval_tick;
 
-    current_tick = os_tick_get();
-
-		/* insert timer to system timer list */
-		timer_list = &os_timer_list;
-
-    for (n = timer_list; n != timer_list->prev; n  = n->next) {
-        os_timer_t *timer_entry;
-
-        /* fix up the entry pointer */
-        timer_entry = OS_LIST_ENTRY(n->next, os_timer_t, list);
-
-        /* If we have two timers that timeout at the same time, it's
-         * preferred that the timer inserted early get called early.
-         * So insert the new timer to the end the the some-timeout timer
-         * list.
-         */
-        if ((timer_entry->timeout_tick - timer->timeout_tick) == 0) {
-            continue;
-        } else if ((timer_entry->timeout_tick - current_tick) > (timer->timeout_tick - current_tick)) {
-            break;
-        }
-    }
-
-    os_list_insert_after(n, &(timer->list));
+#ifdef OS_CFG_TIMER_SOFT
+    wakeup = _os_timer_insert(timer);
+#else
+    _os_timer_insert(timer);
+#endif
 
     timer->flag |= OS_TIMER_ACTIVATED;
 
     os_exit_critical(sr);
 
+#ifdef OS_CFG_TIMER_SOFT
+    if (wakeup == TRUE)
+        os_timer_task_wakeup();
+#endif
+
     return OS_OK;
 }
 
@@ -191,6 +379,84 @@ os_err_t os_timer_tick_get(os_timer_t *timer, os_tick_t *tick)
     return OS_OK;
 }
 
+/**
+ * This function will return the periods a periodic timer dropped since the
+ * previous invoking, the timer shall have OS_TIMER_OVERRUN_REPORT.
+ *
+ * @param timer the periodic timer
+ *
+ * @return the number of dropped periods
+ */
+uint32_t os_timer_overrun_get(os_timer_t *timer)
+{
+    uint32_t overrun;
+    os_sr_t sr;
+
+    /* timer check */
+    OS_ASSERT(timer != NULL);
+
+    sr = os_enter_critical();
+
+    overrun = timer->overrun;
+    timer->overrun = 0;
+
+    os_exit_critical(sr);
+
+    return overrun;
+}
+
+/**
+ * This function will start an expired periodic timer again. The next deadline
+ * is the previous one plus the period, so neither the time timeout function
+ * takes nor a late tick drifts it. If the next deadline passed too, the
+ * overrun policy of timer decides whether the missed periods fire at once or
+ * are dropped. A soft timer becoming the head of soft timers wakes the timer
+ * task to re-arm for it.
+ *
+ * @param timer the expired periodic timer, removed from its list
+ *
+ * @note this function shall be invoked with interrupt disabled.
+ */
+void os_timer_periodic_restart(os_timer_t *timer)
+{
+#ifdef OS_CFG_TIMER_SOFT
+    bool_t wakeup;
+#endif
+    os_tick_t late;
+    os_tick_t missed;
+
+    timer->startup_tick = timer->timeout_tick;
+    timer->timeout_tick = timer->startup_tick + timer->interval_tick;
+
+    late = os_tick_get() - timer->timeout_tick;
+    if ((int32_t)late > 0 && timer->interval_tick != 0 &&
+        (timer->flag & OS_TIMER_OVERRUN_MASK) != OS_TIMER_OVERRUN_CATCHUP) {
+        /* move to the first deadline not passed, the phase is kept */
+        missed = (late - 1) / timer->interval_tick + 1;
+
+        timer->startup_tick += missed * timer->interval_tick;
+        timer->timeout_tick += missed * timer->interval_tick;
+
+        if ((timer->flag & OS_TIMER_OVERRUN_MASK) == OS_TIMER_OVERRUN_REPORT)
+            timer->overrun += missed;
+
+        OS_DEBUG_LOG(OS_DEBUG_TIMER, ("timer overrun %d periods\n", missed));
+    }
+
+#ifdef OS_CFG_TIMER_SOFT
+    wakeup = _os_timer_insert(timer);
+#else
+    _os_timer_insert(timer);
+#endif
+
+    timer->flag |= OS_TIMER_ACTIVATED;
+
+#ifdef OS_CFG_TIMER_SOFT
+    if (wakeup == TRUE)
+        os_timer_task_wakeup();
+#endif
+}
+
 /**
  * This function will detach a timer from timer management.
  *
@@ -214,6 +480,140 @@ os_err_t os_timer_delete(os_timer_t *timer)
     return OS_OK;
 }
 
+/**
+ * This function will return the number of ticks until the next timer
+ * expires. The value may be earlier than the real expiry, never later.
+ *
+ * @return the ticks to the next timeout, 0 if a timer is already due or
+ *         OS_WAIT_FOREVER if no timer is active.
+ *
+ * @note this function shall be invoked with interrupt disabled.
+ */
+os_tick_t os_timer_next_timeout_tick(void)
+{
+    os_tick_t current_tick;
+    os_tick_t next_tick;
+    bool_t    found;
+#ifndef OS_CFG_TIMER_WHEEL
+    os_timer_t *timer;
+#endif
+
+    current_tick = os_tick_get();
+    next_tick    = 0;
+    found        = FALSE;
+
+#ifdef OS_CFG_TIMER_WHEEL
+    if (os_timer_wheel_ready != TRUE)
+        return OS_WAIT_FOREVER;
+
+    found = _os_timer_wheel_next(&next_tick);
+#else
+    if (!os_list_isempty(&os_timer_list)) {
+        timer = OS_LIST_ENTRY(os_timer_list.next, os_timer_t, list);
+        next_tick = timer->timeout_tick;
+        found     = TRUE;
+    }
+#endif
+
+    if (found != TRUE)
+        return OS_WAIT_FOREVER;
+
+    if ((int32_t)(next_tick - current_tick) <= 0)
+        return 0;
+
+    return next_tick - current_tick;
+}
+
+#ifdef OS_CFG_TIMER_WHEEL
+/* invoke the timeout function of an expired timer, irq must be disabled */
+static void _os_timer_expire(os_timer_t *timer)
+{
+    /* call timeout function */
+    OS_TRACE(OS_TRACE_TIMER, 0, timer, timer->timeout_func);
+    timer->timeout_func(timer->parameter);
+
+    if ((timer->flag & OS_TIMER_PERIODIC) &&
+        (timer->flag & OS_TIMER_ACTIVATED)) {
+        /* start it at the next deadline */
+        timer->flag &= ~OS_TIMER_ACTIVATED;
+        os_timer_periodic_restart(timer);
+    } else {
+        /* stop timer */
+        timer->flag &= ~OS_TIMER_ACTIVATED;
+    }
+}
+
+/**
+ * This function will advance the timing wheel up to the current tick, every
+ * timer hashed in a passed slot is expired and its timeout function invoked.
+ * Catching up many ticks after tickless idle, the wheel jumps from one slot
+ * with work to the next, the empty ones are skipped.
+ *
+ * @note this function shall be invoked in operating system timer interrupt.
+ */
+void os_timer_check(void)
+{
+    os_list_t  expired;
+    os_timer_t *timer;
+    os_tick_t  next_tick;
+    offset_t   level;
+    offset_t   slot;
+    os_sr_t    sr;
+
+    OS_DEBUG_LOG(OS_DEBUG_TIMER, ("timer check enter\n"));
+
+    sr = os_enter_critical();
+
+    if (os_timer_wheel_ready != TRUE)
+        _os_timer_wheel_init();
+
+    os_list_init(&expired);
+
+    while ((int32_t)(os_tick_get() - os_timer_wheel_tick) >= 0) {
+        slot = os_timer_wheel_tick & OS_TIMER_WHEEL_MASK;
+
+        /* behind and nothing due now, jump to the next work or past now */
+        if (os_timer_wheel_tick != os_tick_get() &&
+            os_list_isempty(&os_timer_wheel[0][slot])) {
+            if (_os_timer_wheel_next(&next_tick) != TRUE ||
+                (int32_t)(next_tick - os_tick_get()) > 0) {
+                os_timer_wheel_tick = os_tick_get() + 1;
+                break;
+            }
+
+            os_timer_wheel_tick = next_tick;
+            slot = os_timer_wheel_tick & OS_TIMER_WHEEL_MASK;
+        }
+
+        /* level 0 wraps, pull the next turn down from the upper levels */
+        for (level = 1; slot == 0 && level < OS_TIMER_WHEEL_LEVELS; level++) {
+            slot = (os_timer_wheel_tick >> (OS_TIMER_WHEEL_BITS * level)) & OS_TIMER_WHEEL_MASK;
+            _os_timer_wheel_cascade(level, slot);
+        }
+        slot = os_timer_wheel_tick & OS_TIMER_WHEEL_MASK;
+
+        /* detach the due slot, timers re-armed from a callback go to a later one */
+        if (!os_list_isempty(&os_timer_wheel[0][slot])) {
+            os_list_insert_after(&os_timer_wheel[0][slot], &expired);
+            os_list_remove(&os_timer_wheel[0][slot]);
+        }
+        os_timer_wheel_tick++;
+
+        while (!os_list_isempty(&expired)) {
+            timer = OS_LIST_ENTRY(expired.next, os_timer_t, list);
+
+            /* remove timer from the expired list firstly */
+            _os_timer_remove(timer);
+
+            _os_timer_expire(timer);
+        }
+    }
+
+    os_exit_critical(sr);
+
+    OS_DEBUG_LOG(OS_DEBUG_TIMER, ("timer check leave\n"));
+}
+#else
 /**
  * This function will check timer list, if a timeout event happens, the
  * corresponding timeout function will be invoked.
@@ -223,7 +623,6 @@ os_err_t os_timer_delete(os_timer_t *timer)
 void os_timer_check(void)
 {
     os_tick_t current_tick;
-    struct os_list_node *n;
     os_timer_t *timer;
     os_sr_t sr;
 
@@ -233,20 +632,19 @@ void os_timer_check(void)
 
     current_tick = os_tick_get();
 
-    for (n = os_timer_list.next; n != &os_timer_list;) {
-        timer = OS_LIST_ENTRY(n, os_timer_t, list);
+    /* from the head each time, a periodic timer behind comes back before it */
+    while (!os_list_isempty(&os_timer_list)) {
+        timer = OS_LIST_ENTRY(os_timer_list.next, os_timer_t, list);
 
         /* the timer not timeout */
         if ((current_tick -timer->startup_tick) < timer->interval_tick)
             break;
 
-        /* move node to the next */
-        n = n->next;
-
         /* remove timer from timer list firstly */
         _os_timer_remove(timer);
 
         /* call timeout function */
+        OS_TRACE(OS_TRACE_TIMER, 0, timer, timer->timeout_func);
         timer->timeout_func(timer->parameter);
 
         /* re-get tick */
@@ -255,9 +653,9 @@ void os_timer_check(void)
 
         if ((timer->flag & OS_TIMER_PERIODIC) &&
             (timer->flag & OS_TIMER_ACTIVATED)) {
-            /* start it */
+            /* start it at the next deadline */
             timer->flag &= ~OS_TIMER_ACTIVATED;
-            os_timer_start(timer);
+            os_timer_periodic_restart(timer);
         } else {
             /* stop timer */
             timer->flag &= ~OS_TIMER_ACTIVATED;
@@ -268,3 +666,4 @@ void os_timer_check(void)
 
     OS_DEBUG_LOG(OS_DEBUG_TIMER, ("timer check leave\n"));
 }
+#endif
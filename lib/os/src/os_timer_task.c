@@ -0,0 +1,209 @@
+/*
+ * File      : os_timer_task.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      trace timer fire
+ * 2026-10-17     kontais      periodic timer keeps its deadlines
+ * 2026-10-17     kontais      wake timer task only when it waits for timers
+ */
+
+#include <os.h>
+
+#ifdef OS_CFG_TIMER_SOFT
+
+#ifndef OS_TIMER_TASK_PRIO
+#define OS_TIMER_TASK_PRIO        4
+#endif
+
+#ifndef OS_TIMER_TASK_STACK_SIZE
+#define OS_TIMER_TASK_STACK_SIZE  512
+#endif
+
+/* soft timer list, sorted by timeout tick */
+os_list_t os_soft_timer_list = OS_LIST_INIT(os_soft_timer_list);
+
+static os_task_t timer_task;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t os_timer_task_stack[OS_TIMER_TASK_STACK_SIZE];
+
+/* timer task waits for the head soft timer, not blocked in a callback */
+static bool_t timer_task_waiting;
+
+void _os_timer_remove(os_timer_t *timer);
+
+/* return the ticks to the head soft timer, irq must be disabled */
+static os_tick_t _os_soft_timer_next_timeout(void)
+{
+    os_timer_t *timer;
+    os_tick_t current_tick;
+
+    if (os_list_isempty(&os_soft_timer_list))
+        return OS_WAIT_FOREVER;
+
+    timer = OS_LIST_ENTRY(os_soft_timer_list.next, os_timer_t, list);
+
+    current_tick = os_tick_get();
+    if ((current_tick - timer->startup_tick) >= timer->interval_tick)
+        return 0;
+
+    return timer->timeout_tick - current_tick;
+}
+
+/*
+ * This function will check soft timer list, the timeout function of every
+ * expired timer is invoked in timer task with interrupt enabled.
+ */
+static void _os_soft_timer_check(void)
+{
+    os_tick_t current_tick;
+    os_timer_t *timer;
+    os_sr_t sr;
+
+    OS_DEBUG_LOG(OS_DEBUG_TIMER, ("soft timer check enter\n"));
+
+    sr = os_enter_critical();
+
+    current_tick = os_tick_get();
+
+    while (!os_list_isempty(&os_soft_timer_list)) {
+        timer = OS_LIST_ENTRY(os_soft_timer_list.next, os_timer_t, list);
+
+        /* the timer not timeout */
+        if ((current_tick - timer->startup_tick) < timer->interval_tick)
+            break;
+
+        /* remove timer from timer list firstly */
+        _os_timer_remove(timer);
+
+        os_exit_critical(sr);
+
+        /* call timeout function */
+        OS_TRACE(OS_TRACE_TIMER, 0, timer, timer->timeout_func);
+        timer->timeout_func(timer->parameter);
+
+        sr = os_enter_critical();
+
+        /* re-get tick */
+        current_tick = os_tick_get();
+        OS_DEBUG_LOG(OS_DEBUG_TIMER, ("current tick: %d\n", current_tick));
+
+        if ((timer->flag & OS_TIMER_PERIODIC) &&
+            (timer->flag & OS_TIMER_ACTIVATED)) {
+            /* start it at the next deadline */
+            timer->flag &= ~OS_TIMER_ACTIVATED;
+            os_timer_periodic_restart(timer);
+        } else {
+            /* stop timer */
+            timer->flag &= ~OS_TIMER_ACTIVATED;
+        }
+    }
+
+    os_exit_critical(sr);
+
+    OS_DEBUG_LOG(OS_DEBUG_TIMER, ("soft timer check leave\n"));
+}
+
+static void os_task_timer_entry(void *parameter)
+{
+    os_tick_t next_timeout;
+    os_sr_t sr;
+
+    while (1) {
+        sr = os_enter_critical();
+
+        /* get the next timeout and suspend atomically, so no wakeup is lost */
+        next_timeout = _os_soft_timer_next_timeout();
+        if (next_timeout != 0) {
+            os_task_suspend(&timer_task);
+            timer_task_waiting = TRUE;
+
+            if (next_timeout != OS_WAIT_FOREVER) {
+                os_timer_tick_set(&(timer_task.timer), next_timeout);
+                os_timer_start(&(timer_task.timer));
+            }
+        }
+
+        os_exit_critical(sr);
+
+        if (next_timeout != 0) {
+            os_sched();
+
+            /* woken by its timer or os_timer_task_wakeup */
+            sr = os_enter_critical();
+            timer_task_waiting = FALSE;
+            os_exit_critical(sr);
+        }
+
+        _os_soft_timer_check();
+    }
+}
+
+/**
+ * @ingroup Clock
+ *
+ * This function will wake up the timer task if it is sleeping, so that it
+ * can re-arm for a new head of soft timer list.
+ *
+ * @note a callback blocked in the timer task is left in its wait.
+ */
+void os_timer_task_wakeup(void)
+{
+    os_sr_t sr;
+    bool_t resumed;
+
+    sr = os_enter_critical();
+
+    resumed = FALSE;
+    if (timer_task_waiting == TRUE && timer_task.stat == OS_TASK_SUSPEND) {
+        timer_task_waiting = FALSE;
+        os_task_resume(&timer_task);
+        resumed = TRUE;
+    }
+
+    os_exit_critical(sr);
+
+    if (resumed == TRUE)
+        os_sched();
+}
+
+/**
+ * @ingroup SystemInit
+ *
+ * This function will initialize soft timer task, then start it.
+ *
+ * @note this function must be invoked when system init.
+ */
+void os_init_timer_task(void)
+{
+    /* initialize task */
+    os_task_init(&timer_task,
+                   "timer",
+                   os_task_timer_entry,
+                   NULL,
+                   &os_timer_task_stack[0],
+                   sizeof(os_timer_task_stack),
+                   OS_TIMER_TASK_PRIO,
+                   10);
+
+    /* startup */
+    os_task_startup(&timer_task);
+}
+#endif
@@ -0,0 +1,160 @@
+/*
+ * File      : os_trace.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2012, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      walk the tasks under the registry lock
+ */
+
+#include <os.h>
+
+#ifdef OS_CFG_TRACE
+
+#if (OS_TRACE_EVENTS & (OS_TRACE_EVENTS - 1)) != 0
+#error "OS_TRACE_EVENTS shall be a power of two"
+#endif
+
+extern os_list_t os_task_registry;
+
+struct os_trace_buffer os_trace_buffer;
+
+/*
+ * This function will record the name of every task, so that a dump names
+ * the tasks in it even if their creation is overwritten in the ring.
+ */
+static void _os_trace_task_names(void)
+{
+    os_list_t *node;
+    os_task_t *task;
+    uint32_t  chars;
+    uint16_t  offset;
+
+    os_task_registry_lock();
+
+    for (node = os_task_registry.next;
+         node != &os_task_registry;
+         node = node->next) {
+        task = OS_LIST_ENTRY(node, os_task_t, rlist);
+
+        for (offset = 0; offset < OS_NAME_MAX; offset += 4) {
+            chars = 0;
+            memcpy(&chars, &task->name[offset],
+                   OS_NAME_MAX - offset < 4 ? OS_NAME_MAX - offset : 4);
+            os_trace_record(OS_TRACE_TASK_NAME, offset, (uint32_t)task, chars);
+        }
+    }
+
+    os_task_registry_unlock();
+}
+
+/**
+ * This function will record one event into the trace ring buffer, the
+ * oldest event is overwritten when the buffer is full.
+ *
+ * @param type the event type
+ * @param arg the argument of event
+ * @param object the object of event
+ * @param data the data of event
+ *
+ * @note please use OS_TRACE, which costs nothing when tracing is stopped.
+ */
+void os_trace_record(uint8_t type, uint16_t arg, uint32_t object, uint32_t data)
+{
+    os_trace_event_t *event;
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    event = &os_trace_buffer.event[os_trace_buffer.index++ & (OS_TRACE_EVENTS - 1)];
+
+    event->stamp  = os_arch_cycle_get();
+    event->type   = type;
+    event->nest   = os_isr_nest;
+    event->arg    = arg;
+    event->object = object;
+    event->data   = data;
+
+    os_exit_critical(sr);
+}
+
+/**
+ * @addtogroup Kernel
+ */
+
+/*@{*/
+
+/**
+ * This function will clear the trace buffer and start recording. The
+ * stamps are taken from cycle counter, which starts with the scheduler.
+ */
+void os_trace_start(void)
+{
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    os_trace_buffer.magic      = OS_TRACE_MAGIC;
+    os_trace_buffer.version    = OS_TRACE_VERSION;
+    os_trace_buffer.event_size = sizeof(os_trace_event_t);
+    os_trace_buffer.events     = OS_TRACE_EVENTS;
+    os_trace_buffer.index      = 0;
+    os_trace_buffer.cycle_hz   = OS_TRACE_CYCLE_HZ;
+    os_trace_buffer.enable     = 1;
+
+    os_exit_critical(sr);
+
+    _os_trace_task_names();
+}
+
+/**
+ * This function will stop recording, the buffer is kept for dump.
+ */
+void os_trace_stop(void)
+{
+    os_trace_buffer.enable = 0;
+}
+
+/**
+ * This function will write the whole trace buffer through an output
+ * function, the same bytes as a memory image of os_trace_buffer. Recording
+ * pauses while the buffer is written out.
+ *
+ * @param output the function writing out a piece of data
+ */
+void os_trace_dump(void (*output)(const void *data, uint32_t size))
+{
+    uint32_t enable;
+
+    OS_ASSERT(output != NULL);
+
+    if (os_trace_buffer.enable)
+        _os_trace_task_names();
+
+    enable = os_trace_buffer.enable;
+    os_trace_buffer.enable = 0;
+
+    output(&os_trace_buffer, sizeof(os_trace_buffer));
+
+    os_trace_buffer.enable = enable;
+}
+
+/*@}*/
+
+#endif
@@ -0,0 +1,19 @@
+/*
+ * File      : application.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2016-12-06     kontais      kontais@aliyun.com
+ */
+#ifndef _APPLICATION_H_
+#define _APPLICATION_H_
+
+void application_init(void);
+
+#endif /* _APPLICATION_H_ */
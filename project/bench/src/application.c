@@ -0,0 +1,61 @@
+/*
+ * File      : application.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2016-12-06     kontais      kontais@aliyun.com
+ */
+#include <os.h>
+
+#define INIT_TASK_STACK_SIZE    256
+static os_task_t init;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t init_task_stack[INIT_TASK_STACK_SIZE];
+
+void os_task_init_cleanup(os_task_t *task)
+{
+    printf("os_task_init_cleanup\n");
+}
+
+
+void tm_main(void);
+
+void os_task_init_entry(void* parameter)
+{
+    os_task_t *task;
+
+    task = os_task_self();
+    task->cleanup = os_task_init_cleanup;
+
+    tm_main();
+}
+
+int application_init(void)
+{
+    uint32_t os_ver;
+
+    os_ver = os_version_get();
+
+    printf("os verion %d.%d.%d\n", 
+                OS_VER_MAJOR(os_ver),
+                OS_VER_MINOR(os_ver),
+                OS_VER_REVISION(os_ver));
+
+    os_task_init(&init,
+                    "init",
+                    os_task_init_entry,
+                    NULL,
+                    &init_task_stack[0],
+                    INIT_TASK_STACK_SIZE,
+                    OS_TASK_PRIORITY_MAX/3,
+                    20);
+    os_task_startup(&init);
+
+    return 0;
+}
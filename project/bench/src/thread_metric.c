@@ -0,0 +1,716 @@
+/*
+ * File      : thread_metric.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      add uncontended sem and mutex tests
+ * 2026-10-17     kontais      add tm_done hook for the simulator
+ * 2026-10-17     kontais      move tasks above the EDF band
+ * 2026-10-17     kontais      add priority ceiling mutex and scheduler lock tests
+ * 2026-10-17     kontais      add mixed fpu switch tests
+ * 2026-10-17     kontais      add priority ceiling mutex at own priority
+ */
+
+/*
+ * Kernel benchmark in the way of Thread-Metric. Every test runs its tasks for
+ * TM_TEST_REPORTS periods of TM_TEST_PERIOD ticks, and a report task prints
+ * the operations done in each period. Higher is better.
+ *
+ * The report is one CSV line a period, prefixed by "tm," to be picked out of
+ * console output:
+ *
+ *   tm,<test>,<period>,<ticks>,<operations>
+ *
+ * and "tm,done" after the last test.
+ */
+
+#include <os.h>
+
+#ifndef TM_TEST_PERIOD
+#define TM_TEST_PERIOD          (OS_TICKS_PER_SEC * 5)
+#endif
+
+#ifndef TM_TEST_REPORTS
+#define TM_TEST_REPORTS         3
+#endif
+
+#define TM_TASKS_MAX            5
+#define TM_TASK_STACK_SIZE      512
+#define TM_REPORT_PRIO          2
+/* the tasks of a test stay clear of OS_SCHED_EDF_PRIO */
+#define TM_TASK_PRIO            16              /* lowest priority of a test, tasks above it */
+#define TM_MSG_SIZE             16              /* 4 words as Thread-Metric */
+#define TM_MSG_COUNT            4
+#define TM_BLOCK_SIZE           128
+#define TM_BLOCK_COUNT          8
+
+struct tm_test
+{
+    const char *name;
+    void (*start)(void);
+    void (*stop)(void);                         /* wake the tasks blocked, may be NULL, called again until they return */
+};
+
+static os_task_t tm_task[TM_TASKS_MAX];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tm_task_stack[TM_TASKS_MAX][TM_TASK_STACK_SIZE];
+
+static os_task_t tm_report;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tm_report_stack[TM_TASK_STACK_SIZE];
+
+/* operations counted by test tasks, summed by report task */
+static volatile uint32_t tm_counter[TM_TASKS_MAX];
+static volatile bool_t tm_stop;
+
+static os_sem_t tm_sem[2];
+static os_mutex_t tm_mutex;
+static os_pcmutex_t tm_pcmutex;
+static os_mqueue_t tm_mq[2];
+static os_mbox_t tm_mb[2];
+static os_mpool_t tm_mp;
+static os_timer_t tm_timer;
+
+/* a message takes a link pointer besides its data */
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tm_mq_pool[2][TM_MSG_COUNT * (TM_MSG_SIZE + sizeof(void *))];
+static uint32_t tm_mb_pool[2][TM_MSG_COUNT];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tm_mp_pool[TM_BLOCK_COUNT * (TM_BLOCK_SIZE + sizeof(uint8_t *))];
+
+static void tm_task_init(uint32_t index,
+                         void (*entry)(void *parameter),
+                         uint8_t priority)
+{
+    char name[] = "tm0";
+
+    name[2] = '0' + index;
+
+    os_task_init(&tm_task[index],
+                 name,
+                 entry,
+                 (void *)index,
+                 &tm_task_stack[index][0],
+                 TM_TASK_STACK_SIZE,
+                 priority,
+                 20);
+}
+
+static void tm_task_create(uint32_t index,
+                           void (*entry)(void *parameter),
+                           uint8_t priority)
+{
+    tm_task_init(index, entry, priority);
+    os_task_startup(&tm_task[index]);
+}
+
+/*
+ * cooperative scheduling, 5 tasks of same priority yield in a round
+ */
+static void tm_cooperative_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+
+    while (tm_stop == FALSE) {
+        tm_counter[index]++;
+        os_task_yield();
+    }
+}
+
+static void tm_cooperative_start(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < TM_TASKS_MAX; i++)
+        tm_task_create(i, tm_cooperative_entry, TM_TASK_PRIO);
+}
+
+/*
+ * preemptive scheduling, 5 tasks of rising priority, each resumes the next
+ * one which preempts it, the highest suspends and the chain unwinds
+ */
+static void tm_preemptive_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+
+    while (tm_stop == FALSE) {
+        tm_counter[index]++;
+
+        if (index < TM_TASKS_MAX - 1)
+            os_task_resume(&tm_task[index + 1]);
+
+        if (index > 0 && tm_stop == FALSE) {
+            os_task_suspend(os_task_self());
+            os_sched();
+        }
+    }
+}
+
+static void tm_preemptive_start(void)
+{
+    uint32_t i;
+
+    /* the higher ones are created first, they suspend at once */
+    for (i = TM_TASKS_MAX; i > 0; i--) {
+        tm_task_create(i - 1, tm_preemptive_entry, TM_TASK_PRIO - i + 1);
+        if (i > 1)
+            os_task_suspend(&tm_task[i - 1]);
+    }
+}
+
+/*
+ * interrupt processing, an interrupt gives a semaphore and wakes a higher
+ * priority task, which preempts the raising task at interrupt exit
+ */
+static void tm_interrupt_handler(void)
+{
+    os_sem_give(&tm_sem[0]);
+}
+
+/**
+ * This function will raise the benchmark interrupt. A board with a spare
+ * interrupt overrides it to pend a real one, the default runs the handler
+ * inside os_isr_enter and os_isr_leave as an interrupt does.
+ */
+WEAK void tm_interrupt_raise(void)
+{
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+
+    os_isr_enter();
+    tm_interrupt_handler();
+    os_isr_leave();
+
+    os_exit_critical(sr);
+}
+
+static void tm_interrupt_waiter_entry(void *parameter)
+{
+    while (os_sem_take(&tm_sem[0], OS_WAIT_FOREVER) == OS_OK &&
+           tm_stop == FALSE)
+        tm_counter[1]++;
+}
+
+static void tm_interrupt_raiser_entry(void *parameter)
+{
+    while (tm_stop == FALSE)
+        tm_interrupt_raise();
+}
+
+static void tm_interrupt_start(void)
+{
+    os_sem_init(&tm_sem[0], 0, OS_IPC_PRIO);
+
+    tm_task_create(1, tm_interrupt_waiter_entry, TM_TASK_PRIO - 1);
+    tm_task_create(0, tm_interrupt_raiser_entry, TM_TASK_PRIO);
+}
+
+static void tm_interrupt_stop(void)
+{
+    os_sem_give(&tm_sem[0]);
+}
+
+/*
+ * semaphore ping-pong, two tasks give each other a semaphore
+ */
+static void tm_sem_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+
+    /* the first round is started by task 0 */
+    if (index == 0)
+        os_sem_give(&tm_sem[1]);
+
+    while (os_sem_take(&tm_sem[index], OS_WAIT_FOREVER) == OS_OK &&
+           tm_stop == FALSE) {
+        tm_counter[index]++;
+        os_sem_give(&tm_sem[index ^ 1]);
+    }
+}
+
+static void tm_sem_start(void)
+{
+    os_sem_init(&tm_sem[0], 0, OS_IPC_PRIO);
+    os_sem_init(&tm_sem[1], 0, OS_IPC_PRIO);
+
+    tm_task_create(1, tm_sem_entry, TM_TASK_PRIO);
+    tm_task_create(0, tm_sem_entry, TM_TASK_PRIO);
+}
+
+static void tm_sem_stop(void)
+{
+    os_sem_give(&tm_sem[0]);
+    os_sem_give(&tm_sem[1]);
+}
+
+/*
+ * mutex ping-pong, two tasks of same priority hand the mutex over, each
+ * yields while holding it so the other blocks on it
+ */
+static void tm_mutex_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+
+    while (os_mutex_take(&tm_mutex, OS_WAIT_FOREVER) == OS_OK) {
+        if (tm_stop == TRUE) {
+            os_mutex_release(&tm_mutex);
+            break;
+        }
+
+        tm_counter[index]++;
+        os_task_yield();
+        os_mutex_release(&tm_mutex);
+    }
+}
+
+static void tm_mutex_start(void)
+{
+    os_mutex_init(&tm_mutex, OS_IPC_PRIO);
+
+    tm_task_create(0, tm_mutex_entry, TM_TASK_PRIO);
+    tm_task_create(1, tm_mutex_entry, TM_TASK_PRIO);
+}
+
+/*
+ * uncontended semaphore, one task takes and gives a semaphore nobody waits on
+ */
+static void tm_sem_lock_entry(void *parameter)
+{
+    while (tm_stop == FALSE) {
+        os_sem_take(&tm_sem[0], OS_WAIT_FOREVER);
+        os_sem_give(&tm_sem[0]);
+
+        tm_counter[0]++;
+    }
+}
+
+static void tm_sem_lock_start(void)
+{
+    os_sem_init(&tm_sem[0], 1, OS_IPC_PRIO);
+
+    tm_task_create(0, tm_sem_lock_entry, TM_TASK_PRIO);
+}
+
+/*
+ * uncontended mutex, one task takes and releases a mutex nobody waits on
+ */
+static void tm_mutex_lock_entry(void *parameter)
+{
+    while (tm_stop == FALSE) {
+        os_mutex_take(&tm_mutex, OS_WAIT_FOREVER);
+        os_mutex_release(&tm_mutex);
+
+        tm_counter[0]++;
+    }
+}
+
+static void tm_mutex_lock_start(void)
+{
+    os_mutex_init(&tm_mutex, OS_IPC_PRIO);
+
+    tm_task_create(0, tm_mutex_lock_entry, TM_TASK_PRIO);
+}
+
+/*
+ * priority ceiling mutex, one task locks and unlocks it, raised above its
+ * own priority each time
+ */
+static void tm_pcmutex_lock_entry(void *parameter)
+{
+    while (tm_stop == FALSE) {
+        os_pcmutex_lock(&tm_pcmutex);
+        os_pcmutex_unlock(&tm_pcmutex);
+
+        tm_counter[0]++;
+    }
+}
+
+static void tm_pcmutex_lock_start(void)
+{
+    os_pcmutex_init(&tm_pcmutex, TM_TASK_PRIO - 1);
+
+    tm_task_create(0, tm_pcmutex_lock_entry, TM_TASK_PRIO);
+}
+
+/*
+ * priority ceiling mutex at the own priority of the task, which is never
+ * requeued nor rescheduled
+ */
+static void tm_pcmutex_own_start(void)
+{
+    os_pcmutex_init(&tm_pcmutex, TM_TASK_PRIO);
+
+    tm_task_create(0, tm_pcmutex_lock_entry, TM_TASK_PRIO);
+}
+
+/*
+ * scheduler lock, one task locks and unlocks the scheduler
+ */
+static void tm_sched_lock_entry(void *parameter)
+{
+    while (tm_stop == FALSE) {
+        os_sched_lock();
+        os_sched_unlock();
+
+        tm_counter[0]++;
+    }
+}
+
+static void tm_sched_lock_start(void)
+{
+    tm_task_create(0, tm_sched_lock_entry, TM_TASK_PRIO);
+}
+
+/*
+ * message queue ping-pong, a message of 4 words goes back and forth
+ */
+static void tm_mqueue_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+    uint32_t msg[TM_MSG_SIZE / 4] = {0};
+
+    if (index == 0)
+        os_mqueue_put(&tm_mq[1], msg, sizeof(msg));
+
+    while (os_mqueue_get(&tm_mq[index], msg, sizeof(msg),
+                         OS_WAIT_FOREVER) == OS_OK &&
+           tm_stop == FALSE) {
+        tm_counter[index]++;
+        msg[0]++;
+        os_mqueue_put(&tm_mq[index ^ 1], msg, sizeof(msg));
+    }
+}
+
+static void tm_mqueue_start(void)
+{
+    os_mqueue_init(&tm_mq[0], tm_mq_pool[0], TM_MSG_SIZE,
+                   sizeof(tm_mq_pool[0]), OS_IPC_PRIO);
+    os_mqueue_init(&tm_mq[1], tm_mq_pool[1], TM_MSG_SIZE,
+                   sizeof(tm_mq_pool[1]), OS_IPC_PRIO);
+
+    tm_task_create(1, tm_mqueue_entry, TM_TASK_PRIO);
+    tm_task_create(0, tm_mqueue_entry, TM_TASK_PRIO);
+}
+
+static void tm_mqueue_stop(void)
+{
+    uint32_t msg[TM_MSG_SIZE / 4] = {0};
+
+    os_mqueue_put(&tm_mq[0], msg, sizeof(msg));
+    os_mqueue_put(&tm_mq[1], msg, sizeof(msg));
+}
+
+/*
+ * mailbox ping-pong, a word goes back and forth
+ */
+static void tm_mbox_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+    uint32_t value = 0;
+
+    if (index == 0)
+        os_mbox_put(&tm_mb[1], value);
+
+    while (os_mbox_get(&tm_mb[index], &value, OS_WAIT_FOREVER) == OS_OK &&
+           tm_stop == FALSE) {
+        tm_counter[index]++;
+        os_mbox_put(&tm_mb[index ^ 1], value + 1);
+    }
+}
+
+static void tm_mbox_start(void)
+{
+    os_mbox_init(&tm_mb[0], tm_mb_pool[0], TM_MSG_COUNT, OS_IPC_PRIO);
+    os_mbox_init(&tm_mb[1], tm_mb_pool[1], TM_MSG_COUNT, OS_IPC_PRIO);
+
+    tm_task_create(1, tm_mbox_entry, TM_TASK_PRIO);
+    tm_task_create(0, tm_mbox_entry, TM_TASK_PRIO);
+}
+
+static void tm_mbox_stop(void)
+{
+    os_mbox_put(&tm_mb[0], 0);
+    os_mbox_put(&tm_mb[1], 0);
+}
+
+/*
+ * memory pool, one task allocates and frees a block
+ */
+static void tm_mpool_entry(void *parameter)
+{
+    void *block;
+
+    while (tm_stop == FALSE) {
+        block = os_mpool_alloc(&tm_mp, 0);
+        OS_ASSERT(block != NULL);
+        os_mpool_free(block);
+
+        tm_counter[0]++;
+    }
+}
+
+static void tm_mpool_start(void)
+{
+    os_mpool_init(&tm_mp, tm_mp_pool, sizeof(tm_mp_pool), TM_BLOCK_SIZE);
+
+    tm_task_create(0, tm_mpool_entry, TM_TASK_PRIO);
+}
+
+#ifdef OS_CFG_HEAP
+/*
+ * heap, one task allocates and frees a block
+ */
+static void tm_malloc_entry(void *parameter)
+{
+    void *block;
+
+    while (tm_stop == FALSE) {
+        block = os_malloc(TM_BLOCK_SIZE);
+        OS_ASSERT(block != NULL);
+        os_free(block);
+
+        tm_counter[0]++;
+    }
+}
+
+static void tm_malloc_start(void)
+{
+    tm_task_create(0, tm_malloc_entry, TM_TASK_PRIO);
+}
+#endif
+
+/*
+ * timer arm, one task starts and stops a timer which never expires
+ */
+static void tm_timer_timeout(void *parameter)
+{
+}
+
+static void tm_timer_entry(void *parameter)
+{
+    while (tm_stop == FALSE) {
+        os_timer_start(&tm_timer);
+        os_timer_stop(&tm_timer);
+
+        tm_counter[0]++;
+    }
+}
+
+static void tm_timer_start(void)
+{
+    os_timer_init(&tm_timer, tm_timer_timeout, NULL,
+                  TM_TEST_PERIOD * 2, 0);
+
+    tm_task_create(0, tm_timer_entry, TM_TASK_PRIO);
+}
+
+static void tm_timer_stop(void)
+{
+    os_timer_stop(&tm_timer);
+}
+
+#ifdef OS_CFG_TASK_FPU
+/*
+ * fpu switch, 4 tasks of same priority yield in a round as cooperative, an
+ * FPU task adds to a float each turn. The FPU tasks are none, the first one,
+ * every other one or all, the registers are saved and loaded on a switch
+ * only when another FPU task takes the FPU:
+ *
+ *   fpu_none   no FPU task, the FPU is disabled on every switch
+ *   fpu_one    one FPU task, it keeps the FPU, nothing is saved
+ *   fpu_mixed  FPU and non FPU tasks in turn, a save and load every other switch
+ *   fpu_all    all FPU tasks, a save and load on every switch
+ */
+#define TM_FPU_TASKS            4
+
+static volatile float tm_fpu_value[TM_FPU_TASKS];
+
+static void tm_fpu_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+    bool_t fpu = (tm_task[index].flags & OS_TASK_FLAG_FPU) ? TRUE : FALSE;
+
+    while (tm_stop == FALSE) {
+        if (fpu == TRUE)
+            tm_fpu_value[index] += 1.0f;
+
+        tm_counter[index]++;
+        os_task_yield();
+    }
+}
+
+static void tm_fpu_start(uint32_t mask)
+{
+    uint32_t i;
+
+    for (i = 0; i < TM_FPU_TASKS; i++) {
+        tm_task_init(i, tm_fpu_entry, TM_TASK_PRIO);
+        if (mask & (1UL << i))
+            os_task_fpu_enable(&tm_task[i]);
+        os_task_startup(&tm_task[i]);
+    }
+}
+
+static void tm_fpu_none_start(void)
+{
+    tm_fpu_start(0x0);
+}
+
+static void tm_fpu_one_start(void)
+{
+    tm_fpu_start(0x1);
+}
+
+static void tm_fpu_mixed_start(void)
+{
+    tm_fpu_start(0x5);
+}
+
+static void tm_fpu_all_start(void)
+{
+    tm_fpu_start(0xF);
+}
+#endif
+
+static const struct tm_test tm_tests[] =
+{
+    {"cooperative", tm_cooperative_start, NULL},
+    {"preemptive",  tm_preemptive_start,  NULL},
+    {"interrupt",   tm_interrupt_start,   tm_interrupt_stop},
+    {"sem",         tm_sem_start,         tm_sem_stop},
+    {"mutex",       tm_mutex_start,       NULL},
+    {"sem_lock",    tm_sem_lock_start,    NULL},
+    {"mutex_lock",  tm_mutex_lock_start,  NULL},
+    {"pcmutex_lock", tm_pcmutex_lock_start, NULL},
+    {"pcmutex_own", tm_pcmutex_own_start, NULL},
+    {"sched_lock",  tm_sched_lock_start,  NULL},
+    {"mqueue",      tm_mqueue_start,      tm_mqueue_stop},
+    {"mbox",        tm_mbox_start,        tm_mbox_stop},
+    {"mpool",       tm_mpool_start,       NULL},
+#ifdef OS_CFG_HEAP
+    {"malloc",      tm_malloc_start,      NULL},
+#endif
+    {"timer",       tm_timer_start,       tm_timer_stop},
+#ifdef OS_CFG_TASK_FPU
+    {"fpu_none",    tm_fpu_none_start,    NULL},
+    {"fpu_one",     tm_fpu_one_start,     NULL},
+    {"fpu_mixed",   tm_fpu_mixed_start,   NULL},
+    {"fpu_all",     tm_fpu_all_start,     NULL},
+#endif
+};
+
+static uint32_t tm_counter_sum(void)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < TM_TASKS_MAX; i++)
+        sum += tm_counter[i];
+
+    return sum;
+}
+
+/*
+ * This function will stop the tasks of a test. Blocked tasks are woken by
+ * the stop of test, suspended ones are resumed, then all of them see tm_stop
+ * and return. It is done every round, a task preempted before it blocks is
+ * woken on a later one.
+ */
+static void tm_test_stop(const struct tm_test *test)
+{
+    uint32_t i;
+
+    tm_stop = TRUE;
+
+    /* the test tasks run below report task, let them finish */
+    while (1) {
+        if (test->stop != NULL)
+            test->stop();
+
+        for (i = 0; i < TM_TASKS_MAX; i++) {
+            if (tm_task[i].stat == OS_TASK_SUSPEND)
+                os_task_resume(&tm_task[i]);
+        }
+
+        for (i = 0; i < TM_TASKS_MAX; i++) {
+            if (tm_task[i].stat != OS_TASK_INIT &&
+                tm_task[i].stat != OS_TASK_CLOSE)
+                break;
+        }
+        if (i == TM_TASKS_MAX)
+            break;
+
+        os_task_sleep(1);
+    }
+}
+
+/**
+ * This function will be called when the last test is reported. The default
+ * does nothing, the simulator overrides it to exit.
+ */
+WEAK void tm_done(void)
+{
+}
+
+static void tm_report_entry(void *parameter)
+{
+    const struct tm_test *test;
+    os_tick_t start;
+    uint32_t last;
+    uint32_t sum;
+    uint32_t period;
+    uint32_t i;
+
+    printf("tm,test,period,ticks,operations\n");
+
+    for (i = 0; i < sizeof(tm_tests) / sizeof(tm_tests[0]); i++) {
+        test = &tm_tests[i];
+
+        memset((void *)tm_counter, 0, sizeof(tm_counter));
+        tm_stop = FALSE;
+
+        test->start();
+
+        last = 0;
+        for (period = 1; period <= TM_TEST_REPORTS; period++) {
+            start = os_tick_get();
+            os_task_sleep(TM_TEST_PERIOD);
+
+            sum = tm_counter_sum();
+            printf("tm,%s,%d,%d,%d\n", test->name, period,
+                   os_tick_get() - start, sum - last);
+            last = sum;
+        }
+
+        tm_test_stop(test);
+    }
+
+    printf("tm,done\n");
+
+    tm_done();
+}
+
+/**
+ * This function will start the benchmark, the tests run one after another
+ * and report on console.
+ */
+void tm_main(void)
+{
+    os_task_init(&tm_report,
+                 "tm",
+                 tm_report_entry,
+                 NULL,
+                 &tm_report_stack[0],
+                 TM_TASK_STACK_SIZE,
+                 TM_REPORT_PRIO,
+                 20);
+    os_task_startup(&tm_report);
+}
@@ -0,0 +1,51 @@
+/*
+ * File      : sim_test.h
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+#ifndef _SIM_TEST_H_
+#define _SIM_TEST_H_
+
+#include <os.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * A test is one program, it exits 0 when every check passed. The first
+ * failed check prints itself and exits 1.
+ */
+#define SIM_CHECK(cond)                                                     \
+do                                                                          \
+{                                                                           \
+    if (!(cond))                                                            \
+        sim_test_fail(__FILE__, __LINE__, #cond);                           \
+} while (0)
+
+void sim_test_fail(const char *file, int line, const char *cond);
+void sim_test_pass(void);
+
+/*
+ * start kernel with one task running entry, the task calls sim_test_pass at
+ * the end. It never returns.
+ */
+void sim_test_run(void (*entry)(void *parameter), uint8_t priority);
+
+/*
+ * run a kernel in a child process, its console goes to out. It returns the
+ * exit status of child, or -1 if it was killed.
+ */
+int sim_test_fork(void (*run)(void), char *out, size_t size);
+
+/* the nanoseconds of host monotonic clock */
+uint64_t sim_test_ns(void);
+
+#endif /* _SIM_TEST_H_ */
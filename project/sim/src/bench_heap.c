@@ -0,0 +1,306 @@
+/*
+ * File      : bench_heap.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Heap trace replay, built once with the small heap and once with TLSF. A
+ * trace is a seeded sequence of malloc, free and realloc of a workload, it
+ * is replayed five times on the 64K heap, each pass from an empty heap:
+ *
+ *   uniform   8 to 512 bytes, up to 120 blocks alive
+ *   packet    64 or 1536 bytes, a burst alive then freed out of order
+ *   growing   buffers realloc'ed up by half, among small long lived blocks
+ *
+ * An operation takes the same path in every pass, its time is the least of
+ * passes, which leaves out the noise of host. For each kind of operation the
+ * mean and the worst of them in host nanoseconds, then the failed
+ * allocations, and the fragmentation at the end of trace: the part of free
+ * memory not in the largest block that can be allocated.
+ *
+ *   heap,<small|tlsf>,<trace>,<malloc|free|realloc>,<mean ns>,<max ns>
+ *   heap,<small|tlsf>,<trace>,failed,<count>
+ *   heap,<small|tlsf>,<trace>,frag,<free bytes>,<largest>,<percent>
+ */
+
+#include <sim_test.h>
+
+#ifdef OS_CFG_HEAP_TLSF
+#define BH_NAME                 "tlsf"
+#else
+#define BH_NAME                 "small"
+#endif
+
+#define BH_OPS                  20000
+#define BH_SLOTS                128
+#define BH_PASSES               5
+
+enum
+{
+    BH_MALLOC,
+    BH_FREE,
+    BH_REALLOC,
+};
+
+static const char *bh_op_name[] = {"malloc", "free", "realloc"};
+
+/* an operation of trace on a slot, the size for malloc and realloc */
+struct bh_op
+{
+    uint8_t  op;
+    uint8_t  slot;
+    uint16_t size;
+};
+
+static struct bh_op bh_trace[BH_OPS];
+static uint32_t     bh_ops;
+
+static uint32_t     bh_ns[BH_OPS];
+
+static void *bh_slot[BH_SLOTS];
+static uint32_t bh_failed;
+
+static void bh_emit(uint8_t op, uint32_t slot, uint32_t size)
+{
+    if (bh_ops == BH_OPS)
+        return;
+
+    bh_trace[bh_ops].op   = op;
+    bh_trace[bh_ops].slot = slot;
+    bh_trace[bh_ops].size = size;
+    bh_ops++;
+}
+
+/*
+ * the generators keep their own view of live slots, a trace is valid by
+ * itself whatever the heap returns
+ */
+static void bh_uniform(void)
+{
+    static bool_t live[BH_SLOTS];
+    uint32_t slot;
+
+    while (bh_ops < BH_OPS) {
+        slot = os_arch_sim_random() % 120;
+        if (live[slot]) {
+            bh_emit(BH_FREE, slot, 0);
+            live[slot] = FALSE;
+        } else {
+            bh_emit(BH_MALLOC, slot, 8 + os_arch_sim_random() % 505);
+            live[slot] = TRUE;
+        }
+    }
+}
+
+static void bh_packet(void)
+{
+    uint8_t order[32];
+    uint32_t burst;
+    uint32_t i;
+    uint32_t j;
+    uint8_t t;
+
+    while (bh_ops < BH_OPS) {
+        burst = 8 + os_arch_sim_random() % 24;
+        for (i = 0; i < burst; i++) {
+            order[i] = i;
+            bh_emit(BH_MALLOC, i,
+                    os_arch_sim_random() % 4 == 0 ? 1536 : 64);
+        }
+
+        for (i = burst - 1; i > 0; i--) {
+            j = os_arch_sim_random() % (i + 1);
+            t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        for (i = 0; i < burst; i++)
+            bh_emit(BH_FREE, order[i], 0);
+    }
+}
+
+static void bh_growing(void)
+{
+    static uint32_t size[BH_SLOTS];
+    uint32_t slot;
+
+    while (bh_ops < BH_OPS) {
+        /* 64 small long lived blocks, 16 buffers that grow to 4K */
+        if (os_arch_sim_random() % 2 == 0) {
+            slot = os_arch_sim_random() % 64;
+            if (size[slot] != 0) {
+                bh_emit(BH_FREE, slot, 0);
+                size[slot] = 0;
+            } else {
+                size[slot] = 16 + os_arch_sim_random() % 113;
+                bh_emit(BH_MALLOC, slot, size[slot]);
+            }
+        } else {
+            slot = 64 + os_arch_sim_random() % 16;
+            if (size[slot] == 0) {
+                size[slot] = 32;
+                bh_emit(BH_MALLOC, slot, size[slot]);
+            } else if (size[slot] >= 4096) {
+                bh_emit(BH_FREE, slot, 0);
+                size[slot] = 0;
+            } else {
+                size[slot] += size[slot] / 2;
+                bh_emit(BH_REALLOC, slot, size[slot]);
+            }
+        }
+    }
+}
+
+static void bh_replay(void)
+{
+    struct bh_op *op;
+    uint64_t ns;
+    uint32_t delta;
+    uint32_t i;
+    void *ptr;
+
+    for (i = 0; i < bh_ops; i++) {
+        op = &bh_trace[i];
+
+        ns = sim_test_ns();
+        switch (op->op) {
+        case BH_MALLOC:
+            ptr = os_malloc(op->size);
+            break;
+
+        case BH_FREE:
+            os_free(bh_slot[op->slot]);
+            ptr = NULL;
+            break;
+
+        default:
+            ptr = os_realloc(bh_slot[op->slot], op->size);
+            break;
+        }
+        delta = sim_test_ns() - ns;
+
+        if (delta < bh_ns[i])
+            bh_ns[i] = delta;
+
+        /* a failed realloc keeps the old block */
+        if (op->op == BH_REALLOC && ptr == NULL && op->size != 0) {
+            bh_failed++;
+            continue;
+        }
+        if (op->op == BH_MALLOC && ptr == NULL)
+            bh_failed++;
+        bh_slot[op->slot] = ptr;
+    }
+}
+
+/* the largest block can be allocated, by bisection */
+static uint32_t bh_largest(void)
+{
+    uint32_t low = 0;
+    uint32_t high = OS_HEAP_SIZE * 1024;
+    uint32_t mid;
+    void *ptr;
+
+    while (low < high) {
+        mid = (low + high + 1) / 2;
+        ptr = os_malloc(mid);
+        if (ptr != NULL) {
+            os_free(ptr);
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return low;
+}
+
+static void bh_run(const char *name, void (*generate)(void))
+{
+    uint64_t sum[3];
+    uint32_t max[3];
+    uint32_t count[3];
+    uint32_t total;
+    uint32_t used;
+    uint32_t largest;
+    uint32_t pass;
+    uint32_t i;
+
+    bh_ops = 0;
+    os_arch_sim_seed(1);
+    generate();
+
+    for (i = 0; i < bh_ops; i++)
+        bh_ns[i] = 0xFFFFFFFF;
+
+    for (pass = 0; pass < BH_PASSES; pass++) {
+        bh_failed = 0;
+
+        bh_replay();
+
+        /* the fragmentation left by the trace, then back to empty */
+        os_memory_info(&total, &used, NULL);
+        largest = bh_largest();
+        for (i = 0; i < BH_SLOTS; i++) {
+            os_free(bh_slot[i]);
+            bh_slot[i] = NULL;
+        }
+    }
+
+    for (i = 0; i < 3; i++) {
+        sum[i]   = 0;
+        max[i]   = 0;
+        count[i] = 0;
+    }
+    for (i = 0; i < bh_ops; i++) {
+        sum[bh_trace[i].op] += bh_ns[i];
+        count[bh_trace[i].op]++;
+        if (bh_ns[i] > max[bh_trace[i].op])
+            max[bh_trace[i].op] = bh_ns[i];
+    }
+
+    for (i = 0; i < 3; i++) {
+        if (count[i] == 0)
+            continue;
+
+        printf("heap,%s,%s,%s,%u,%u\n", BH_NAME, name, bh_op_name[i],
+               (uint32_t)(sum[i] / count[i]), max[i]);
+    }
+    printf("heap,%s,%s,failed,%u\n", BH_NAME, name, bh_failed);
+    printf("heap,%s,%s,frag,%u,%u,%u\n", BH_NAME, name, total - used, largest,
+           100 - largest * 100 / (total - used));
+}
+
+static void bh_entry(void *parameter)
+{
+    uint32_t used;
+    uint32_t used_start;
+
+    os_memory_info(NULL, &used_start, NULL);
+
+    bh_run("uniform", bh_uniform);
+    bh_run("packet", bh_packet);
+    bh_run("growing", bh_growing);
+
+    /* every block of traces is given back */
+    os_memory_info(NULL, &used, NULL);
+    SIM_CHECK(used == used_start);
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    sim_test_run(bh_entry, 10);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * File      : bench_mqueue.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Message queue with copy against zero-copy, messages of 16 to 4096 bytes,
+ * in host nanoseconds a message:
+ *
+ *   copy      os_mqueue_put and os_mqueue_get
+ *   zerocopy  reserve and commit, recv_borrow and release
+ *
+ * each one sent and received by the bench task itself (local), or received
+ * by a higher priority task blocked on the queue (task). One line a case:
+ *
+ *   mqueue,<copy|zerocopy>,<size>,<local|task>,<ns>
+ */
+
+#include <sim_test.h>
+
+#define BM_ROUNDS               100000
+#define BM_SIZE_MAX             4096
+#define BM_MSGS                 4
+
+enum
+{
+    BM_COPY,
+    BM_ZEROCOPY,
+};
+
+static const char *bm_name[] = {"copy", "zerocopy"};
+
+static os_task_t bm_bench;
+static os_task_t bm_receiver;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t bm_stack[2][BM_SIZE_MAX + 2048];
+
+static os_mqueue_t bm_mq;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t bm_pool[BM_MSGS * (BM_SIZE_MAX + 16)];
+static uint8_t bm_data[BM_SIZE_MAX];
+static uint32_t bm_size;
+static volatile uint32_t bm_count;
+
+static void bm_send(uint32_t kind)
+{
+    void *msg;
+
+    if (kind == BM_COPY) {
+        os_mqueue_put(&bm_mq, bm_data, bm_size);
+    } else {
+        os_mqueue_reserve(&bm_mq, &msg);
+        *(uint32_t *)msg = bm_count;
+        os_mqueue_commit(&bm_mq, msg);
+    }
+}
+
+static void bm_recv(uint32_t kind)
+{
+    uint8_t buffer[BM_SIZE_MAX];
+    void *msg;
+
+    if (kind == BM_COPY) {
+        os_mqueue_get(&bm_mq, buffer, bm_size, OS_WAIT_FOREVER);
+    } else {
+        os_mqueue_recv_borrow(&bm_mq, &msg, OS_WAIT_FOREVER);
+        os_mqueue_release(&bm_mq, msg);
+    }
+
+    bm_count++;
+}
+
+static void bm_receiver_entry(void *parameter)
+{
+    while (1)
+        bm_recv((uint32_t)parameter);
+}
+
+static void bm_case(uint32_t kind, uint32_t size, bool_t task)
+{
+    uint64_t ns;
+    uint32_t i;
+
+    bm_size  = size;
+    bm_count = 0;
+    os_mqueue_init(&bm_mq, bm_pool, size, sizeof(bm_pool), OS_IPC_FIFO);
+
+    if (task == TRUE) {
+        /* the receiver runs at once and blocks */
+        os_task_init(&bm_receiver, "recv", bm_receiver_entry, (void *)kind,
+                     &bm_stack[0][0], sizeof(bm_stack[0]), 5, 10);
+        os_task_startup(&bm_receiver);
+    }
+
+    ns = sim_test_ns();
+    for (i = 0; i < BM_ROUNDS; i++) {
+        bm_send(kind);
+        if (task == FALSE)
+            bm_recv(kind);
+    }
+    ns = sim_test_ns() - ns;
+
+    SIM_CHECK(bm_count == BM_ROUNDS);
+    printf("mqueue,%s,%u,%s,%u\n", bm_name[kind], size,
+           task == TRUE ? "task" : "local", (uint32_t)(ns / BM_ROUNDS));
+
+    if (task == TRUE) {
+        os_task_delete(&bm_receiver);
+        /* let idle reclaim it before the object is initialized again */
+        os_task_sleep(1);
+    }
+}
+
+static void bm_entry(void *parameter)
+{
+    static const uint32_t size[] = {16, 64, 256, 1024, 4096};
+    uint32_t i;
+
+    for (i = 0; i < sizeof(size) / sizeof(size[0]); i++) {
+        bm_case(BM_COPY, size[i], FALSE);
+        bm_case(BM_ZEROCOPY, size[i], FALSE);
+        bm_case(BM_COPY, size[i], TRUE);
+        bm_case(BM_ZEROCOPY, size[i], TRUE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    os_enter_critical();
+
+    os_init();
+
+    os_task_init(&bm_bench, "bench", bm_entry, NULL,
+                 &bm_stack[1][0], sizeof(bm_stack[1]), 10, 10);
+    os_task_startup(&bm_bench);
+
+    os_start();
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * File      : bench_notify.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      leave the unknown action to test_notify.c
+ */
+
+/*
+ * Wake latency of task notification against semaphore and event, in host
+ * nanoseconds. A signaller wakes a higher priority waiter, which preempts
+ * it and blocks again, from a task or from an interrupt it raises:
+ *
+ *   notify    os_task_notify_give and os_task_notify_take
+ *   sem       os_sem_give and os_sem_take
+ *   event     os_event_put and os_event_get with clear
+ *
+ * One line a case, the time of a wake and the block after it:
+ *
+ *   notify,<notify|sem|event>,<task|isr>,<ns>
+ */
+
+#include <sim_test.h>
+
+#define BN_ROUNDS               200000
+#define BN_IRQ                  5
+
+enum
+{
+    BN_NOTIFY,
+    BN_SEM,
+    BN_EVENT,
+};
+
+static const char *bn_name[] = {"notify", "sem", "event"};
+
+static os_task_t bn_waiter;
+static os_task_t bn_signaller;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t bn_stack[2][1024];
+
+static os_sem_t   bn_sem;
+static os_event_t bn_event;
+static uint32_t   bn_kind;
+static volatile uint32_t bn_count;
+
+static void bn_signal(void)
+{
+    switch (bn_kind) {
+    case BN_NOTIFY:
+        os_task_notify_give(&bn_waiter);
+        break;
+
+    case BN_SEM:
+        os_sem_give(&bn_sem);
+        break;
+
+    case BN_EVENT:
+        os_event_put(&bn_event, 0x01);
+        break;
+    }
+}
+
+static void bn_isr(void)
+{
+    bn_signal();
+}
+
+static void bn_waiter_entry(void *parameter)
+{
+    uint32_t kind = (uint32_t)parameter;
+
+    while (1) {
+        switch (kind) {
+        case BN_NOTIFY:
+            os_task_notify_take(TRUE, NULL, OS_WAIT_FOREVER);
+            break;
+
+        case BN_SEM:
+            os_sem_take(&bn_sem, OS_WAIT_FOREVER);
+            break;
+
+        case BN_EVENT:
+            os_event_get(&bn_event, 0x01, OS_EVENT_OR | OS_EVENT_CLEAR,
+                         OS_WAIT_FOREVER, NULL);
+            break;
+        }
+
+        bn_count++;
+    }
+}
+
+static void bn_case(uint32_t kind, bool_t isr)
+{
+    uint64_t ns;
+    uint32_t i;
+
+    bn_kind  = kind;
+    bn_count = 0;
+
+    /* the waiter runs at once and blocks */
+    os_task_init(&bn_waiter, "waiter", bn_waiter_entry, (void *)kind,
+                 &bn_stack[0][0], sizeof(bn_stack[0]), 5, 10);
+    os_task_startup(&bn_waiter);
+
+    ns = sim_test_ns();
+    for (i = 0; i < BN_ROUNDS; i++) {
+        if (isr == TRUE)
+            os_arch_sim_irq_raise(BN_IRQ);
+        else
+            bn_signal();
+    }
+    ns = sim_test_ns() - ns;
+
+    SIM_CHECK(bn_count == BN_ROUNDS);
+    printf("notify,%s,%s,%u\n", bn_name[kind], isr == TRUE ? "isr" : "task",
+           (uint32_t)(ns / BN_ROUNDS));
+
+    os_task_delete(&bn_waiter);
+    /* let idle reclaim it before the object is initialized again */
+    os_task_sleep(1);
+}
+
+static void bn_entry(void *parameter)
+{
+    uint32_t kind;
+
+    os_sem_init(&bn_sem, 0, OS_IPC_PRIO);
+    os_event_init(&bn_event, OS_IPC_PRIO);
+    os_arch_sim_irq_install(BN_IRQ, bn_isr);
+
+    for (kind = BN_NOTIFY; kind <= BN_EVENT; kind++) {
+        bn_case(kind, FALSE);
+        bn_case(kind, TRUE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    os_enter_critical();
+
+    os_init();
+
+    os_task_init(&bn_signaller, "signal", bn_entry, NULL,
+                 &bn_stack[1][0], sizeof(bn_stack[1]), 10, 10);
+    os_task_startup(&bn_signaller);
+
+    os_start();
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * File      : bench_ringbuf.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Ring buffer throughput in host nanoseconds per byte, chunks of 1 to 1024
+ * bytes through a 4096 byte ring:
+ *
+ *   copy      os_ringbuf_write and os_ringbuf_read, putc for 1 byte
+ *   inplace   reserve and commit, peek and release, no copy
+ *   isr       an interrupt writes a chunk, the task reads it
+ *
+ * One line a case, and the megabytes per second:
+ *
+ *   ringbuf,<copy|inplace|isr>,<chunk>,<ns per byte>,<MB/s>
+ */
+
+#include <sim_test.h>
+#include <string.h>
+
+#define BR_SIZE                 4096
+#define BR_BYTES                (16UL << 20)
+#define BR_IRQ                  5
+
+static os_ringbuf_t br_rb;
+static uint8_t      br_pool[BR_SIZE];
+static uint8_t      br_data[1024];
+static uint8_t      br_buffer[1024];
+static uint32_t     br_chunk;
+
+static void br_report(const char *name, uint32_t chunk, uint64_t ns)
+{
+    printf("ringbuf,%s,%u,%u.%02u,%u\n", name, chunk,
+           (uint32_t)(ns / BR_BYTES),
+           (uint32_t)(ns * 100 / BR_BYTES % 100),
+           (uint32_t)((uint64_t)BR_BYTES * 1000 / ns));
+}
+
+static void br_copy(uint32_t chunk)
+{
+    uint64_t ns;
+    uint32_t done;
+
+    ns = sim_test_ns();
+    for (done = 0; done < BR_BYTES; done += chunk) {
+        if (chunk == 1)
+            os_ringbuf_putc(&br_rb, br_data[0]);
+        else
+            os_ringbuf_write(&br_rb, br_data, chunk);
+        os_ringbuf_read(&br_rb, br_buffer, chunk, OS_NO_WAIT);
+    }
+    ns = sim_test_ns() - ns;
+
+    br_report("copy", chunk, ns);
+}
+
+static void br_inplace(uint32_t chunk)
+{
+    uint64_t ns;
+    uint32_t done;
+    uint8_t *ptr;
+    uint32_t size;
+
+    ns = sim_test_ns();
+    for (done = 0; done < BR_BYTES; done += size) {
+        size = os_ringbuf_reserve(&br_rb, &ptr);
+        if (size > chunk)
+            size = chunk;
+        ptr[0] = (uint8_t)done;
+        os_ringbuf_commit(&br_rb, size);
+
+        size = os_ringbuf_peek(&br_rb, &ptr);
+        os_ringbuf_release(&br_rb, size);
+    }
+    ns = sim_test_ns() - ns;
+
+    br_report("inplace", chunk, ns);
+}
+
+static void br_isr(void)
+{
+    os_ringbuf_write(&br_rb, br_data, br_chunk);
+}
+
+static void br_irq(uint32_t chunk)
+{
+    uint64_t ns;
+    uint32_t done;
+
+    br_chunk = chunk;
+
+    ns = sim_test_ns();
+    for (done = 0; done < BR_BYTES; done += chunk) {
+        os_arch_sim_irq_raise(BR_IRQ);
+        os_ringbuf_read(&br_rb, br_buffer, chunk, OS_WAIT_FOREVER);
+    }
+    ns = sim_test_ns() - ns;
+
+    br_report("isr", chunk, ns);
+}
+
+static void br_entry(void *parameter)
+{
+    static const uint32_t chunk[] = {1, 16, 64, 256, 1024};
+    uint32_t i;
+
+    os_ringbuf_init(&br_rb, br_pool, BR_SIZE);
+    os_arch_sim_irq_install(BR_IRQ, br_isr);
+    memset(br_data, 0x5a, sizeof(br_data));
+
+    for (i = 0; i < sizeof(chunk) / sizeof(chunk[0]); i++) {
+        br_copy(chunk[i]);
+        br_inplace(chunk[i]);
+        br_irq(chunk[i]);
+        SIM_CHECK(os_ringbuf_len(&br_rb) == 0);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    sim_test_run(br_entry, 10);
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * File      : bench_sched.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      time the bitmap lookup of baseline
+ */
+
+/*
+ * Pick of the next task over 256 priorities, in host nanoseconds. A partner
+ * task at priority p is woken by the bench task at 0 suspending itself, and
+ * wakes it again; fillers keep every priority below p ready:
+ *
+ *   pick      os_sched with nothing to switch to
+ *   bitmap    the same with the ready bitmap lookup os_sched made before
+ *             the next task was cached, the baseline of pick
+ *   switch    a round trip, two picks and two switches
+ *
+ * One line a case:
+ *
+ *   sched,<p>,<ready>,<pick|bitmap|switch>,<ns>
+ *
+ * A round trip of baseline is about switch + 2 * (bitmap - pick).
+ */
+
+#include <sim_test.h>
+
+#define BS_ROUNDS               200000
+#define BS_FILLERS              (OS_TASK_PRIORITY_MAX - 1)
+
+extern os_list_t os_ready_task_priority_list[OS_TASK_PRIORITY_MAX];
+#if OS_TASK_PRIORITY_MAX > 32
+extern uint8_t   os_ready_task_group;
+extern uint32_t  os_ready_task_bitmap[8];
+#else
+extern uint32_t  os_ready_task_bitmap;
+#endif
+
+static os_task_t bs_bench;
+static os_task_t bs_partner;
+static os_task_t bs_filler[BS_FILLERS];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t bs_stack[BS_FILLERS + 2][256];
+
+static void bs_filler_entry(void *parameter)
+{
+    /* never runs, the bench and partner are always above */
+    while (1)
+        os_task_yield();
+}
+
+static void bs_partner_entry(void *parameter)
+{
+    while (1) {
+        os_task_resume(&bs_bench);
+        os_sched();
+    }
+}
+
+/* os_sched of baseline with nothing to switch to, the lookup on every call */
+static void __attribute__((noinline)) bs_sched_bitmap(void)
+{
+    uint32_t highest_ready_priority;
+    os_task_t *to_task;
+    os_sr_t sr;
+#if OS_TASK_PRIORITY_MAX > 32
+    uint8_t group;
+#endif
+
+    sr = os_enter_critical();
+
+#if OS_TASK_PRIORITY_MAX > 32
+    group = __ffs(os_ready_task_group) - 1;
+    highest_ready_priority = (group << 5) + __ffs(os_ready_task_bitmap[group]) - 1;
+#else
+    highest_ready_priority = __ffs(os_ready_task_bitmap) - 1;
+#endif
+
+    to_task = OS_LIST_ENTRY(os_ready_task_priority_list[highest_ready_priority].next,
+                            os_task_t,
+                            tlist);
+    SIM_CHECK(to_task == os_task_self());
+
+    os_exit_critical(sr);
+}
+
+static void bs_case(uint8_t priority)
+{
+    uint64_t ns;
+    uint32_t ready;
+    uint32_t i;
+
+    /* the fillers below partner are ready, the rest suspended */
+    ready = 0;
+    for (i = 0; i < BS_FILLERS; i++) {
+        if (i + 1 > priority) {
+            os_task_resume(&bs_filler[i]);
+            ready++;
+        } else {
+            os_task_suspend(&bs_filler[i]);
+        }
+    }
+
+    ns = sim_test_ns();
+    for (i = 0; i < BS_ROUNDS; i++)
+        os_sched();
+    ns = sim_test_ns() - ns;
+
+    printf("sched,%u,%u,pick,%u\n", priority, ready,
+           (uint32_t)(ns / BS_ROUNDS));
+
+    ns = sim_test_ns();
+    for (i = 0; i < BS_ROUNDS; i++)
+        bs_sched_bitmap();
+    ns = sim_test_ns() - ns;
+
+    printf("sched,%u,%u,bitmap,%u\n", priority, ready,
+           (uint32_t)(ns / BS_ROUNDS));
+
+    os_task_priority_set(&bs_partner, priority);
+    os_task_resume(&bs_partner);
+
+    ns = sim_test_ns();
+    for (i = 0; i < BS_ROUNDS; i++) {
+        os_task_suspend(&bs_bench);
+        os_sched();
+    }
+    ns = sim_test_ns() - ns;
+
+    printf("sched,%u,%u,switch,%u\n", priority, ready,
+           (uint32_t)(ns / BS_ROUNDS));
+
+    /* the partner is ready now, park it */
+    os_task_suspend(&bs_partner);
+}
+
+static void bs_entry(void *parameter)
+{
+    static const uint8_t priority[] = {1, 31, 32, 128, 254};
+    uint32_t i;
+
+    for (i = 0; i < BS_FILLERS; i++) {
+        os_task_init(&bs_filler[i], "filler", bs_filler_entry, NULL,
+                     &bs_stack[i][0], sizeof(bs_stack[i]), i + 1, 10);
+        os_task_startup(&bs_filler[i]);
+    }
+
+    os_task_init(&bs_partner, "partner", bs_partner_entry, NULL,
+                 &bs_stack[BS_FILLERS][0], sizeof(bs_stack[BS_FILLERS]),
+                 1, 10);
+    os_task_startup(&bs_partner);
+    os_task_suspend(&bs_partner);
+
+    for (i = 0; i < sizeof(priority) / sizeof(priority[0]); i++)
+        bs_case(priority[i]);
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    os_enter_critical();
+
+    os_init();
+
+    os_task_init(&bs_bench, "bench", bs_entry, NULL,
+                 &bs_stack[BS_FILLERS + 1][0], sizeof(bs_stack[BS_FILLERS + 1]),
+                 0, 10);
+    os_task_startup(&bs_bench);
+
+    os_start();
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * File      : bench_waitq.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Interrupt-off time of a PRIOed wait queue with 64 waiters, built once with
+ * 8 buckets and once with a bucket for every priority. 64 ready tasks of
+ * priority 63 down to 32, two of each, are queued one by one, each one ahead
+ * of all queued before, the worst order for a bucket kept sorted. Then the
+ * last one is raised to 32 by os_task_priority_set and put back, and all are
+ * resumed in priority order.
+ *
+ * Each operation is timed alone in its critical section, in host
+ * nanoseconds. An operation takes the same path in every round, its time is
+ * the least of rounds, which leaves out the noise of host. The mean and the
+ * worst of the operations of a kind:
+ *
+ *   waitq,<buckets>,<suspend|requeue|resume>,<mean ns>,<max ns>
+ */
+
+#include <sim_test.h>
+
+#define BW_WAITERS              64
+#define BW_ROUNDS               1000
+
+enum
+{
+    BW_SUSPEND,
+    BW_REQUEUE,
+    BW_RESUME,
+    BW_OPS,
+};
+
+static const char *bw_op_name[] = {"suspend", "requeue", "resume"};
+
+static os_task_t bw_task[BW_WAITERS];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t bw_stack[BW_WAITERS][512];
+
+static os_waitq_t bw_wq;
+static uint32_t   bw_ns[BW_OPS][BW_WAITERS];
+
+static void bw_entry_never(void *parameter)
+{
+    /* the waiters are below the bench task, they never run */
+}
+
+static void bw_time(uint32_t op, uint32_t index, uint64_t ns)
+{
+    ns = sim_test_ns() - ns;
+
+    if (ns < bw_ns[op][index])
+        bw_ns[op][index] = ns;
+}
+
+static void bw_round(void)
+{
+    os_task_t *task;
+    uint64_t ns;
+    uint8_t priority;
+    os_sr_t sr;
+    uint32_t i;
+
+    os_waitq_init(&bw_wq);
+
+    for (i = 0; i < BW_WAITERS; i++) {
+        sr = os_enter_critical();
+        ns = sim_test_ns();
+        os_waitq_suspend(&bw_wq, &bw_task[i], OS_IPC_PRIO);
+        bw_time(BW_SUSPEND, i, ns);
+        os_exit_critical(sr);
+    }
+
+    /* the first queued, the last of its bucket, to 32 and back */
+    sr = os_enter_critical();
+    ns = sim_test_ns();
+    os_task_priority_set(&bw_task[0], 32);
+    bw_time(BW_REQUEUE, 0, ns);
+    os_exit_critical(sr);
+
+    sr = os_enter_critical();
+    ns = sim_test_ns();
+    os_task_priority_set(&bw_task[0], 63);
+    bw_time(BW_REQUEUE, 1, ns);
+    os_exit_critical(sr);
+
+    priority = 0;
+    for (i = 0; i < BW_WAITERS; i++) {
+        sr = os_enter_critical();
+        task = os_waitq_first(&bw_wq);
+        SIM_CHECK(task != NULL && task->current_priority >= priority);
+        priority = task->current_priority;
+
+        ns = sim_test_ns();
+        os_waitq_resume(&bw_wq);
+        bw_time(BW_RESUME, i, ns);
+        os_exit_critical(sr);
+    }
+
+    SIM_CHECK(os_waitq_isempty(&bw_wq));
+}
+
+static void bw_entry(void *parameter)
+{
+    uint64_t sum;
+    uint32_t max;
+    uint32_t count;
+    uint32_t op;
+    uint32_t i;
+
+    for (i = 0; i < BW_WAITERS; i++) {
+        os_task_init(&bw_task[i], "waiter", bw_entry_never, NULL,
+                     &bw_stack[i][0], sizeof(bw_stack[i]),
+                     63 - i / 2, 10);
+        os_task_startup(&bw_task[i]);
+    }
+
+    for (op = 0; op < BW_OPS; op++)
+        for (i = 0; i < BW_WAITERS; i++)
+            bw_ns[op][i] = 0xFFFFFFFF;
+
+    for (i = 0; i < BW_ROUNDS; i++)
+        bw_round();
+
+    for (op = 0; op < BW_OPS; op++) {
+        sum   = 0;
+        max   = 0;
+        count = op == BW_REQUEUE ? 2 : BW_WAITERS;
+        for (i = 0; i < count; i++) {
+            sum += bw_ns[op][i];
+            if (bw_ns[op][i] > max)
+                max = bw_ns[op][i];
+        }
+
+        printf("waitq,%u,%s,%u,%u\n", OS_IPC_WAITQ_LEVELS, bw_op_name[op],
+               (uint32_t)(sum / count), max);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    sim_test_run(bw_entry, 10);
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * File      : sim_test.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+#include <sim_test.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define SIM_TEST_STACK_SIZE     1024
+
+static os_task_t sim_test_task;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t sim_test_stack[SIM_TEST_STACK_SIZE];
+
+void sim_test_fail(const char *file, int line, const char *cond)
+{
+    printf("%s:%d: check failed: %s\n", file, line, cond);
+    fflush(stdout);
+
+    exit(EXIT_FAILURE);
+}
+
+void sim_test_pass(void)
+{
+    printf("pass\n");
+    fflush(stdout);
+
+    exit(EXIT_SUCCESS);
+}
+
+void sim_test_run(void (*entry)(void *parameter), uint8_t priority)
+{
+    os_enter_critical();
+
+    os_init();
+
+    os_task_init(&sim_test_task,
+                 "test",
+                 entry,
+                 NULL,
+                 &sim_test_stack[0],
+                 SIM_TEST_STACK_SIZE,
+                 priority,
+                 20);
+    os_task_startup(&sim_test_task);
+
+    os_start();
+
+    /* never reach here */
+    exit(EXIT_FAILURE);
+}
+
+int sim_test_fork(void (*run)(void), char *out, size_t size)
+{
+    char buf[256];
+    int fd[2];
+    pid_t pid;
+    ssize_t n;
+    size_t len = 0;
+    int status;
+
+    fflush(stdout);
+    if (pipe(fd) != 0)
+        return -1;
+
+    pid = fork();
+    if (pid < 0)
+        return -1;
+
+    if (pid == 0) {
+        close(fd[0]);
+        dup2(fd[1], STDOUT_FILENO);
+        close(fd[1]);
+
+        run();
+        exit(EXIT_SUCCESS);
+    }
+
+    /* read to the end, what does not fit in out is dropped */
+    close(fd[1]);
+    while ((n = read(fd[0], buf, sizeof(buf))) > 0) {
+        if (n > (ssize_t)(size - 1 - len))
+            n = size - 1 - len;
+        memcpy(out + len, buf, n);
+        len += n;
+    }
+    out[len] = '\0';
+    close(fd[0]);
+
+    waitpid(pid, &status, 0);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+uint64_t sim_test_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
@@ -0,0 +1,251 @@
+/*
+ * File      : test_edf.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Schedulability of earliest deadline first, OS_CFG_SCHED_EDF in virtual
+ * time. Synthetic periodic task sets of 2 to 6 tasks, periods of 5 to 40
+ * ticks, a third of them with a deadline shorter than period, and a density
+ * of 60% to 100% split at random. A task which os_task_edf_set does not
+ * admit gives up a tick of budget until it is admitted, or the set ends
+ * before it.
+ *
+ * All tasks are released on the same tick, each job computes its budget
+ * less one tick by busy ticks, the tick which ends a budget throttles a job
+ * still running. An admitted set runs 4000 ticks and misses no deadline.
+ * A task computing past its budget is throttled and the others still meet
+ * their deadlines.
+ */
+
+#include <sim_test.h>
+
+#define TE_SETS                 40
+#define TE_TASKS_MAX            6
+#define TE_HORIZON              4000
+#define TE_FIXED_PRIO           20
+
+static os_task_t te_task[TE_TASKS_MAX];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t te_stack[TE_TASKS_MAX][1024];
+
+static os_tick_t te_work[TE_TASKS_MAX];
+static uint32_t te_jobs[TE_TASKS_MAX];
+
+static void te_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+
+    while (1) {
+        os_arch_sim_busy(te_work[index]);
+        te_jobs[index]++;
+
+        os_task_edf_wait();
+    }
+}
+
+static void te_create(uint32_t index)
+{
+    SIM_CHECK(os_task_init(&te_task[index], "edf", te_entry, (void *)index,
+                           &te_stack[index][0], sizeof(te_stack[index]),
+                           TE_FIXED_PRIO, 10) == OS_OK);
+    te_jobs[index] = 0;
+}
+
+/* admit a task, a tick of budget less each time it does not fit */
+static bool_t te_admit(uint32_t index,
+                       os_tick_t period,
+                       os_tick_t deadline,
+                       os_tick_t budget)
+{
+    os_err_t err;
+
+    te_create(index);
+
+    while ((err = os_task_edf_set(&te_task[index], period, deadline,
+                                  budget)) == OS_EFULL && budget > 2)
+        budget--;
+
+    if (err != OS_OK) {
+        os_task_delete(&te_task[index]);
+
+        return FALSE;
+    }
+
+    te_work[index] = budget - 1;
+
+    return TRUE;
+}
+
+static uint32_t te_density(uint32_t n)
+{
+    uint32_t density = 0;
+    uint32_t i;
+    os_tick_t window;
+
+    for (i = 0; i < n; i++) {
+        window = te_task[i].edf_deadline;
+        density += te_task[i].edf_budget * 1000 / window;
+    }
+
+    return density;
+}
+
+/* start the tasks on one tick, run them, then delete them */
+static uint32_t te_run(uint32_t n)
+{
+    uint32_t jobs = 0;
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+        os_task_startup(&te_task[i]);
+
+    os_task_sleep(TE_HORIZON);
+
+    for (i = 0; i < n; i++) {
+        os_task_delete(&te_task[i]);
+        jobs += te_jobs[i];
+    }
+
+    /* let idle reclaim them before they are initialized again */
+    os_task_sleep(1);
+
+    return jobs;
+}
+
+static void te_random_sets(void)
+{
+    uint32_t weight[TE_TASKS_MAX];
+    uint32_t sum;
+    uint32_t target;
+    uint32_t density;
+    uint32_t density_min = 1000;
+    uint32_t density_max = 0;
+    uint32_t tasks = 0;
+    uint32_t jobs = 0;
+    os_tick_t period;
+    os_tick_t deadline;
+    os_tick_t budget;
+    uint32_t set;
+    uint32_t n;
+    uint32_t i;
+
+    for (set = 0; set < TE_SETS; set++) {
+        os_arch_sim_seed(set + 1);
+
+        n      = 2 + os_arch_sim_random() % (TE_TASKS_MAX - 1);
+        target = 600 + os_arch_sim_random() % 401;
+
+        sum = 0;
+        for (i = 0; i < n; i++) {
+            weight[i] = 1 + os_arch_sim_random() % 100;
+            sum += weight[i];
+        }
+
+        for (i = 0; i < n; i++) {
+            period = 5 + os_arch_sim_random() % 36;
+            budget = target * weight[i] / sum * period / 1000;
+            if (budget < 2)
+                budget = 2;
+
+            deadline = period;
+            if (os_arch_sim_random() % 3 == 0)
+                deadline = budget + os_arch_sim_random() % (period - budget + 1);
+
+            /* a set too dense for its last tasks ends there */
+            if (te_admit(i, period, deadline, budget) == FALSE) {
+                n = i;
+                break;
+            }
+        }
+        SIM_CHECK(n >= 1);
+
+        density = te_density(n);
+        if (density < density_min)
+            density_min = density;
+        if (density > density_max)
+            density_max = density;
+
+        jobs += te_run(n);
+        tasks += n;
+
+        for (i = 0; i < n; i++) {
+            SIM_CHECK(te_jobs[i] >= TE_HORIZON / te_task[i].edf_period - 1);
+            SIM_CHECK(te_task[i].edf_misses == 0);
+            SIM_CHECK(te_task[i].edf_overruns == 0);
+        }
+    }
+
+    printf("random: %u sets, %u tasks, density %u to %u, %u jobs, no miss\n",
+           TE_SETS, tasks, density_min, density_max, jobs);
+}
+
+/*
+ * one task computes 8 ticks of its budget of 3 in 10, it is throttled and the
+ * others of 70% still meet their deadlines
+ */
+static void te_overrun(void)
+{
+    SIM_CHECK(te_admit(0, 10, 10, 3) == TRUE);
+    te_work[0] = 8;
+    SIM_CHECK(te_admit(1, 7, 7, 3) == TRUE);
+    SIM_CHECK(te_admit(2, 20, 12, 3) == TRUE);
+    SIM_CHECK(te_density(3) == 300 + 428 + 250);
+
+    /* no room for one more */
+    te_create(3);
+    SIM_CHECK(os_task_edf_set(&te_task[3], 10, 10, 1) == OS_EFULL);
+    os_task_delete(&te_task[3]);
+
+    te_run(3);
+
+    printf("overrun: %u overruns, %u %u %u jobs\n", te_task[0].edf_overruns,
+           te_jobs[0], te_jobs[1], te_jobs[2]);
+    SIM_CHECK(te_task[0].edf_overruns > 0);
+    SIM_CHECK(te_task[1].edf_misses == 0 && te_task[1].edf_overruns == 0);
+    SIM_CHECK(te_task[2].edf_misses == 0 && te_task[2].edf_overruns == 0);
+}
+
+/* the band of deadlines takes no fixed priority task but by a mutex */
+static void te_band(void)
+{
+    SIM_CHECK(os_task_init(&te_task[0], "edf", te_entry, NULL,
+                           &te_stack[0][0], sizeof(te_stack[0]),
+                           OS_SCHED_EDF_PRIO, 10) == OS_ERROR);
+    SIM_CHECK(os_task_priority_set(os_task_self(), OS_SCHED_EDF_PRIO) == OS_ERROR);
+
+    te_create(0);
+    SIM_CHECK(os_task_edf_set(&te_task[0], 10, 10, 2) == OS_OK);
+    SIM_CHECK(te_task[0].current_priority == OS_SCHED_EDF_PRIO);
+    SIM_CHECK(os_task_priority_set(&te_task[0], TE_FIXED_PRIO) == OS_OK);
+    SIM_CHECK(os_task_priority_set(&te_task[0], OS_SCHED_EDF_PRIO) == OS_OK);
+    os_task_delete(&te_task[0]);
+    os_task_sleep(1);
+
+    printf("band ok\n");
+}
+
+static void te_entry_main(void *parameter)
+{
+    te_band();
+    te_random_sets();
+    te_overrun();
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(te_entry_main, 5);
+
+    return 0;
+}
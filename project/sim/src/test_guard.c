@@ -0,0 +1,265 @@
+/*
+ * File      : test_guard.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      idle watch scans a task at a time
+ */
+
+/*
+ * Stack guard of OS_CFG_STACK_GUARD in virtual time, the host check of the
+ * sim port in place of the MPU. It covers the kernel side of the cortex-m
+ * guard, not the MPU itself:
+ *
+ *   follow     four tasks on stacks 0, 4, 12 and 28 bytes past a 32 byte
+ *              boundary sleep, block and are woken by a scripted interrupt,
+ *              each finds the guard at the aligned block of its own stack
+ *              whenever it runs, after a task switch or an interrupt one
+ *   scan       a write into the guard of a task is left out of its stack
+ *              high water mark, a write just above it is not
+ *   watch      each call of the idle watch scans one task, a round of calls
+ *              every task once, and a task deleted when the watch is next
+ *              on it is passed over, and reports one after another
+ *   overflow   a task writing into its guard is named at the next switch
+ *              and the run exits with OS_ARCH_SIM_EXIT_GUARD
+ */
+
+#include <sim_test.h>
+#include <string.h>
+
+#define TG_TASKS                4
+#define TG_ROUNDS               200
+#define TG_STACK_SIZE           1024
+#define TG_IRQ                  5
+
+static const uint32_t tg_offset[TG_TASKS] = {0, 4, 12, 28};
+
+static os_task_t tg_task[TG_TASKS];
+ALIGN(OS_ARCH_STACK_GUARD_SIZE)
+static uint8_t tg_stack[TG_TASKS][TG_STACK_SIZE + OS_ARCH_STACK_GUARD_SIZE];
+
+static os_sem_t tg_sem;
+static uint32_t tg_checks;
+
+static uint32_t tg_guard_of(os_task_t *task)
+{
+    return OS_ALIGN((uint32_t)task->stack_addr, OS_ARCH_STACK_GUARD_SIZE);
+}
+
+static void tg_check(void)
+{
+    SIM_CHECK(os_arch_stack_guard == tg_guard_of(os_task_self()));
+    tg_checks++;
+}
+
+static void tg_init(uint32_t index,
+                    const char *name,
+                    void (*entry)(void *parameter),
+                    uint8_t priority)
+{
+    SIM_CHECK(os_task_init(&tg_task[index], name, entry, (void *)index,
+                           &tg_stack[index][tg_offset[index]], TG_STACK_SIZE,
+                           priority, 2) == OS_OK);
+}
+
+static void tg_isr(void)
+{
+    os_sem_give(&tg_sem);
+}
+
+/* 0 and 1 wait for the interrupt, 2 and 3 sleep and compute in slices */
+static void tg_follow_entry(void *parameter)
+{
+    uint32_t index = (uint32_t)parameter;
+    uint32_t round;
+
+    for (round = 0; round < TG_ROUNDS; round++) {
+        tg_check();
+
+        if (index < 2) {
+            SIM_CHECK(os_sem_take(&tg_sem, OS_WAIT_FOREVER) == OS_OK);
+        } else {
+            os_task_sleep(1 + os_arch_sim_random() % 3);
+            tg_check();
+            os_arch_sim_busy(1 + os_arch_sim_random() % 4);
+        }
+    }
+}
+
+static void tg_follow(void)
+{
+    uint32_t i;
+
+    os_sem_init(&tg_sem, 0, OS_IPC_PRIO);
+    os_arch_sim_irq_install(TG_IRQ, tg_isr);
+    SIM_CHECK(os_arch_sim_irq_schedule(TG_IRQ, os_tick_get() + 1, 2, 3) == OS_OK);
+
+    tg_init(0, "irq0", tg_follow_entry, 10);
+    tg_init(1, "irq1", tg_follow_entry, 11);
+    tg_init(2, "busy2", tg_follow_entry, 20);
+    tg_init(3, "busy3", tg_follow_entry, 20);
+    for (i = 0; i < TG_TASKS; i++)
+        os_task_startup(&tg_task[i]);
+
+    while (tg_task[2].stat != OS_TASK_CLOSE ||
+           tg_task[3].stat != OS_TASK_CLOSE) {
+        os_task_sleep(50);
+        tg_check();
+    }
+
+    /* the waiters end on the interrupts still scripted */
+    while (tg_task[0].stat != OS_TASK_CLOSE ||
+           tg_task[1].stat != OS_TASK_CLOSE)
+        os_task_sleep(50);
+
+    os_arch_sim_irq_install(TG_IRQ, NULL);
+    os_sem_delete(&tg_sem);
+    os_task_sleep(1);
+
+    printf("follow: %u checks\n", tg_checks);
+    SIM_CHECK(tg_checks > TG_ROUNDS * TG_TASKS);
+}
+
+static void tg_never_entry(void *parameter)
+{
+}
+
+static void tg_scan(void)
+{
+    uint32_t *guard;
+    uint32_t hwm;
+    uint32_t i;
+
+    /* a task never started, its stack is all fill but the top */
+    for (i = 0; i < TG_TASKS; i++) {
+        tg_init(i, "scan", tg_never_entry, 20);
+        hwm = os_task_stack_hwm(&tg_task[i]);
+
+        guard = (uint32_t *)tg_guard_of(&tg_task[i]);
+        memset(guard, 0, OS_ARCH_STACK_GUARD_SIZE);
+        SIM_CHECK(os_task_stack_hwm(&tg_task[i]) == hwm);
+
+        guard[OS_ARCH_STACK_GUARD_SIZE / 4] = 0;
+        SIM_CHECK(os_task_stack_hwm(&tg_task[i]) ==
+                  (uint8_t *)tg_task[i].stack_addr + TG_STACK_SIZE -
+                  (uint8_t *)&guard[OS_ARCH_STACK_GUARD_SIZE / 4]);
+
+        os_task_delete(&tg_task[i]);
+    }
+
+    printf("scan: the guard words are left out\n");
+}
+
+/* a call of the watch, the tasks of it scanned */
+static uint32_t tg_watch_once(uint32_t *moved)
+{
+    uint32_t scan[2];
+    uint32_t n;
+
+    scan[0] = tg_task[0].stack_scan;
+    scan[1] = tg_task[1].stack_scan;
+    os_task_stack_watch();
+
+    n = 0;
+    if (tg_task[0].stack_scan != scan[0]) {
+        moved[0]++;
+        n++;
+    }
+    if (tg_task[1].stack_scan != scan[1]) {
+        moved[1]++;
+        n++;
+    }
+
+    return n;
+}
+
+static void tg_watch(void)
+{
+    uint32_t moved[2] = {0, 0};
+    uint32_t i;
+
+    /* no sleep below, the idle task does not watch meanwhile */
+    tg_init(0, "watch0", tg_never_entry, 20);
+    tg_init(1, "watch1", tg_never_entry, 20);
+
+    for (i = 0; i < os_task_count(); i++)
+        SIM_CHECK(tg_watch_once(moved) <= 1);
+    SIM_CHECK(moved[0] == 1 && moved[1] == 1);
+
+    /* a whole pass of every task, a report at a time */
+    os_task_stack_report();
+    os_task_stack_report();
+
+    /* the watch is next on watch1, registered right after watch0 */
+    while (tg_watch_once(moved) == 0 || moved[0] != 2)
+        ;
+    os_task_delete(&tg_task[1]);
+
+    for (i = 0; i < os_task_count(); i++)
+        SIM_CHECK(tg_watch_once(moved) <= 1);
+    SIM_CHECK(moved[0] == 3 && moved[1] == 1);
+
+    os_task_delete(&tg_task[0]);
+    os_task_sleep(1);
+
+    printf("watch: a task a call\n");
+}
+
+static void tg_entry(void *parameter)
+{
+    os_arch_sim_seed(1);
+
+    tg_check();
+    tg_follow();
+    tg_scan();
+    tg_watch();
+
+    sim_test_pass();
+}
+
+static void tg_overflow_entry(void *parameter)
+{
+    uint32_t *guard = (uint32_t *)tg_guard_of(os_task_self());
+
+    /* the top word of guard, the first one an overflow writes */
+    guard[OS_ARCH_STACK_GUARD_SIZE / 4 - 1] = 0;
+    os_task_sleep(1);
+
+    printf("not trapped\n");
+    exit(EXIT_SUCCESS);
+}
+
+static void tg_overflow_main(void *parameter)
+{
+    tg_init(2, "over", tg_overflow_entry, 10);
+    os_task_startup(&tg_task[2]);
+
+    os_task_sleep(10);
+}
+
+static void tg_overflow_run(void)
+{
+    sim_test_run(tg_overflow_main, 20);
+}
+
+int main(void)
+{
+    static char out[256];
+    int status;
+
+    status = sim_test_fork(tg_overflow_run, out, sizeof(out));
+    printf("overflow: %s", out);
+    SIM_CHECK(status == OS_ARCH_SIM_EXIT_GUARD);
+    SIM_CHECK(strstr(out, "stack overflow on task: over\n") != NULL);
+
+    sim_test_run(tg_entry, 5);
+
+    return 0;
+}
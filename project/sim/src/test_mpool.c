@@ -0,0 +1,230 @@
+/*
+ * File      : test_mpool.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Memory pool under interrupt stress, in wall clock time. Two host timer
+ * signals of 31us and 37us raise two interrupts, each one takes blocks by
+ * os_mpool_alloc_isr and gives them back by os_mpool_free_isr. Two tasks of
+ * one priority in slices of a tick take blocks by os_mpool_alloc, blocking
+ * when the pool runs dry, and give them back by os_mpool_free. The holders
+ * want one block more than the pool has, for three seconds.
+ *
+ * The signals land on any instruction of tasks, in the middle of an
+ * exclusive pair too. A holder stamps a block and finds its stamp when it
+ * gives the block back, so a block handed out twice is caught. At the end
+ * every block is back on the free list and counted.
+ */
+
+#include <sim_test.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+#define TP_BLOCKS               11
+#define TP_BLOCK_SIZE           32
+#define TP_HOLD                 3
+#define TP_SECONDS              3
+
+/* interrupts 0 and 1, tasks 2 and 3 */
+#define TP_HOLDERS              4
+
+static os_mpool_t tp_mp;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tp_pool[TP_BLOCKS * (TP_BLOCK_SIZE + sizeof(uint8_t *))];
+
+static os_task_t tp_task[2];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tp_stack[2][2048];
+
+static void *tp_held[TP_HOLDERS][TP_HOLD];
+static uint32_t tp_ops[TP_HOLDERS];
+static uint32_t tp_dry[TP_HOLDERS];
+static volatile bool_t tp_stop;
+
+static void tp_take(uint32_t holder, void *block)
+{
+    uint32_t i;
+
+    for (i = 0; i < TP_BLOCK_SIZE / sizeof(uint32_t); i++)
+        ((uint32_t *)block)[i] = holder << 24 | (tp_ops[holder] & 0xffffff);
+    tp_held[holder][tp_ops[holder] % TP_HOLD] = block;
+}
+
+static void *tp_give(uint32_t holder, uint32_t slot)
+{
+    void *block;
+    uint32_t stamp;
+    uint32_t i;
+
+    block = tp_held[holder][slot];
+    tp_held[holder][slot] = NULL;
+    if (block == NULL)
+        return NULL;
+
+    /* nobody else wrote the block while it was held */
+    stamp = ((uint32_t *)block)[0];
+    SIM_CHECK(stamp >> 24 == holder);
+    for (i = 1; i < TP_BLOCK_SIZE / sizeof(uint32_t); i++)
+        SIM_CHECK(((uint32_t *)block)[i] == stamp);
+
+    return block;
+}
+
+static void tp_isr(uint32_t holder)
+{
+    void *block;
+
+    if (tp_stop)
+        return;
+
+    /* give back the oldest block, take a new one in its place */
+    block = tp_give(holder, tp_ops[holder] % TP_HOLD);
+    if (block != NULL)
+        os_mpool_free_isr(block);
+
+    block = os_mpool_alloc_isr(&tp_mp);
+    if (block != NULL)
+        tp_take(holder, block);
+    else
+        tp_dry[holder]++;
+
+    tp_ops[holder]++;
+}
+
+static void tp_isr0(void)
+{
+    tp_isr(0);
+}
+
+static void tp_isr1(void)
+{
+    tp_isr(1);
+}
+
+static void tp_timer_start(int sig, uint32_t irq, long ns)
+{
+    struct sigevent event;
+    struct itimerspec spec;
+    timer_t timer;
+
+    os_arch_sim_irq_signal(sig, irq);
+
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo  = sig;
+    SIM_CHECK(timer_create(CLOCK_MONOTONIC, &event, &timer) == 0);
+
+    spec.it_interval.tv_sec  = 0;
+    spec.it_interval.tv_nsec = ns;
+    spec.it_value            = spec.it_interval;
+    SIM_CHECK(timer_settime(timer, 0, &spec, NULL) == 0);
+}
+
+static void tp_task_entry(void *parameter)
+{
+    uint32_t holder = (uint32_t)parameter;
+    uint32_t slot;
+    void *block;
+
+    while (!tp_stop) {
+        block = tp_give(holder, tp_ops[holder] % TP_HOLD);
+        if (block != NULL)
+            os_mpool_free(block);
+
+        /* a short wait, the interrupts give blocks back meanwhile */
+        block = os_mpool_alloc(&tp_mp, 2);
+        if (block != NULL)
+            tp_take(holder, block);
+        else
+            tp_dry[holder]++;
+
+        tp_ops[holder]++;
+    }
+
+    /* the rest back to pool */
+    for (slot = 0; slot < TP_HOLD; slot++) {
+        block = tp_give(holder, slot);
+        if (block != NULL)
+            os_mpool_free(block);
+    }
+}
+
+static void tp_entry(void *parameter)
+{
+    uint8_t *block;
+    uint64_t end;
+    os_sr_t sr;
+    uint32_t count;
+    uint32_t i;
+
+    os_mpool_init(&tp_mp, tp_pool, sizeof(tp_pool), TP_BLOCK_SIZE);
+    SIM_CHECK(tp_mp.block_total_count == TP_BLOCKS);
+
+    os_arch_sim_irq_install(6, tp_isr0);
+    os_arch_sim_irq_install(7, tp_isr1);
+    tp_timer_start(SIGUSR1, 6, 31000);
+    tp_timer_start(SIGUSR2, 7, 37000);
+
+    for (i = 0; i < 2; i++) {
+        os_task_init(&tp_task[i], "mpool", tp_task_entry, (void *)(i + 2),
+                     &tp_stack[i][0], sizeof(tp_stack[i]), 20, 1);
+        os_task_startup(&tp_task[i]);
+    }
+
+    os_task_sleep(TP_SECONDS * OS_TICKS_PER_SEC);
+
+    /* interrupts and tasks stop, give back their blocks */
+    sr = os_enter_critical();
+    tp_stop = TRUE;
+    os_exit_critical(sr);
+
+    end = sim_test_ns() + 1000000000ULL;
+    while (tp_task[0].stat != OS_TASK_CLOSE ||
+           tp_task[1].stat != OS_TASK_CLOSE) {
+        SIM_CHECK(sim_test_ns() < end);
+        os_task_sleep(10);
+    }
+
+    for (i = 0; i < TP_HOLD * 2; i++) {
+        block = tp_give(i / TP_HOLD, i % TP_HOLD);
+        if (block != NULL)
+            os_mpool_free(block);
+    }
+
+    printf("interrupts %u %u, dry %u %u, tasks %u %u, dry %u %u\n",
+           tp_ops[0], tp_ops[1], tp_dry[0], tp_dry[1],
+           tp_ops[2], tp_ops[3], tp_dry[2], tp_dry[3]);
+    SIM_CHECK(tp_ops[0] > 1000 && tp_ops[1] > 1000);
+    SIM_CHECK(tp_ops[2] > 1000 && tp_ops[3] > 1000);
+    SIM_CHECK(tp_dry[0] + tp_dry[1] + tp_dry[2] + tp_dry[3] > 0);
+
+    /* every block is free once */
+    count = 0;
+    for (block = tp_mp.block_list; block != NULL; block = *(uint8_t **)block) {
+        SIM_CHECK(block >= tp_pool && block < tp_pool + sizeof(tp_pool));
+        SIM_CHECK(++count <= TP_BLOCKS);
+    }
+    SIM_CHECK(count == TP_BLOCKS);
+    SIM_CHECK(tp_mp.block_free_count == TP_BLOCKS);
+    SIM_CHECK(tp_mp.suspend_task_count == 0);
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(tp_entry, 10);
+
+    return 0;
+}
@@ -0,0 +1,403 @@
+/*
+ * File      : test_mutex.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      add os_task_priority_set under inheritance
+ * 2026-10-17     kontais      add nested priority ceiling mutexes
+ */
+
+/*
+ * Priority inversion latency of os_mutex in virtual time. A low task holds
+ * a mutex for a critical section of busy ticks, a high task takes it, and a
+ * middle task computes a long burst in between. The blocking of high task is
+ * the ticks from its os_mutex_take to the return. Each case runs 200 seeded
+ * rounds with the phases at random, the worst blocking stays within the
+ * critical sections in the way, however long the middle burst is:
+ *
+ *   direct     high waits for low,                   bound cs
+ *   chain      high waits for mid, mid waits for low, bound cs + 2
+ *
+ * Then the priority of an owner is given back as soon as a waiter times out,
+ * and step by step as it releases the mutexes it holds. At last
+ * os_task_priority_set of a waiter goes on to the owner, and that of an
+ * owner changes the priority it falls back to, not the one it inherits.
+ * Nested priority ceiling mutexes raise to the higher ceiling and step back
+ * in reverse order, under the priority set and the one inherited.
+ */
+
+#include <sim_test.h>
+
+#define TX_ROUNDS               200
+#define TX_BURST                40
+#define TX_CS_MAX               6
+
+#define TX_PRIO_HIGH            10
+#define TX_PRIO_BURST           20
+#define TX_PRIO_MID             25
+#define TX_PRIO_LOW             30
+
+enum
+{
+    TX_LOW,
+    TX_MID,
+    TX_BURSTER,
+    TX_HIGH,
+    TX_TASKS,
+};
+
+static os_task_t tx_task[TX_TASKS];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tx_stack[TX_TASKS][1024];
+
+static os_mutex_t tx_a;
+static os_mutex_t tx_b;
+
+/* the phases of a round */
+static os_tick_t tx_cs;
+static os_tick_t tx_high_at;
+static os_tick_t tx_burst_at;
+static os_tick_t tx_blocking;
+static os_tick_t tx_low_end;
+static os_tick_t tx_burst_end;
+static uint32_t tx_started;
+
+static void tx_start(uint32_t index, void (*entry)(void *parameter), uint8_t priority)
+{
+    SIM_CHECK(os_task_init(&tx_task[index], "tx", entry, NULL,
+                           &tx_stack[index][0], sizeof(tx_stack[index]),
+                           priority, 10) == OS_OK);
+    os_task_startup(&tx_task[index]);
+
+    tx_started |= 1UL << index;
+}
+
+/* wait for the tasks started in a round to end */
+static void tx_join(void)
+{
+    os_tick_t end = os_tick_get() + 1000;
+    uint32_t i;
+
+    for (i = 0; i < TX_TASKS; i++) {
+        while ((tx_started & (1UL << i)) &&
+               tx_task[i].stat != OS_TASK_CLOSE) {
+            SIM_CHECK((int32_t)(end - os_tick_get()) > 0);
+            os_task_sleep(10);
+        }
+    }
+
+    tx_started = 0;
+}
+
+static void tx_low_hold(os_mutex_t *mutex)
+{
+    os_mutex_take(mutex, OS_WAIT_FOREVER);
+    os_arch_sim_busy(tx_cs);
+    os_mutex_release(mutex);
+
+    tx_low_end = os_tick_get();
+}
+
+static void tx_low_entry(void *parameter)
+{
+    tx_low_hold(&tx_a);
+}
+
+static void tx_chain_low_entry(void *parameter)
+{
+    tx_low_hold(&tx_b);
+}
+
+/* mid takes a, then b held by low, one tick of work under each */
+static void tx_mid_entry(void *parameter)
+{
+    os_task_sleep(1);
+
+    os_mutex_take(&tx_a, OS_WAIT_FOREVER);
+    os_arch_sim_busy(1);
+    os_mutex_take(&tx_b, OS_WAIT_FOREVER);
+    os_arch_sim_busy(1);
+    os_mutex_release(&tx_b);
+    os_mutex_release(&tx_a);
+}
+
+static void tx_burst_entry(void *parameter)
+{
+    os_task_sleep(tx_burst_at);
+    os_arch_sim_busy(TX_BURST);
+
+    tx_burst_end = os_tick_get();
+}
+
+static void tx_high_entry(void *parameter)
+{
+    os_tick_t tick;
+
+    os_task_sleep(tx_high_at);
+
+    tick = os_tick_get();
+    SIM_CHECK(os_mutex_take(&tx_a, OS_WAIT_FOREVER) == OS_OK);
+    tx_blocking = os_tick_get() - tick;
+    os_mutex_release(&tx_a);
+}
+
+static void tx_case(const char *name, bool_t chain)
+{
+    os_tick_t worst = 0;
+    os_tick_t bound;
+    uint32_t round;
+
+    for (round = 0; round < TX_ROUNDS; round++) {
+        os_arch_sim_seed(round + 1);
+
+        tx_cs       = 1 + os_arch_sim_random() % TX_CS_MAX;
+        tx_high_at  = 2 + os_arch_sim_random() % tx_cs;
+        tx_burst_at = 2 + os_arch_sim_random() % tx_cs;
+        tx_blocking = 0;
+
+        os_mutex_init(&tx_a, OS_IPC_PRIO);
+        os_mutex_init(&tx_b, OS_IPC_PRIO);
+
+        /* low first, it holds the mutex before the others wake */
+        if (chain == TRUE) {
+            tx_start(TX_LOW, tx_chain_low_entry, TX_PRIO_LOW);
+            tx_start(TX_MID, tx_mid_entry, TX_PRIO_MID);
+            bound = tx_cs + 2;
+        } else {
+            tx_start(TX_LOW, tx_low_entry, TX_PRIO_LOW);
+            bound = tx_cs;
+        }
+        tx_start(TX_BURSTER, tx_burst_entry, TX_PRIO_BURST);
+        tx_start(TX_HIGH, tx_high_entry, TX_PRIO_HIGH);
+
+        tx_join();
+
+        if (tx_blocking > worst)
+            worst = tx_blocking;
+        SIM_CHECK(tx_blocking <= bound);
+
+        os_mutex_delete(&tx_a);
+        os_mutex_delete(&tx_b);
+    }
+
+    printf("%s: %u rounds, worst blocking %u ticks, burst %u ticks\n",
+           name, TX_ROUNDS, worst, TX_BURST);
+}
+
+/* low holds a for 10 ticks, high gives up after 3, a burst comes meanwhile */
+static void tx_timeout_entry(void *parameter)
+{
+    os_task_sleep(1);
+
+    SIM_CHECK(tx_task[TX_LOW].current_priority == TX_PRIO_LOW);
+    SIM_CHECK(os_mutex_take(&tx_a, 3) == OS_TIMEOUT);
+
+    /* low gives back the priority lent at once, not on release */
+    SIM_CHECK(tx_task[TX_LOW].current_priority == TX_PRIO_LOW);
+    SIM_CHECK(tx_task[TX_LOW].stat != OS_TASK_CLOSE);
+    tx_high_at = os_tick_get();
+}
+
+static void tx_timeout(void)
+{
+    tx_cs       = 10;
+    tx_burst_at = 2;
+    os_mutex_init(&tx_a, OS_IPC_PRIO);
+
+    tx_start(TX_LOW, tx_low_entry, TX_PRIO_LOW);
+    tx_start(TX_MID, tx_timeout_entry, TX_PRIO_HIGH);
+    tx_start(TX_BURSTER, tx_burst_entry, TX_PRIO_BURST);
+    tx_join();
+
+    /* the burst ran before low went on */
+    SIM_CHECK((int32_t)(tx_low_end - tx_burst_end) > 0);
+    SIM_CHECK(tx_a.owner == NULL);
+
+    os_mutex_delete(&tx_a);
+
+    printf("timeout: owner back to priority %u at tick %u\n",
+           TX_PRIO_LOW, tx_high_at);
+}
+
+/* low holds a and b, two waiters lend it 10 and 15 */
+static void tx_nested_low_entry(void *parameter)
+{
+    os_mutex_take(&tx_a, OS_WAIT_FOREVER);
+    os_mutex_take(&tx_b, OS_WAIT_FOREVER);
+
+    /* the waiters block */
+    os_task_sleep(2);
+    SIM_CHECK(os_task_self()->current_priority == TX_PRIO_HIGH);
+
+    os_mutex_release(&tx_a);
+    SIM_CHECK(os_task_self()->current_priority == TX_PRIO_HIGH + 5);
+
+    os_mutex_release(&tx_b);
+    SIM_CHECK(os_task_self()->current_priority == TX_PRIO_LOW);
+}
+
+static void tx_nested_wait(os_mutex_t *mutex)
+{
+    os_task_sleep(1);
+
+    SIM_CHECK(os_mutex_take(mutex, OS_WAIT_FOREVER) == OS_OK);
+    os_mutex_release(mutex);
+}
+
+static void tx_nested_a_entry(void *parameter)
+{
+    tx_nested_wait(&tx_a);
+}
+
+static void tx_nested_b_entry(void *parameter)
+{
+    tx_nested_wait(&tx_b);
+}
+
+static void tx_nested(void)
+{
+    os_mutex_init(&tx_a, OS_IPC_PRIO);
+    os_mutex_init(&tx_b, OS_IPC_PRIO);
+
+    tx_start(TX_LOW, tx_nested_low_entry, TX_PRIO_LOW);
+    tx_start(TX_MID, tx_nested_a_entry, TX_PRIO_HIGH);
+    tx_start(TX_HIGH, tx_nested_b_entry, TX_PRIO_HIGH + 5);
+    tx_join();
+
+    os_mutex_delete(&tx_a);
+    os_mutex_delete(&tx_b);
+
+    printf("nested: owner steps back by each release\n");
+}
+
+/* low holds a, mid blocks on it, the test task changes both meanwhile */
+static void tx_set_owner_entry(void *parameter)
+{
+    os_mutex_take(&tx_a, OS_WAIT_FOREVER);
+    os_task_sleep(3);
+    os_mutex_release(&tx_a);
+
+    /* the base priority set while it inherited */
+    SIM_CHECK(os_task_self()->current_priority == TX_PRIO_MID);
+}
+
+static void tx_set(void)
+{
+    os_task_t *owner  = &tx_task[TX_LOW];
+    os_task_t *waiter = &tx_task[TX_MID];
+
+    os_mutex_init(&tx_a, OS_IPC_PRIO);
+
+    tx_start(TX_LOW, tx_set_owner_entry, TX_PRIO_LOW);
+    tx_start(TX_MID, tx_nested_a_entry, TX_PRIO_BURST);
+    os_task_sleep(2);
+    SIM_CHECK(owner->current_priority == TX_PRIO_BURST);
+
+    /* a waiter raised lends the owner more */
+    SIM_CHECK(os_task_priority_set(waiter, TX_PRIO_HIGH) == OS_OK);
+    SIM_CHECK(waiter->current_priority == TX_PRIO_HIGH);
+    SIM_CHECK(owner->current_priority == TX_PRIO_HIGH);
+
+    /* an owner set lower keeps what it inherits */
+    SIM_CHECK(os_task_priority_set(owner, TX_PRIO_MID) == OS_OK);
+    SIM_CHECK(owner->current_priority == TX_PRIO_HIGH);
+    SIM_CHECK(owner->init_priority == TX_PRIO_MID);
+
+    /* a waiter lowered below the owner lends it nothing */
+    SIM_CHECK(os_task_priority_set(waiter, TX_PRIO_LOW + 10) == OS_OK);
+    SIM_CHECK(owner->current_priority == TX_PRIO_MID);
+    SIM_CHECK(os_task_priority_set(waiter, TX_PRIO_HIGH) == OS_OK);
+    SIM_CHECK(owner->current_priority == TX_PRIO_HIGH);
+
+    tx_join();
+    SIM_CHECK(tx_a.owner == NULL);
+
+    os_mutex_delete(&tx_a);
+
+    printf("set: owner at %u from waiter, back to %u set\n",
+           TX_PRIO_HIGH, TX_PRIO_MID);
+}
+
+static void tx_ceiling_entry(void *parameter)
+{
+    os_task_t *self = os_task_self();
+    os_pcmutex_t outer;
+    os_pcmutex_t inner;
+
+    /* the outer ceiling is higher, the inner one changes nothing */
+    os_pcmutex_init(&outer, TX_PRIO_HIGH);
+    os_pcmutex_init(&inner, TX_PRIO_BURST);
+    SIM_CHECK(os_pcmutex_lock(&outer) == OS_OK);
+    SIM_CHECK(os_pcmutex_lock(&inner) == OS_OK);
+    SIM_CHECK(self->current_priority == TX_PRIO_HIGH);
+    SIM_CHECK(os_pcmutex_unlock(&inner) == OS_OK);
+    SIM_CHECK(self->current_priority == TX_PRIO_HIGH);
+    SIM_CHECK(os_pcmutex_unlock(&outer) == OS_OK);
+    SIM_CHECK(self->current_priority == TX_PRIO_LOW);
+
+    /* the inner ceiling is higher, back to the outer one */
+    os_pcmutex_init(&outer, TX_PRIO_BURST);
+    os_pcmutex_init(&inner, TX_PRIO_HIGH);
+    os_pcmutex_lock(&outer);
+    os_pcmutex_lock(&inner);
+    SIM_CHECK(self->current_priority == TX_PRIO_HIGH);
+    os_pcmutex_unlock(&inner);
+    SIM_CHECK(self->current_priority == TX_PRIO_BURST);
+
+    /* the priority set is the base under the ceiling */
+    os_task_priority_set(self, TX_PRIO_MID);
+    SIM_CHECK(self->current_priority == TX_PRIO_BURST);
+    os_pcmutex_unlock(&outer);
+    SIM_CHECK(self->current_priority == TX_PRIO_MID);
+    os_task_priority_set(self, TX_PRIO_LOW);
+
+    /* a mutex lends above the ceiling, its release leaves the ceiling */
+    os_pcmutex_lock(&outer);
+    os_mutex_take(&tx_a, OS_WAIT_FOREVER);
+    tx_start(TX_HIGH, tx_nested_a_entry, TX_PRIO_HIGH);
+    os_arch_sim_busy(2);
+    SIM_CHECK(self->current_priority == TX_PRIO_HIGH);
+    os_mutex_release(&tx_a);
+    SIM_CHECK(tx_task[TX_HIGH].stat == OS_TASK_CLOSE);
+    SIM_CHECK(self->current_priority == TX_PRIO_BURST);
+    os_pcmutex_unlock(&outer);
+    SIM_CHECK(self->current_priority == TX_PRIO_LOW);
+}
+
+static void tx_ceiling(void)
+{
+    os_mutex_init(&tx_a, OS_IPC_PRIO);
+
+    tx_start(TX_LOW, tx_ceiling_entry, TX_PRIO_LOW);
+    tx_join();
+
+    os_mutex_delete(&tx_a);
+
+    printf("ceiling: nested ceilings step back in reverse order\n");
+}
+
+static void tx_entry(void *parameter)
+{
+    tx_case("direct", FALSE);
+    tx_case("chain", TRUE);
+    tx_timeout();
+    tx_nested();
+    tx_set();
+    tx_ceiling();
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(tx_entry, 5);
+
+    return 0;
+}
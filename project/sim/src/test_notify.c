@@ -0,0 +1,163 @@
+/*
+ * File      : test_notify.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Task notification of OS_CFG_TASK_NOTIFY in virtual time:
+ *
+ *   action    an unknown action is rejected, the notification left as it
+ *             is, and no overwrite keeps a pending value
+ *   wake      a waiter above the notifier preempts it at once, one below
+ *             runs when the notifier blocks, from a task and an interrupt
+ *   timeout   a wait times out on its tick, a give before it wakes the
+ *             waiter at once
+ */
+
+#include <sim_test.h>
+
+#define TN_IRQ                  5
+
+static os_task_t tn_task;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tn_stack[1024];
+
+static volatile uint32_t tn_woken;
+static os_err_t  tn_err;
+static os_tick_t tn_waited;
+
+static void tn_action(void)
+{
+    os_task_t *self = os_task_self();
+    uint32_t value;
+
+    self->notify_value = 0x1234;
+    self->notify_state = OS_TASK_NOTIFY_IDLE;
+    SIM_CHECK(os_task_notify(self, 0xffff, 0x7f) == OS_ERROR);
+    SIM_CHECK(self->notify_value == 0x1234);
+    SIM_CHECK(self->notify_state == OS_TASK_NOTIFY_IDLE);
+
+    SIM_CHECK(os_task_notify(self, 0x10, OS_TASK_NOTIFY_NO_OVERWRITE) == OS_OK);
+    SIM_CHECK(os_task_notify(self, 0x20, OS_TASK_NOTIFY_NO_OVERWRITE) == OS_EFULL);
+    SIM_CHECK(os_task_notify_wait(0, 0xffffffff, &value, OS_NO_WAIT) == OS_OK);
+    SIM_CHECK(value == 0x10 && self->notify_value == 0);
+
+    printf("action ok\n");
+}
+
+static void tn_waiter_entry(void *parameter)
+{
+    os_tick_t tick;
+
+    while (1) {
+        tick = os_tick_get();
+        tn_err = os_task_notify_take(FALSE, NULL, (os_tick_t)parameter);
+        tn_waited = os_tick_get() - tick;
+        tn_woken++;
+    }
+}
+
+static void tn_start(uint8_t priority, os_tick_t timeout)
+{
+    tn_woken = 0;
+
+    SIM_CHECK(os_task_init(&tn_task, "waiter", tn_waiter_entry,
+                           (void *)timeout, &tn_stack[0], sizeof(tn_stack),
+                           priority, 10) == OS_OK);
+    os_task_startup(&tn_task);
+}
+
+static void tn_stop(void)
+{
+    os_task_delete(&tn_task);
+    /* let idle reclaim it before the object is initialized again */
+    os_task_sleep(1);
+}
+
+static void tn_isr(void)
+{
+    os_task_notify_give(&tn_task);
+}
+
+static void tn_wake(void)
+{
+    /* above, it blocked at startup, each give runs it at once */
+    tn_start(5, OS_WAIT_FOREVER);
+    SIM_CHECK(tn_task.notify_state == OS_TASK_NOTIFY_WAITING);
+
+    SIM_CHECK(os_task_notify_give(&tn_task) == OS_OK);
+    SIM_CHECK(tn_woken == 1 && tn_err == OS_OK);
+    SIM_CHECK(os_task_notify(&tn_task, 0, OS_TASK_NOTIFY_INCREMENT) == OS_OK);
+    SIM_CHECK(tn_woken == 2);
+
+    os_arch_sim_irq_install(TN_IRQ, tn_isr);
+    os_arch_sim_irq_raise(TN_IRQ);
+    SIM_CHECK(tn_woken == 3);
+    os_arch_sim_irq_install(TN_IRQ, NULL);
+    tn_stop();
+
+    /* below, it starts later and takes the gives one by one */
+    tn_start(20, OS_WAIT_FOREVER);
+    SIM_CHECK(tn_task.stat == OS_TASK_READY);
+    os_task_notify_give(&tn_task);
+    os_task_notify_give(&tn_task);
+    SIM_CHECK(tn_woken == 0);
+
+    os_task_sleep(1);
+    SIM_CHECK(tn_woken == 2 && tn_task.notify_value == 0);
+    SIM_CHECK(tn_task.notify_state == OS_TASK_NOTIFY_WAITING);
+
+    os_task_notify_give(&tn_task);
+    SIM_CHECK(tn_woken == 2 && tn_task.stat == OS_TASK_READY);
+    os_task_sleep(1);
+    SIM_CHECK(tn_woken == 3);
+    tn_stop();
+
+    printf("wake ok\n");
+}
+
+static void tn_timeout(void)
+{
+    /* times out after 10 ticks, again and again */
+    tn_start(5, 10);
+    os_task_sleep(25);
+    SIM_CHECK(tn_woken == 2 && tn_err == OS_TIMEOUT && tn_waited == 10);
+
+    /* a give before the timeout, it waits again with a new timeout */
+    os_task_notify_give(&tn_task);
+    SIM_CHECK(tn_woken == 3 && tn_err == OS_OK && tn_waited == 5);
+    SIM_CHECK(tn_task.notify_state == OS_TASK_NOTIFY_WAITING);
+    SIM_CHECK(tn_task.timer.flag & OS_TIMER_ACTIVATED);
+    os_task_sleep(5);
+    SIM_CHECK(tn_woken == 3);
+    os_task_sleep(5);
+    SIM_CHECK(tn_woken == 4 && tn_err == OS_TIMEOUT && tn_waited == 10);
+    tn_stop();
+
+    printf("timeout ok\n");
+}
+
+static void tn_entry(void *parameter)
+{
+    tn_action();
+    tn_wake();
+    tn_timeout();
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(tn_entry, 10);
+
+    return 0;
+}
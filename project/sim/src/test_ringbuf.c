@@ -0,0 +1,174 @@
+/*
+ * File      : test_ringbuf.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Ring buffer under interrupt stress, in wall clock time. A host timer
+ * signal every 20us raises an interrupt which writes a counting sequence by
+ * putc, write or reserve and commit, as much as fits. The signal lands on
+ * any instruction of consumer, which takes the bytes by a blocking read, a
+ * polling read or peek and release, and checks that none is lost, repeated
+ * or torn.
+ */
+
+#include <sim_test.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+#define TR_IRQ                  6
+#define TR_SIZE                 256
+#define TR_BYTES                (4UL << 20)
+#define TR_SECONDS              30
+
+static os_ringbuf_t tr_rb;
+static uint8_t      tr_pool[TR_SIZE];
+
+/* producer state, touched in interrupt only */
+static uint8_t  tr_seq;
+static uint32_t tr_state = 1;
+static uint32_t tr_irqs;
+static uint32_t tr_full;
+
+static uint32_t tr_random(void)
+{
+    tr_state = tr_state * 1103515245 + 12345;
+
+    return tr_state >> 16;
+}
+
+static void tr_isr(void)
+{
+    uint8_t chunk[64];
+    uint8_t *ptr;
+    uint32_t size;
+    uint32_t done;
+    uint32_t i;
+
+    tr_irqs++;
+    size = 1 + tr_random() % sizeof(chunk);
+
+    switch (tr_random() % 3) {
+    case 0:
+        for (done = 0; done < size; done++) {
+            if (os_ringbuf_putc(&tr_rb, tr_seq) != OS_OK)
+                break;
+            tr_seq++;
+        }
+        break;
+
+    case 1:
+        for (i = 0; i < size; i++)
+            chunk[i] = tr_seq + i;
+        done = os_ringbuf_write(&tr_rb, chunk, size);
+        tr_seq += done;
+        break;
+
+    default:
+        done = os_ringbuf_reserve(&tr_rb, &ptr);
+        if (done > size)
+            done = size;
+        for (i = 0; i < done; i++)
+            ptr[i] = tr_seq++;
+        os_ringbuf_commit(&tr_rb, done);
+        break;
+    }
+
+    if (done < size)
+        tr_full++;
+}
+
+static void tr_timer_start(void)
+{
+    struct sigevent event;
+    struct itimerspec spec;
+    timer_t timer;
+
+    os_arch_sim_irq_signal(SIGUSR1, TR_IRQ);
+
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo  = SIGUSR1;
+    SIM_CHECK(timer_create(CLOCK_MONOTONIC, &event, &timer) == 0);
+
+    spec.it_interval.tv_sec  = 0;
+    spec.it_interval.tv_nsec = 20000;
+    spec.it_value            = spec.it_interval;
+    SIM_CHECK(timer_settime(timer, 0, &spec, NULL) == 0);
+}
+
+static void tr_entry(void *parameter)
+{
+    uint8_t buffer[TR_SIZE];
+    uint8_t expect = 0;
+    uint8_t *ptr;
+    uint32_t total = 0;
+    uint32_t empty = 0;
+    uint32_t size;
+    uint32_t i;
+    uint64_t end;
+
+    SIM_CHECK(os_ringbuf_init(&tr_rb, tr_pool, TR_SIZE - 1) == OS_ERROR);
+    SIM_CHECK(os_ringbuf_init(&tr_rb, tr_pool, TR_SIZE) == OS_OK);
+
+    os_arch_sim_irq_install(TR_IRQ, tr_isr);
+    tr_timer_start();
+
+    end = sim_test_ns() + TR_SECONDS * 1000000000ULL;
+    while (total < TR_BYTES) {
+        SIM_CHECK(sim_test_ns() < end);
+
+        switch (total % 3) {
+        case 0:
+            size = os_ringbuf_read(&tr_rb, buffer, 1 + total % TR_SIZE, 2);
+            break;
+
+        case 1:
+            size = os_ringbuf_read(&tr_rb, buffer, sizeof(buffer), OS_NO_WAIT);
+            break;
+
+        default:
+            size = os_ringbuf_peek(&tr_rb, &ptr);
+            memcpy(buffer, ptr, size);
+            os_ringbuf_release(&tr_rb, size);
+            break;
+        }
+
+        if (size == 0) {
+            empty++;
+            continue;
+        }
+
+        for (i = 0; i < size; i++)
+            SIM_CHECK(buffer[i] == expect++);
+        total += size;
+
+        /* let it fill up now and then */
+        if (total % 7 == 0)
+            for (i = 0; i < 100000; i++)
+                COMPILER_BARRIER();
+    }
+
+    printf("%u bytes in %u interrupts, %u full, %u empty reads\n",
+           total, tr_irqs, tr_full, empty);
+    SIM_CHECK(tr_full > 0);
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(tr_entry, 10);
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * File      : test_stats.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * CPU usage accounting of OS_CFG_TASK_STATS, in wall clock time. A task
+ * spins in bursts of 200us, each one after a sleep of a tick, so that it
+ * always leaves between two ticks. The cycles charged to it are the spin
+ * time it measured itself, not charged to the idle task it leaves to, and
+ * the cpu load is its share of the run.
+ */
+
+#include <sim_test.h>
+
+#define TS_BURSTS               200
+#define TS_BURST_NS             200000
+
+static os_task_t ts_task;
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t ts_stack[2048];
+
+static uint64_t ts_spun;
+static volatile bool_t ts_done;
+
+static void ts_spin_entry(void *parameter)
+{
+    uint64_t ns;
+    uint64_t now;
+    uint32_t i;
+
+    for (i = 0; i < TS_BURSTS; i++) {
+        os_task_sleep(1);
+
+        ns = sim_test_ns();
+        do {
+            now = sim_test_ns();
+        } while (now - ns < TS_BURST_NS);
+        ts_spun += now - ns;
+    }
+
+    ts_done = TRUE;
+}
+
+static void ts_entry(void *parameter)
+{
+    os_task_stats_t stats;
+    uint64_t cycles;
+    uint64_t ns;
+    uint32_t load;
+    uint32_t want;
+
+    SIM_CHECK(os_task_init(&ts_task, "spin", ts_spin_entry, NULL,
+                           &ts_stack[0], sizeof(ts_stack), 10, 10) == OS_OK);
+
+    /* the load is counted from here */
+    os_cpu_load_get();
+    cycles = os_sched_cycles_get();
+    ns     = sim_test_ns();
+
+    os_task_startup(&ts_task);
+    while (ts_done == FALSE)
+        os_task_sleep(10);
+
+    load   = os_cpu_load_get();
+    cycles = os_sched_cycles_get() - cycles;
+    ns     = sim_test_ns() - ns;
+    os_task_stats_get(&ts_task, &stats);
+
+    printf("spun %u us, charged %u us, in %u us\n",
+           (uint32_t)(ts_spun / 1000), (uint32_t)(stats.run_cycles / 1000),
+           (uint32_t)(ns / 1000));
+
+    /* the entry and the sleeps add a little, the spin is all of it */
+    SIM_CHECK(stats.run_cycles >= ts_spun * 95 / 100);
+    SIM_CHECK(stats.run_cycles <= ts_spun * 110 / 100);
+
+    /* the cycles of sleeps are idle, the load is the spin */
+    want = (uint32_t)(ts_spun * 1000 / cycles);
+    printf("load %u permille, spin %u permille\n", load, want);
+    SIM_CHECK(load + 20 >= want && load <= want + 50);
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(ts_entry, 5);
+
+    return 0;
+}
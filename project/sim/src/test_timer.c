@@ -0,0 +1,264 @@
+/*
+ * File      : test_timer.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ * 2026-10-17     kontais      add a blocking soft timer callback
+ */
+
+/*
+ * Timers in virtual time, built with the wheel and with the sorted list:
+ *
+ *   random    one shot timers of random length fire on their very tick
+ *   periodic  overrun policies of a periodic timer behind its deadlines
+ *   until     os_task_sleep_until keeps the phase, and reports a late period
+ *   idle      long tickless sleeps, the timers catch up in no time per tick
+ *   blocking  a soft timer callback sleeps and waits on a semaphore, other
+ *             soft timers started meanwhile leave it in its waits
+ */
+
+#include <sim_test.h>
+
+#define TT_TIMERS               200
+
+static os_timer_t tt_timer[TT_TIMERS];
+static os_tick_t  tt_fired[TT_TIMERS];
+
+static os_timer_t tt_catchup, tt_skip, tt_report, tt_soft;
+static uint32_t   tt_catchup_n, tt_skip_n, tt_report_n, tt_soft_n;
+
+#ifdef OS_CFG_TIMER_SOFT
+static os_timer_t tt_block, tt_other[2];
+static os_sem_t   tt_block_sem;
+static os_tick_t  tt_block_slept, tt_block_waited;
+static os_err_t   tt_block_err;
+static uint32_t   tt_other_n;
+#endif
+
+static void tt_fire(void *parameter)
+{
+    tt_fired[(uint32_t)parameter] = os_tick_get();
+}
+
+static void tt_count(void *parameter)
+{
+    (*(uint32_t *)parameter)++;
+}
+
+/* a tick interrupt handled late by n ticks */
+static void tt_late(os_tick_t tick)
+{
+    os_sr_t sr;
+
+    sr = os_enter_critical();
+    os_tick_advance(tick);
+    os_exit_critical(sr);
+}
+
+static void tt_random(void)
+{
+    os_tick_t start;
+    os_tick_t interval;
+    uint32_t i;
+
+    os_arch_sim_seed(1234);
+
+    /* a few beyond the range of wheel, they are re-hashed */
+    start = os_tick_get();
+    for (i = 0; i < TT_TIMERS; i++) {
+        if (i % 50 == 0)
+            interval = (1UL << 20) + os_arch_sim_random() % (1UL << 21);
+        else
+            interval = 1 + os_arch_sim_random() % (1UL << (i % 20 + 1));
+
+        tt_fired[i] = 0;
+        os_timer_init(&tt_timer[i], tt_fire, (void *)i, interval, 0);
+        os_timer_start(&tt_timer[i]);
+    }
+
+    os_task_sleep(3UL << 20);
+
+    for (i = 0; i < TT_TIMERS; i++)
+        SIM_CHECK(tt_fired[i] == start + tt_timer[i].interval_tick);
+}
+
+static void tt_periodic(void)
+{
+    os_tick_t start;
+
+    start = os_tick_get();
+
+    os_timer_init(&tt_catchup, tt_count, &tt_catchup_n, 10,
+                  OS_TIMER_PERIODIC);
+    os_timer_init(&tt_skip, tt_count, &tt_skip_n, 10,
+                  OS_TIMER_PERIODIC | OS_TIMER_OVERRUN_SKIP);
+    os_timer_init(&tt_report, tt_count, &tt_report_n, 10,
+                  OS_TIMER_PERIODIC | OS_TIMER_OVERRUN_REPORT);
+    os_timer_start(&tt_catchup);
+    os_timer_start(&tt_skip);
+    os_timer_start(&tt_report);
+#ifdef OS_CFG_TIMER_SOFT
+    os_timer_init(&tt_soft, tt_count, &tt_soft_n, 10,
+                  OS_TIMER_PERIODIC | OS_TIMER_SOFT | OS_TIMER_OVERRUN_SKIP);
+    os_timer_start(&tt_soft);
+#endif
+
+    os_task_sleep(95);
+    SIM_CHECK(tt_catchup_n == 9 && tt_skip_n == 9 && tt_report_n == 9);
+
+    /* 100, 110 and 120 pass in one late tick at 130, skip drops 110 and 120 */
+    tt_late(35);
+    os_task_sleep(1);
+    SIM_CHECK(os_tick_get() == start + 131);
+    SIM_CHECK(tt_catchup_n == 13);
+    SIM_CHECK(tt_skip_n == 11);
+    SIM_CHECK(tt_report_n == 11);
+    SIM_CHECK(os_timer_overrun_get(&tt_report) == 2);
+
+    /* the phase is kept, a fire every 10 ticks up to 100000 */
+    os_task_sleep(100000 - 131 + 5);
+    SIM_CHECK(tt_catchup_n == 10000);
+    SIM_CHECK(tt_skip_n == 9998);
+    SIM_CHECK(tt_report_n == 9998);
+    SIM_CHECK(os_timer_overrun_get(&tt_report) == 0);
+#ifdef OS_CFG_TIMER_SOFT
+    SIM_CHECK(tt_soft_n == 9998);
+#endif
+
+    os_timer_stop(&tt_catchup);
+    os_timer_stop(&tt_skip);
+    os_timer_stop(&tt_report);
+#ifdef OS_CFG_TIMER_SOFT
+    os_timer_stop(&tt_soft);
+#endif
+}
+
+static void tt_until(void)
+{
+    os_tick_t last;
+    os_tick_t start;
+    uint32_t i;
+
+    last  = os_tick_get();
+    start = last;
+    for (i = 0; i < 60000; i++)
+        SIM_CHECK(os_task_sleep_until(&last, 1) == OS_OK);
+    SIM_CHECK(os_tick_get() - start == 60000);
+
+    /* late by 25, two periods return at once, the third keeps the phase */
+    last  = os_tick_get();
+    start = last;
+    tt_late(25);
+    SIM_CHECK(os_task_sleep_until(&last, 10) == OS_TIMEOUT);
+    SIM_CHECK(os_task_sleep_until(&last, 10) == OS_TIMEOUT);
+    SIM_CHECK(os_tick_get() - start == 25);
+
+    SIM_CHECK(os_task_sleep_until(&last, 10) == OS_OK);
+    SIM_CHECK(os_tick_get() - start == 30 && last - start == 30);
+}
+
+static void tt_idle(void)
+{
+    os_tick_t start;
+    uint64_t ns;
+    uint32_t i;
+
+    /* a far timer keeps the upper levels of wheel busy */
+    tt_fired[0] = 0;
+    os_timer_init(&tt_timer[0], tt_fire, (void *)0, 1UL << 30, 0);
+    os_timer_start(&tt_timer[0]);
+
+    /* 100 sleeps of 100000 ticks, each one caught up at once */
+    start = os_tick_get();
+    ns    = sim_test_ns();
+    for (i = 0; i < 100; i++)
+        os_task_sleep(100000);
+    ns    = sim_test_ns() - ns;
+
+    printf("idle: 10000000 ticks in %u us\n", (uint32_t)(ns / 1000));
+    SIM_CHECK(os_tick_get() - start == 10000000);
+    SIM_CHECK(ns < 10000000);
+
+    os_task_sleep(1UL << 30);
+    SIM_CHECK(tt_fired[0] == start + (1UL << 30));
+}
+
+#ifdef OS_CFG_TIMER_SOFT
+static void tt_block_fire(void *parameter)
+{
+    os_tick_t tick;
+
+    tick = os_tick_get();
+    os_task_sleep(50);
+    tt_block_slept = os_tick_get() - tick;
+
+    tick = os_tick_get();
+    tt_block_err = os_sem_take(&tt_block_sem, 100);
+    tt_block_waited = os_tick_get() - tick;
+}
+
+static void tt_blocking(void)
+{
+    os_sem_init(&tt_block_sem, 0, OS_IPC_PRIO);
+    os_timer_init(&tt_block, tt_block_fire, NULL, 1, OS_TIMER_SOFT);
+    os_timer_init(&tt_other[0], tt_count, &tt_other_n, 5, OS_TIMER_SOFT);
+    os_timer_init(&tt_other[1], tt_count, &tt_other_n, 5, OS_TIMER_SOFT);
+
+    /* fires at 1, sleeps to 51, then waits on the semaphore */
+    os_timer_start(&tt_block);
+
+    os_task_sleep(5);
+    os_timer_start(&tt_other[0]);
+
+    os_task_sleep(55);
+    os_timer_start(&tt_other[1]);
+
+    /* given at 80, the other timers are late behind the callback */
+    os_task_sleep(20);
+    SIM_CHECK(tt_other_n == 0);
+    os_sem_give(&tt_block_sem);
+    os_task_sleep(1);
+
+    SIM_CHECK(tt_block_slept == 50);
+    SIM_CHECK(tt_block_err == OS_OK && tt_block_waited == 29);
+    SIM_CHECK(tt_other_n == 2);
+
+    os_sem_delete(&tt_block_sem);
+}
+#endif
+
+static void tt_entry(void *parameter)
+{
+    tt_random();
+    printf("random ok\n");
+
+    tt_periodic();
+    printf("periodic ok\n");
+
+    tt_until();
+    printf("until ok\n");
+
+    tt_idle();
+    printf("idle ok\n");
+
+#ifdef OS_CFG_TIMER_SOFT
+    tt_blocking();
+    printf("blocking ok\n");
+#endif
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(tt_entry, 10);
+
+    return 0;
+}
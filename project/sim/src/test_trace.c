@@ -0,0 +1,253 @@
+/*
+ * File      : test_trace.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Kernel trace of OS_CFG_TRACE in virtual time, from the recorder through
+ * tools/trace2json.py. Two tasks ping pong a semaphore, one allocates and
+ * frees a block each round, the other sleeps, and a scripted interrupt comes
+ * every 7 ticks. The trace runs from tick 4000 to 4400, the ring of 256
+ * events is wrapped over and the 32 bit nanosecond stamps of virtual time
+ * wrap at tick 4294.
+ *
+ *   round trip   the dump converted by trace2json.py holds as many events of
+ *                each kind as the dump, under the task names, and its time
+ *                goes on past the wrap of stamps
+ *   cost         host nanoseconds of a recorded event, and of one while the
+ *                trace is stopped
+ */
+
+#include <sim_test.h>
+#include <string.h>
+
+#define TR_START                4000
+#define TR_TICKS                400
+#define TR_IRQ                  5
+#define TR_COST_EVENTS          1000000
+
+/* a chrome trace event name per kind of kernel event, by type */
+static const char *tr_json_name[] =
+{
+    NULL,
+    NULL,               /* OS_TRACE_TASK_NAME is not an event of its own */
+    "\"name\": \"run\"",
+    "\"name\": \"isr\"",
+    "\"name\": \"isr\"",
+    "\"name\": \"block\"",
+    "\"name\": \"wake\"",
+    "\"name\": \"timer\"",
+    "\"name\": \"malloc\"",
+    "\"name\": \"free\"",
+};
+
+#define TR_TYPES                (sizeof(tr_json_name) / sizeof(tr_json_name[0]))
+
+static os_task_t tr_task[2];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tr_stack[2][1024];
+
+static os_sem_t tr_sem;
+static volatile bool_t tr_stop;
+
+static uint32_t tr_count[TR_TYPES];
+static char tr_json[256 * 1024];
+
+static void tr_isr(void)
+{
+}
+
+static void tr_ping_entry(void *parameter)
+{
+    void *block;
+
+    while (!tr_stop) {
+        os_sem_take(&tr_sem, 20);
+
+        block = os_malloc(32);
+        SIM_CHECK(block != NULL);
+        os_free(block);
+    }
+}
+
+static void tr_pong_entry(void *parameter)
+{
+    while (!tr_stop) {
+        os_task_sleep(10);
+        os_sem_give(&tr_sem);
+    }
+}
+
+/* count the events of dump by kind, and write it where trace2json.py reads */
+static void tr_output(const void *data, uint32_t size)
+{
+    const struct os_trace_buffer *buffer = data;
+    uint32_t first;
+    uint32_t type;
+    uint32_t i;
+    FILE *f;
+
+    SIM_CHECK(size == sizeof(struct os_trace_buffer));
+    SIM_CHECK(buffer->magic == OS_TRACE_MAGIC);
+    SIM_CHECK(buffer->index > OS_TRACE_EVENTS);
+
+    first = buffer->index - OS_TRACE_EVENTS;
+    for (i = first; i < buffer->index; i++) {
+        type = buffer->event[i & (OS_TRACE_EVENTS - 1)].type;
+        SIM_CHECK(type < TR_TYPES);
+        tr_count[type]++;
+    }
+
+    f = fopen(TR_DUMP, "wb");
+    SIM_CHECK(f != NULL);
+    SIM_CHECK(fwrite(data, size, 1, f) == 1);
+    fclose(f);
+}
+
+static uint32_t tr_json_count(const char *name)
+{
+    const char *p = tr_json;
+    uint32_t count = 0;
+
+    while ((p = strstr(p, name)) != NULL) {
+        count++;
+        p += strlen(name);
+    }
+
+    return count;
+}
+
+/* the latest time in the chrome trace, in microseconds */
+static double tr_json_last(void)
+{
+    const char *p = tr_json;
+    double last = 0;
+    double ts;
+
+    while ((p = strstr(p, "\"ts\": ")) != NULL) {
+        p += strlen("\"ts\": ");
+        ts = strtod(p, NULL);
+        SIM_CHECK(ts >= 0);
+        if (ts > last)
+            last = ts;
+    }
+
+    return last;
+}
+
+static void tr_round_trip(void)
+{
+    uint32_t type;
+    uint32_t want;
+    size_t len;
+    FILE *f;
+
+    f = popen("python3 " TR_TRACE2JSON " " TR_DUMP, "r");
+    SIM_CHECK(f != NULL);
+    len = fread(tr_json, 1, sizeof(tr_json) - 1, f);
+    SIM_CHECK(pclose(f) == 0);
+    SIM_CHECK(len > 0 && len < sizeof(tr_json) - 1);
+    tr_json[len] = '\0';
+
+    for (type = OS_TRACE_SWITCH; type < TR_TYPES; type++) {
+        SIM_CHECK(tr_count[type] > 0);
+
+        /* enter and leave are both isr */
+        want = tr_count[type];
+        if (type == OS_TRACE_ISR_ENTER || type == OS_TRACE_ISR_LEAVE)
+            want = tr_count[OS_TRACE_ISR_ENTER] + tr_count[OS_TRACE_ISR_LEAVE];
+
+        SIM_CHECK(tr_json_count(tr_json_name[type]) == want);
+    }
+
+    SIM_CHECK(strstr(tr_json, "\"name\": \"ping\"") != NULL);
+    SIM_CHECK(strstr(tr_json, "\"name\": \"pong\"") != NULL);
+
+    /* 4294967 us is the wrap of stamps, the trace ends at tick 4400 */
+    SIM_CHECK(tr_json_last() > 4294967.0);
+    SIM_CHECK(tr_json_last() <= (TR_START + TR_TICKS) * 1000.0);
+
+    printf("round trip: %u switches, %u isr, %u block, %u wake, %u timer, "
+           "%u malloc, %u free\n",
+           tr_count[OS_TRACE_SWITCH], tr_count[OS_TRACE_ISR_ENTER],
+           tr_count[OS_TRACE_IPC_BLOCK], tr_count[OS_TRACE_IPC_WAKE],
+           tr_count[OS_TRACE_TIMER], tr_count[OS_TRACE_MALLOC],
+           tr_count[OS_TRACE_FREE]);
+}
+
+static void tr_cost(void)
+{
+    uint64_t recorded;
+    uint64_t stopped;
+    uint32_t i;
+
+    os_trace_start();
+    recorded = sim_test_ns();
+    for (i = 0; i < TR_COST_EVENTS; i++)
+        OS_TRACE(OS_TRACE_TIMER, 0, i, 0);
+    recorded = sim_test_ns() - recorded;
+    os_trace_stop();
+
+    stopped = sim_test_ns();
+    for (i = 0; i < TR_COST_EVENTS; i++)
+        OS_TRACE(OS_TRACE_TIMER, 0, i, 0);
+    stopped = sim_test_ns() - stopped;
+
+    printf("cost: %u.%02u ns a recorded event, %u.%02u ns stopped\n",
+           (uint32_t)(recorded / TR_COST_EVENTS),
+           (uint32_t)(recorded * 100 / TR_COST_EVENTS % 100),
+           (uint32_t)(stopped / TR_COST_EVENTS),
+           (uint32_t)(stopped * 100 / TR_COST_EVENTS % 100));
+}
+
+static void tr_entry(void *parameter)
+{
+    uint32_t i;
+
+    os_sem_init(&tr_sem, 0, OS_IPC_PRIO);
+    os_arch_sim_irq_install(TR_IRQ, tr_isr);
+    SIM_CHECK(os_arch_sim_irq_schedule(TR_IRQ, 7, 7, 0) == OS_OK);
+
+    SIM_CHECK(os_task_init(&tr_task[0], "ping", tr_ping_entry, NULL,
+                           &tr_stack[0][0], sizeof(tr_stack[0]),
+                           10, 10) == OS_OK);
+    SIM_CHECK(os_task_init(&tr_task[1], "pong", tr_pong_entry, NULL,
+                           &tr_stack[1][0], sizeof(tr_stack[1]),
+                           11, 10) == OS_OK);
+    for (i = 0; i < 2; i++)
+        os_task_startup(&tr_task[i]);
+
+    os_task_sleep(TR_START);
+    os_trace_start();
+    os_task_sleep(TR_TICKS);
+
+    /* names again in the dump, then not an event more */
+    os_trace_dump(tr_output);
+    os_trace_stop();
+
+    tr_stop = TRUE;
+    while (tr_task[0].stat != OS_TASK_CLOSE ||
+           tr_task[1].stat != OS_TASK_CLOSE)
+        os_task_sleep(10);
+
+    tr_round_trip();
+    tr_cost();
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(tr_entry, 5);
+
+    return 0;
+}
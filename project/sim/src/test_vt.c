@@ -0,0 +1,202 @@
+/*
+ * File      : test_vt.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Virtual time of simulator, OS_CFG_SIM_VIRTUAL_TIME. Each case is a kernel
+ * run in a child process:
+ *
+ *   hour      an hour of sleep and a jittered interrupt, same seed same run
+ *   blocked   a run with all tasks blocked forever exits at once
+ *   busy      busy ticks are preempted by a timer, and sliced
+ */
+
+#include <sim_test.h>
+#include <string.h>
+
+#define VT_IRQ                  5
+#define VT_HOUR                 (3600 * OS_TICKS_PER_SEC)
+
+static os_task_t vt_task[2];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t vt_stack[2][1024];
+
+static os_sem_t vt_sem;
+static uint32_t vt_seed;
+static uint32_t vt_hash = 2166136261u;
+static os_tick_t vt_order[8];
+static uint32_t vt_order_n;
+
+static void vt_mix(uint32_t value)
+{
+    vt_hash = (vt_hash ^ value) * 16777619u;
+}
+
+static void vt_task_create(uint32_t index,
+                           void (*entry)(void *parameter),
+                           uint8_t priority,
+                           os_tick_t slice)
+{
+    os_task_init(&vt_task[index], "vt", entry, (void *)index,
+                 &vt_stack[index][0], sizeof(vt_stack[index]),
+                 priority, slice);
+    os_task_startup(&vt_task[index]);
+}
+
+/*
+ * hour, the interrupt gives a semaphore every 997 to 1047 ticks, the sleeper
+ * shall wake on the very tick
+ */
+static void vt_irq_isr(void)
+{
+    os_sem_give(&vt_sem);
+}
+
+static void vt_sleeper_entry(void *parameter)
+{
+    os_tick_t start = os_tick_get();
+
+    os_task_sleep(VT_HOUR);
+
+    printf("slept %u\n", (uint32_t)(os_tick_get() - start));
+    printf("hash %08x\n", vt_hash);
+    exit(EXIT_SUCCESS);
+}
+
+static void vt_waiter_entry(void *parameter)
+{
+    while (1) {
+        if (os_sem_take(&vt_sem, 5000) != OS_OK)
+            vt_mix(0xdead);
+        vt_mix(os_tick_get());
+    }
+}
+
+static void vt_hour_run(void)
+{
+    os_enter_critical();
+    os_init();
+
+    os_arch_sim_seed(vt_seed);
+    os_sem_init(&vt_sem, 0, OS_IPC_PRIO);
+    os_arch_sim_irq_install(VT_IRQ, vt_irq_isr);
+    os_arch_sim_irq_schedule(VT_IRQ, 100, 997, 50);
+
+    vt_task_create(0, vt_sleeper_entry, 10, 10);
+    vt_task_create(1, vt_waiter_entry, 9, 10);
+
+    os_start();
+}
+
+/*
+ * blocked, the only task waits forever for a semaphore nobody gives
+ */
+static void vt_blocked_entry(void *parameter)
+{
+    os_task_sleep(12345);
+    os_sem_take(&vt_sem, OS_WAIT_FOREVER);
+}
+
+static void vt_blocked_run(void)
+{
+    os_enter_critical();
+    os_init();
+
+    os_sem_init(&vt_sem, 0, OS_IPC_PRIO);
+    vt_task_create(0, vt_blocked_entry, 10, 10);
+
+    os_start();
+}
+
+/*
+ * busy, a higher task sleeping 10 ticks preempts 100 busy ticks on the very
+ * tick, two busy tasks of same priority go in slices of 5 ticks
+ */
+static void vt_preempter_entry(void *parameter)
+{
+    os_task_sleep(10);
+    vt_order[vt_order_n++] = os_tick_get();
+}
+
+static void vt_slice_entry(void *parameter)
+{
+    os_arch_sim_busy(12);
+    vt_order[vt_order_n++] = (uint32_t)parameter << 16 | os_tick_get();
+}
+
+static void vt_busy_entry(void *parameter)
+{
+    os_tick_t start;
+
+    vt_task_create(0, vt_preempter_entry, 5, 10);
+
+    start = os_tick_get();
+    os_arch_sim_busy(100);
+    SIM_CHECK(os_tick_get() - start == 100);
+    SIM_CHECK(vt_order_n == 1 && vt_order[0] == start + 10);
+
+    /* 0 runs 5, 1 runs 5, 0 runs 5, 1 runs 5, 0 runs 2, 1 runs 2 */
+    vt_order_n = 0;
+    start = os_tick_get();
+    vt_task_create(0, vt_slice_entry, 30, 5);
+    vt_task_create(1, vt_slice_entry, 30, 5);
+    os_task_sleep(100);
+    SIM_CHECK(vt_order_n == 2);
+    SIM_CHECK(vt_order[0] == (0 << 16 | (start + 22)));
+    SIM_CHECK(vt_order[1] == (1 << 16 | (start + 24)));
+
+    printf("busy ok\n");
+    exit(EXIT_SUCCESS);
+}
+
+static void vt_busy_run(void)
+{
+    sim_test_run(vt_busy_entry, 20);
+}
+
+int main(void)
+{
+    static char out[2][256];
+    int status;
+
+    /* hour, twice with a seed and once with another */
+    vt_seed = 42;
+    status = sim_test_fork(vt_hour_run, out[0], sizeof(out[0]));
+    printf("hour: %s", out[0]);
+    SIM_CHECK(status == 0);
+    SIM_CHECK(strstr(out[0], "slept 3600000\n") != NULL);
+
+    status = sim_test_fork(vt_hour_run, out[1], sizeof(out[1]));
+    SIM_CHECK(status == 0);
+    SIM_CHECK(strcmp(out[0], out[1]) == 0);
+
+    vt_seed = 7;
+    status = sim_test_fork(vt_hour_run, out[1], sizeof(out[1]));
+    SIM_CHECK(status == 0);
+    SIM_CHECK(strcmp(out[0], out[1]) != 0);
+
+    /* blocked */
+    status = sim_test_fork(vt_blocked_run, out[0], sizeof(out[0]));
+    printf("blocked: %s", out[0]);
+    SIM_CHECK(status == OS_ARCH_SIM_EXIT_BLOCKED);
+    SIM_CHECK(strstr(out[0], "at tick 12345\n") != NULL);
+
+    /* busy */
+    status = sim_test_fork(vt_busy_run, out[0], sizeof(out[0]));
+    printf("busy: %s", out[0]);
+    SIM_CHECK(status == 0);
+
+    sim_test_pass();
+
+    return 0;
+}
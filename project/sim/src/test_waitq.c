@@ -0,0 +1,161 @@
+/*
+ * File      : test_waitq.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Wait queue order of IPC objects in virtual time, built once with 8
+ * buckets and once with a bucket for every priority. Four tasks of priority
+ * 40, 41, 70 and 200 block on a semaphore, a message queue and a mailbox,
+ * then os_task_priority_set moves the last one to 39 and the first one to
+ * 250 while they wait. Each give wakes one task, the order of wakes is:
+ *
+ *   PRIO      200 (now 39), 41, 70, 40 (now 250)
+ *   FIFO      in the order they blocked, whatever their priority
+ */
+
+#include <sim_test.h>
+
+#define TW_WAITERS              4
+
+enum
+{
+    TW_SEM,
+    TW_MQUEUE,
+    TW_MBOX,
+};
+
+static const char *tw_name[] = {"sem", "mqueue", "mbox"};
+static const uint8_t tw_priority[TW_WAITERS] = {40, 41, 70, 200};
+
+static os_task_t tw_task[TW_WAITERS];
+ALIGN(OS_ALIGN_SIZE)
+static uint8_t tw_stack[TW_WAITERS][1024];
+
+static os_sem_t    tw_sem;
+static os_mqueue_t tw_mq;
+static uint8_t     tw_mq_pool[TW_WAITERS * (sizeof(uint32_t) + 16)];
+static os_mbox_t   tw_mb;
+static uint32_t    tw_mb_pool[TW_WAITERS];
+
+static uint32_t tw_kind;
+static uint32_t tw_order[TW_WAITERS];
+static uint32_t tw_count;
+
+static void tw_waiter_entry(void *parameter)
+{
+    uint32_t value;
+
+    switch (tw_kind) {
+    case TW_SEM:
+        SIM_CHECK(os_sem_take(&tw_sem, OS_WAIT_FOREVER) == OS_OK);
+        break;
+
+    case TW_MQUEUE:
+        SIM_CHECK(os_mqueue_get(&tw_mq, &value, sizeof(value),
+                                OS_WAIT_FOREVER) == OS_OK);
+        break;
+
+    case TW_MBOX:
+        SIM_CHECK(os_mbox_get(&tw_mb, &value, OS_WAIT_FOREVER) == OS_OK);
+        break;
+    }
+
+    tw_order[tw_count++] = (uint32_t)parameter;
+}
+
+static void tw_give(void)
+{
+    uint32_t value = 0;
+
+    switch (tw_kind) {
+    case TW_SEM:
+        os_sem_give(&tw_sem);
+        break;
+
+    case TW_MQUEUE:
+        os_mqueue_put(&tw_mq, &value, sizeof(value));
+        break;
+
+    case TW_MBOX:
+        os_mbox_put(&tw_mb, value);
+        break;
+    }
+}
+
+static void tw_case(uint32_t kind, uint8_t flag)
+{
+    static const uint32_t prio_order[TW_WAITERS] = {3, 1, 2, 0};
+    static const uint32_t fifo_order[TW_WAITERS] = {0, 1, 2, 3};
+    const uint32_t *order;
+    uint32_t i;
+
+    tw_kind  = kind;
+    tw_count = 0;
+
+    os_sem_init(&tw_sem, 0, flag);
+    os_mqueue_init(&tw_mq, tw_mq_pool, sizeof(uint32_t), sizeof(tw_mq_pool), flag);
+    os_mbox_init(&tw_mb, tw_mb_pool, TW_WAITERS, flag);
+
+    /* every waiter blocks at once, in the order of start */
+    for (i = 0; i < TW_WAITERS; i++) {
+        SIM_CHECK(os_task_init(&tw_task[i], "waiter", tw_waiter_entry,
+                               (void *)i, &tw_stack[i][0], sizeof(tw_stack[i]),
+                               tw_priority[i], 10) == OS_OK);
+        os_task_startup(&tw_task[i]);
+        os_task_sleep(1);
+        SIM_CHECK(tw_task[i].stat == OS_TASK_SUSPEND);
+    }
+
+    SIM_CHECK(os_task_priority_set(&tw_task[3], 39) == OS_OK);
+    SIM_CHECK(os_task_priority_set(&tw_task[0], 250) == OS_OK);
+
+    /* one wake a time, the task woken runs and ends */
+    for (i = 0; i < TW_WAITERS; i++) {
+        tw_give();
+        os_task_sleep(1);
+        SIM_CHECK(tw_count == i + 1);
+    }
+
+    order = flag == OS_IPC_PRIO ? prio_order : fifo_order;
+    for (i = 0; i < TW_WAITERS; i++)
+        SIM_CHECK(tw_order[i] == order[i]);
+
+    os_sem_delete(&tw_sem);
+    os_mqueue_delete(&tw_mq);
+    os_mbox_delete(&tw_mb);
+
+    printf("%s %s: %u %u %u %u\n", tw_name[kind],
+           flag == OS_IPC_PRIO ? "prio" : "fifo",
+           tw_order[0], tw_order[1], tw_order[2], tw_order[3]);
+}
+
+static void tw_entry(void *parameter)
+{
+    uint32_t kind;
+
+    printf("%u buckets\n", OS_IPC_WAITQ_LEVELS);
+
+    for (kind = TW_SEM; kind <= TW_MBOX; kind++) {
+        tw_case(kind, OS_IPC_PRIO);
+        tw_case(kind, OS_IPC_FIFO);
+    }
+
+    sim_test_pass();
+}
+
+int main(void)
+{
+    sim_test_run(tw_entry, 5);
+
+    return 0;
+}
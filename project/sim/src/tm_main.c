@@ -0,0 +1,42 @@
+/*
+ * File      : tm_main.c
+ * This file is part of RT-Thread RTOS
+ * COPYRIGHT (C) 2006 - 2013, RT-Thread Develop Team
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://openlab.rt-thread.com/license/LICENSE
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     kontais      the first version
+ */
+
+/*
+ * Thread-Metric benchmark of project/bench on the simulator, the init task of
+ * its application.c runs tm_main, the program exits after the last report.
+ */
+
+#include <os.h>
+#include <stdlib.h>
+
+int application_init(void);
+
+void tm_done(void)
+{
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+
+int main(void)
+{
+    os_enter_critical();
+
+    os_init();
+    application_init();
+
+    os_start();
+
+    /* never reach here */
+    return 0;
+}
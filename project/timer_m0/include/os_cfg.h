@@ -12,14 +12,51 @@
 
 #define IDLE_TASK_STACK_SIZE           512
 
+/* TASK */
+#define OS_CFG_TASK_NOTIFY
+#define OS_CFG_TASK_STACK_HWM                 // stack high water mark
+#define OS_TASK_STACK_SCAN_WORDS      8       // words scanned per task by idle
+//#define OS_CFG_TASK_FPU               // fpu owned per task, cortex-m4/m7, no fpu in isr
+//#define OS_CFG_TASK_STATS                   // per-task cpu usage accounting
+
+/* TIMER */
+//#define OS_CFG_TIMER_WHEEL
+#define OS_TIMER_WHEEL_BITS           4       // 16 slots per level
+#define OS_TIMER_WHEEL_LEVELS         4       // 2^16 ticks before re-hash
+
+//#define OS_CFG_TIMER_SOFT
+#define OS_TIMER_TASK_PRIO            4       // soft timer callbacks run here
+#define OS_TIMER_TASK_STACK_SIZE      512
+
+/* SCHEDULER */
+//#define OS_CFG_SCHED_EDF            // earliest deadline first band
+#define OS_SCHED_EDF_PRIO             8       // the priority reserved for EDF tasks
+//#define OS_CFG_SMP                    // symmetric multi processing, zynq7000
+#define OS_CPUS_NR                    2       // processors scheduled by kernel
+
+/* TICKLESS */
+//#define OS_CFG_TICKLESS
+#define OS_TICKLESS_MIN_TICK          2       // shorter idle keeps the tick
+
 /* DEBUG */
 #define OS_CFG_DEBUG
 #define OS_CFG_OVERFLOW_CHECK
+//#define OS_CFG_STACK_GUARD            // mpu guard at stack bottom, cortex-m3/m4/m7
+//#define OS_CFG_TRACE                  // binary kernel event trace
+#define OS_TRACE_EVENTS               256     // events kept, a power of two
+//#define OS_CFG_SIM_UCONTEXT           // posix simulator in one thread
+//#define OS_CFG_SIM_VIRTUAL_TIME       // deterministic virtual time, needs TICKLESS, MIN_TICK 1
+
+/* IPC */
+#define OS_IPC_WAITQ_LEVELS           4       // priority buckets of IPC wait queue
 
 /* HEAP */
 #define OS_CFG_HEAP
 #define OS_HEAP_SIZE                  16
 #define OS_HEAP_END                   (0x20000000 + OS_HEAP_SIZE * 1024)
+//#define OS_CFG_HEAP_TLSF              // O(1) two level segregated fit heap
+#define OS_HEAP_TLSF_SL_LOG2          4       // 16 lists per power of two
+#define OS_HEAP_TLSF_FL_MAX           20      // largest block 2^20 bytes
 
 #define OS_CONSOLE_BUF_SIZE           128
 
@@ -79,6 +79,7 @@
     #define ALIGN(n)                    __attribute__((aligned(n)))
     #define WEAK                        __weak
     #define STATIC_INLINE               static __inline
+    #define COMPILER_BARRIER()          __memory_changed()
     #define __API                       __declspec(dllexport)
 
 #elif defined (__IAR_SYSTEMS_ICC__)     /* for IAR Compiler */
@@ -90,6 +91,13 @@
     #define ALIGN(n)                    PRAGMA(data_alignment=n)
     #define WEAK                        __weak
     #define STATIC_INLINE                   static inline
+    #if defined (__ICCARM__)
+    /* an empty asm orders no memory access, the intrinsic does */
+    #include <intrinsics.h>
+    #define COMPILER_BARRIER()          __DMB()
+    #else
+    #define COMPILER_BARRIER()          __asm volatile ("" ::: "memory")
+    #endif
     #define __API
 
 #elif defined (__GNUC__)                /* GNU GCC Compiler */
@@ -106,6 +114,7 @@
     #define ALIGN(n)                    __attribute__((aligned(n)))
     #define WEAK                        __attribute__((weak))
     #define STATIC_INLINE               static __inline
+    #define COMPILER_BARRIER()          __asm volatile ("" ::: "memory")
     #define __API
 #elif defined (__ADSPBLACKFIN__)        /* for VisualDSP++ Compiler */
     #include <stdarg.h>
@@ -115,6 +124,7 @@
     #define ALIGN(n)                    __attribute__((aligned(n)))
     #define WEAK                        __attribute__((weak))
     #define STATIC_INLINE               static inline
+    #define COMPILER_BARRIER()          __asm volatile ("" ::: "memory")
     #define __API
 #elif defined (_MSC_VER)
     #include <stdarg.h>
@@ -124,6 +134,7 @@
     #define ALIGN(n)                    __declspec(align(n))
     #define WEAK
     #define STATIC_INLINE               static __inline
+    #define COMPILER_BARRIER()          _ReadWriteBarrier()
     #define __API
 #elif defined (__TI_COMPILER_VERSION__)
     #include <stdarg.h>
@@ -137,6 +148,7 @@
     #define ALIGN(n)
     #define WEAK
     #define STATIC_INLINE                   static inline
+    #define COMPILER_BARRIER()
     #define __API
 #else
     #error not supported tool chain
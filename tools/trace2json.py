@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+#
+# File      : trace2json.py
+# This file is part of RT-Thread RTOS
+#
+# Convert a kernel trace dump into Chrome trace event JSON, which opens in
+# chrome://tracing and https://ui.perfetto.dev.
+#
+# The dump is the bytes of os_trace_buffer, written by os_trace_dump() or
+# taken from a memory image of the target, the buffer is found by its magic.
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-17     kontais      the first version
+#
+
+import argparse
+import json
+import struct
+import sys
+
+OS_TRACE_MAGIC = 0x5254534F
+OS_TRACE_VERSION = 1
+
+HEADER = struct.Struct('<IHHIIII')
+EVENT = struct.Struct('<IBBHII')
+
+OS_TRACE_TASK_NAME = 0x01
+OS_TRACE_SWITCH = 0x02
+OS_TRACE_ISR_ENTER = 0x03
+OS_TRACE_ISR_LEAVE = 0x04
+OS_TRACE_IPC_BLOCK = 0x05
+OS_TRACE_IPC_WAKE = 0x06
+OS_TRACE_TIMER = 0x07
+OS_TRACE_MALLOC = 0x08
+OS_TRACE_FREE = 0x09
+
+# the tracks of cpu and interrupt, tasks follow them
+TID_CPU = 0
+TID_ISR = 1
+
+
+def find_buffer(image):
+    """return the offset of trace buffer in a dump or memory image"""
+    magic = struct.pack('<I', OS_TRACE_MAGIC)
+    offset = image.find(magic)
+    while offset >= 0:
+        if offset % 4 == 0 and offset + HEADER.size <= len(image):
+            version, event_size = HEADER.unpack_from(image, offset)[1:3]
+            if version == OS_TRACE_VERSION and event_size == EVENT.size:
+                return offset
+        offset = image.find(magic, offset + 1)
+
+    raise ValueError('no trace buffer found')
+
+
+def load_events(image):
+    """return the cycle frequency and events in recording order"""
+    offset = find_buffer(image)
+    (_, _, _, capacity, index, cycle_hz, _) = HEADER.unpack_from(image, offset)
+    offset += HEADER.size
+
+    if index > capacity:
+        first, count = index % capacity, capacity
+    else:
+        first, count = 0, index
+
+    events = []
+    for i in range(count):
+        pos = offset + ((first + i) % capacity) * EVENT.size
+        if pos + EVENT.size > len(image):
+            raise ValueError('trace buffer truncated')
+        events.append(EVENT.unpack_from(image, pos))
+
+    return cycle_hz, events
+
+
+def unwrap(events):
+    """extend the 32 bits cycle stamps, the gap of two events is short"""
+    last = None
+    base = 0
+    for stamp, type, nest, arg, obj, data in events:
+        if last is not None and stamp < last:
+            base += 1 << 32
+        last = stamp
+        yield base + stamp, type, nest, arg, obj, data
+
+
+def convert(cycle_hz, events):
+    """return the list of chrome trace events"""
+    names = {}
+    tids = {}
+    out = []
+
+    # names are recorded 4 chars a time, the latest wins
+    for _, type, _, arg, obj, data in events:
+        if type == OS_TRACE_TASK_NAME:
+            name = names.setdefault(obj, {})
+            name[arg] = struct.pack('<I', data)
+
+    def task_name(task):
+        if task not in names:
+            return 'task@0x%08x' % task
+        raw = b''.join(names[task][k] for k in sorted(names[task]))
+        return raw.split(b'\0')[0].decode('ascii', 'replace')
+
+    def task_tid(task):
+        if task not in tids:
+            tids[task] = len(tids) + 2
+        return tids[task]
+
+    def ts(cycles):
+        # microseconds, or raw cycles if the frequency is unknown
+        return cycles * 1e6 / cycle_hz if cycle_hz else cycles
+
+    running = None
+    since = 0
+    stamp = 0
+    for stamp, type, nest, arg, obj, data in unwrap(events):
+        if type == OS_TRACE_SWITCH:
+            if running is not None:
+                out.append({'name': task_name(running), 'ph': 'X', 'pid': 0,
+                            'tid': TID_CPU, 'ts': ts(since),
+                            'dur': ts(stamp) - ts(since)})
+            running, since = obj, stamp
+            out.append({'name': 'run', 'ph': 'i', 's': 't', 'pid': 0,
+                        'tid': task_tid(obj), 'ts': ts(stamp),
+                        'args': {'priority': arg,
+                                 'from': task_name(data) if data else None}})
+        elif type == OS_TRACE_ISR_ENTER:
+            out.append({'name': 'isr', 'ph': 'B', 'pid': 0, 'tid': TID_ISR,
+                        'ts': ts(stamp), 'args': {'nest': arg}})
+        elif type == OS_TRACE_ISR_LEAVE:
+            out.append({'name': 'isr', 'ph': 'E', 'pid': 0, 'tid': TID_ISR,
+                        'ts': ts(stamp)})
+        elif type in (OS_TRACE_IPC_BLOCK, OS_TRACE_IPC_WAKE):
+            out.append({'name': 'block' if type == OS_TRACE_IPC_BLOCK else 'wake',
+                        'ph': 'i', 's': 't', 'pid': 0, 'tid': task_tid(obj),
+                        'ts': ts(stamp), 'args': {'waitq': '0x%08x' % data}})
+        elif type == OS_TRACE_TIMER:
+            out.append({'name': 'timer', 'ph': 'i', 's': 't', 'pid': 0,
+                        'tid': TID_ISR if nest else TID_CPU, 'ts': ts(stamp),
+                        'args': {'timer': '0x%08x' % obj,
+                                 'func': '0x%08x' % data}})
+        elif type in (OS_TRACE_MALLOC, OS_TRACE_FREE):
+            out.append({'name': 'malloc' if type == OS_TRACE_MALLOC else 'free',
+                        'ph': 'i', 's': 't', 'pid': 0,
+                        'tid': task_tid(running) if running else TID_CPU,
+                        'ts': ts(stamp),
+                        'args': {'addr': '0x%08x' % obj, 'size': data}})
+
+    if running is not None:
+        out.append({'name': task_name(running), 'ph': 'X', 'pid': 0,
+                    'tid': TID_CPU, 'ts': ts(since),
+                    'dur': ts(stamp) - ts(since)})
+
+    meta = [{'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': TID_CPU,
+             'args': {'name': 'cpu'}},
+            {'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': TID_ISR,
+             'args': {'name': 'interrupt'}}]
+    for task, tid in tids.items():
+        meta.append({'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': tid,
+                     'args': {'name': task_name(task)}})
+
+    return meta + out
+
+
+def main():
+    parser = argparse.ArgumentParser(description='convert a kernel trace dump '
+                                     'into Chrome trace event JSON')
+    parser.add_argument('dump', help='trace dump or memory image')
+    parser.add_argument('-o', '--output', help='output file, stdout if absent')
+    parser.add_argument('--hz', type=int, default=0,
+                        help='cycle counter frequency, overrides the dump')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        cycle_hz, events = load_events(f.read())
+
+    trace = {'traceEvents': convert(args.hz or cycle_hz, events),
+             'displayTimeUnit': 'ns'}
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f, indent=1)
+    else:
+        json.dump(trace, sys.stdout, indent=1)
+
+
+if __name__ == '__main__':
+    main()